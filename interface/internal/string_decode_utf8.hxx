@@ -78,6 +78,39 @@ char32_t decodeUtf8
     const char*&        p       // I/O - points to current non-null character
 );
 
+//=========================================================================
+// As above, for a length-delimited run of bytes ending at end; p must be
+// short of end. A null byte is the character U+0000, not a terminator.
+//
+// Returns 0 and sets p to nullptr if the UTF-8 character is invalid,
+//     including one that a null byte cuts short.
+// Returns 0 and sets p to end if the character is valid as far as it goes
+//     but end cuts it short.
+// Otherwise returns the character (possibly 0) and advances p to point to
+//     the last byte consumed, as above.
+
+char32_t decodeUtf8
+(
+    const char*&        p,      // I/O - points to current character
+    const char*         end     // I - one past the last byte available
+);
+
+//=========================================================================
+// The two decodeUtf8 functions above, driven by a byte-class and state
+// transition table instead of nested tests. Same arguments, same results
+// in every case; much less branching on text that mixes scripts.
+
+char32_t decodeUtf8Dfa
+(
+    const char*&        p       // I/O - points to current non-null character
+);
+
+char32_t decodeUtf8Dfa
+(
+    const char*&        p,      // I/O - points to current character
+    const char*         end     // I - one past the last byte available
+);
+
 }
 
 }
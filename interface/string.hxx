@@ -49,8 +49,22 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
+#include <vector>
+#include <stddef.h>
 #include <stdint.h>
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define ANSAK_HAS_STRING_VIEW 1
+#include <string_view>
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#define ANSAK_HAS_PMR 1
+#include <memory_resource>
+#endif
+#endif
+#endif
+
 namespace ansak {
 
 ///////////////////////////////////////////////////////////////////////////
@@ -212,6 +226,24 @@ enum SourceEncoding : int {
     kSrcCP1250
 };
 
+///////////////////////////////////////////////////////////////////////////
+// enum ConvertPolicy
+//
+// Enumeration values to communicate what a conversion does with input it
+// can't convert: stop (the string-returning forms then return an empty
+// string), put U+FFFD in its place, or leave it out. Ill-formed UTF-8 is
+// replaced (or skipped) one "maximal subpart" at a time, as the Unicode
+// Standard (chapter 3) and the WHATWG Encoding Standard have it; anything
+// else is replaced a unit or a character at a time.
+//
+///////////////////////////////////////////////////////////////////////////
+
+enum ConvertPolicy : int {
+    kConvertStrict,
+    kConvertReplace,
+    kConvertSkip
+};
+
 ///////////////////////////////////////////////////////////////////////////
 // Public Methods
 
@@ -241,6 +273,12 @@ utf8String getUnicodeVersionSupported();
 //
 // Added syntactic-sugar so that string + encoding check predicate is all
 // that is required, if the target stays the same.
+//
+// The (pointer, size_t length) forms scan exactly length units, need no
+// terminator and never read past the end; a null within the length is the
+// character U+0000, checked against the range and predicate like any other.
+// Their targetRange is not defaulted, which keeps them clear of the older
+// (pointer, unsigned int length) forms.
 
 bool isUtf8
 (
@@ -279,6 +317,15 @@ bool isUtf8
                     pred = EncodingCheckPredicate()
 );
 
+bool isUtf8
+(
+    const char*     test,                   // I - the length-delimited source
+    size_t          testLength,             // I - its length in bytes
+    RangeType       targetRange,            // I - target range
+    const EncodingCheckPredicate&           // I - optional validity check
+                    pred = EncodingCheckPredicate()
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 // isUtf16
 
@@ -294,6 +341,10 @@ inline bool isUtf16(const utf16String& test,
 inline bool isUtf16(const char16_t* test,
                     const EncodingCheckPredicate& pred) { return isUtf16(test, kUtf16, pred); }
 
+bool isUtf16(const char16_t* test, size_t testLength,
+             RangeType targetRange,
+             const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+
 ////////////////////////////////////////////////////////////////////////////////
 // isUcs2
 
@@ -309,6 +360,10 @@ inline bool isUcs2(const utf16String& test,
 inline bool isUcs2(const char16_t* test,
                    const EncodingCheckPredicate& pred) { return isUcs2(test, kUcs2, pred); }
 
+bool isUcs2(const char16_t* test, size_t testLength,
+            RangeType targetRange,
+            const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+
 ////////////////////////////////////////////////////////////////////////////////
 // isUcs4
 
@@ -324,6 +379,190 @@ inline bool isUcs4(const ucs4String& test,
 inline bool isUcs4(const char32_t* test,
                    const EncodingCheckPredicate& pred) { return isUcs4(test, kUcs4, pred); }
 
+bool isUcs4(const char32_t* test, size_t testLength,
+            RangeType targetRange,
+            const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+
+///////////////////////////////////////////////////////////////////////////
+// isUtf8Parallel, isUtf16Parallel
+//
+// The (pointer, size_t length) forms of isUtf8 and isUtf16 for very large
+// sources, spread over threadCount threads (0 for as many as the machine
+// runs at once). The source is cut into pieces of a few MiB, never inside
+// a character, a CESU-8 pair or a UTF-16 pair, and each thread checks the
+// next piece no other has taken until one fails or none are left.
+//
+// pred is called from several threads at once, on pieces in no particular
+// order, and may be called on characters past the first that fails. It is
+// safe to: an EncodingCheckPredicate is a fixed mask test against constant
+// tables, holding no state and writing nothing. So the answer is always the
+// one isUtf8 or isUtf16 gives for the same arguments. Sources too short to
+// cut into two pieces are checked on the calling thread alone.
+///////////////////////////////////////////////////////////////////////////
+
+bool isUtf8Parallel
+(
+    const char*     test,                   // I - the length-delimited source
+    size_t          testLength,             // I - its length in bytes
+    RangeType       targetRange = kUtf8,    // I - optional target range
+    const EncodingCheckPredicate&           // I - optional validity check
+                    pred = EncodingCheckPredicate(),
+    unsigned int    threadCount = 0         // I - optional threads to use
+);
+
+bool isUtf16Parallel(const char16_t* test, size_t testLength,
+                     RangeType targetRange = kUtf16,
+                     const EncodingCheckPredicate& pred = EncodingCheckPredicate(),
+                     unsigned int threadCount = 0);
+
+inline bool isUtf8Parallel(const utf8String& test,
+                           RangeType targetRange = kUtf8,
+                           const EncodingCheckPredicate& pred = EncodingCheckPredicate(),
+                           unsigned int threadCount = 0)
+{ return isUtf8Parallel(test.data(), test.size(), targetRange, pred, threadCount); }
+inline bool isUtf16Parallel(const utf16String& test,
+                            RangeType targetRange = kUtf16,
+                            const EncodingCheckPredicate& pred = EncodingCheckPredicate(),
+                            unsigned int threadCount = 0)
+{ return isUtf16Parallel(test.data(), test.size(), targetRange, pred, threadCount); }
+
+///////////////////////////////////////////////////////////////////////////
+// validate<RangeType> functions
+//
+// The (pointer, size_t length) is<RangeType> functions, saying where and
+// why they fail: a ValidationResult gives the offset (in units) of the
+// first character in error and what is wrong with it. Working out the kind
+// of error waits until one is found, so success costs what is<RangeType>
+// costs.
+//
+//   kValidationMalformed   -- a unit that can't start a character, or a
+//                             sequence that stops before its end
+//   kValidationOverlong    -- UTF-8 using more bytes than the character needs
+//   kValidationSurrogate   -- a lone or out-of-order UTF-16 half (in UTF-8
+//                             or UCS-4, an encoded half not part of a pair)
+//   kValidationTruncated   -- the source ends part-way through a character
+//   kValidationOutOfRange  -- a character outside targetRange
+//   kValidationPredicate   -- a character pred refused
+//
+// Unlike is<RangeType>, a character cut short by the end of the source is
+// an error. On success, offset is testLength.
+///////////////////////////////////////////////////////////////////////////
+
+enum ValidationError : int {
+    kValidationOk,
+    kValidationMalformed,
+    kValidationOverlong,
+    kValidationSurrogate,
+    kValidationTruncated,
+    kValidationOutOfRange,
+    kValidationPredicate
+};
+
+struct ValidationResult
+{
+    bool            valid;              // no error at all
+    size_t          offset;             // where the first error starts
+    ValidationError error;              // what it is
+};
+
+ValidationResult validateUtf8
+(
+    const char*     test,                   // I - the length-delimited source
+    size_t          testLength,             // I - its length in bytes
+    RangeType       targetRange = kUtf8,    // I - optional target range
+    const EncodingCheckPredicate&           // I - optional validity check
+                    pred = EncodingCheckPredicate()
+);
+ValidationResult validateUtf16(const char16_t* test, size_t testLength,
+                               RangeType targetRange = kUtf16,
+                               const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+ValidationResult validateUcs2(const char16_t* test, size_t testLength,
+                              RangeType targetRange = kUcs2,
+                              const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+ValidationResult validateUcs4(const char32_t* test, size_t testLength,
+                              RangeType targetRange = kUcs4,
+                              const EncodingCheckPredicate& pred = EncodingCheckPredicate());
+
+inline ValidationResult validateUtf8(const utf8String& test,
+                                     RangeType targetRange = kUtf8,
+                                     const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return validateUtf8(test.data(), test.size(), targetRange, pred); }
+inline ValidationResult validateUtf16(const utf16String& test,
+                                      RangeType targetRange = kUtf16,
+                                      const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return validateUtf16(test.data(), test.size(), targetRange, pred); }
+inline ValidationResult validateUcs2(const ucs2String& test,
+                                     RangeType targetRange = kUcs2,
+                                     const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return validateUcs2(test.data(), test.size(), targetRange, pred); }
+inline ValidationResult validateUcs4(const ucs4String& test,
+                                     RangeType targetRange = kUcs4,
+                                     const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return validateUcs4(test.data(), test.size(), targetRange, pred); }
+
+///////////////////////////////////////////////////////////////////////////
+// class Utf8Validator
+//
+// isUtf8 for UTF-8 arriving a chunk at a time, so that a payload never has
+// to be held whole. Call feed with each chunk in order, then finish. A
+// character or CESU-8 pair cut by the end of a chunk is carried over and
+// judged once the rest of it arrives; targetRange and pred are applied
+// exactly as the (pointer, size_t length) form of isUtf8 applies them.
+//
+// feed returns false once anything fed so far is invalid (and keeps doing
+// so until reset). Unlike isUtf8, finish counts a sequence still cut short
+// as a failure: there is no more input coming to complete it. result says
+// the same as validateUtf8 over everything fed so far would, its offset
+// counting from the start of the first chunk.
+///////////////////////////////////////////////////////////////////////////
+
+class Utf8Validator {
+
+public:
+
+    explicit Utf8Validator
+    (
+        RangeType       targetRange = kUtf8,    // I - optional target range
+        const EncodingCheckPredicate&           // I - optional validity check
+                        pred = EncodingCheckPredicate()
+    );
+
+    // Validate the next chunk, carrying any sequence it leaves incomplete
+    bool feed
+    (
+        const char*     chunk,                  // I - the next bytes
+        size_t          chunkLength             // I - how many of them
+    );
+
+    // Is everything fed so far valid, ending on a character boundary?
+    bool finish() const;
+
+    // ... and if not, where and why not
+    ValidationResult result() const;
+
+    // Start over with a new stream, same range and predicate
+    void reset();
+
+private:
+
+    static const size_t kLongestCarry = 6;
+
+    bool fail(size_t offset, ValidationError error);
+    bool carry(const char* lead, const char* end);
+    ValidationError check(char32_t c) const;
+
+    RangeType               m_targetRange;  // what every character must fit
+    EncodingCheckPredicate  m_pred;         // what every character must pass
+    bool                    m_isNullPred;   // ... unless it checks nothing
+    ValidationError         m_error;        // the first thing wrong, if any
+    size_t                  m_errorOffset;  // ... and where it starts
+    size_t                  m_fed;          // bytes fed before this chunk
+    uint8_t                 m_state;        // decoder state of a carried sequence
+    uint32_t                m_bits;         // and the bits of it decoded so far
+    char                    m_carry[kLongestCarry];   // its bytes, for error reports
+    size_t                  m_carryLength;  // ... how many of them
+};
+
 ///////////////////////////////////////////////////////////////////////////
 // to<RangeType> functions
 //
@@ -340,52 +579,236 @@ inline bool isUcs4(const char32_t* test,
 // emerges. Otherwise, they return the re-encoded string in the appropriate
 // basic_string<C> type. Incomplete but potentially valid encoding sequences
 // at end-of-string are ignored. 
+//
+// With kConvertReplace or kConvertSkip as policy they never fail: what can't
+// be converted (an incomplete sequence at end-of-string included) becomes
+// U+FFFD, or nothing.
+//
+// The (pointer, size_t length) forms convert exactly length units without
+// needing a terminator; a null within the length converts to U+0000.
 
 ////////////////////////////////////////////////////////////////////////////////
 // toUtf8
 
 utf8String toUtf8
 (
-    const utf16String&      src         // I - A source basic_string
+    const utf16String&      src,        // I - A source basic_string
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
 );
 
 utf8String toUtf8
 (
-    const char16_t*         src         // I - A null-term'd source
+    const char16_t*         src,        // I - A null-term'd source
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
 );
 
-utf8String toUtf8(const ucs4String& src);
-utf8String toUtf8(const char32_t* src);
+utf8String toUtf8
+(
+    const char16_t*         src,        // I - A length-delimited source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+);
+
+utf8String toUtf8(const ucs4String& src, ConvertPolicy policy = kConvertStrict);
+utf8String toUtf8(const char32_t* src, ConvertPolicy policy = kConvertStrict);
+utf8String toUtf8(const char32_t* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
 
 ////////////////////////////////////////////////////////////////////////////////
 // toUcs2
 
-ucs2String toUcs2(const utf8String& src);
-ucs2String toUcs2(const char* src);
-ucs2String toUcs2(const ucs4String& src);
-ucs2String toUcs2(const char32_t* src);
+ucs2String toUcs2(const utf8String& src, ConvertPolicy policy = kConvertStrict);
+ucs2String toUcs2(const char* src, ConvertPolicy policy = kConvertStrict);
+ucs2String toUcs2(const ucs4String& src, ConvertPolicy policy = kConvertStrict);
+ucs2String toUcs2(const char32_t* src, ConvertPolicy policy = kConvertStrict);
+ucs2String toUcs2(const char* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
+ucs2String toUcs2(const char32_t* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
 
 ////////////////////////////////////////////////////////////////////////////////
 // toUtf16
 
-utf16String toUtf16(const utf8String& src);
-utf16String toUtf16(const char* src);
-utf16String toUtf16(const ucs4String& src);
-utf16String toUtf16(const char32_t* src);
+utf16String toUtf16(const utf8String& src, ConvertPolicy policy = kConvertStrict);
+utf16String toUtf16(const char* src, ConvertPolicy policy = kConvertStrict);
+utf16String toUtf16(const ucs4String& src, ConvertPolicy policy = kConvertStrict);
+utf16String toUtf16(const char32_t* src, ConvertPolicy policy = kConvertStrict);
+utf16String toUtf16(const char* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
+utf16String toUtf16(const char32_t* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
 
 ////////////////////////////////////////////////////////////////////////////////
 // toUcs4
 
-ucs4String toUcs4(const utf8String& src);
-ucs4String toUcs4(const char* src);
-ucs4String toUcs4(const utf16String& src);
-ucs4String toUcs4(const char16_t* src);
+ucs4String toUcs4(const utf8String& src, ConvertPolicy policy = kConvertStrict);
+ucs4String toUcs4(const char* src, ConvertPolicy policy = kConvertStrict);
+ucs4String toUcs4(const utf16String& src, ConvertPolicy policy = kConvertStrict);
+ucs4String toUcs4(const char16_t* src, ConvertPolicy policy = kConvertStrict);
+ucs4String toUcs4(const char* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
+ucs4String toUcs4(const char16_t* src, size_t srcLength, ConvertPolicy policy = kConvertStrict);
+
+///////////////////////////////////////////////////////////////////////////
+// to<RangeType> functions into a caller's buffer
+//
+// Each of these re-encodes srcLength units of src into dst, never writing
+// more than dstCapacity units, and never allocating. Characters are written
+// whole or not at all. Nulls within srcLength are U+0000.
+//
+// They return how many source units were consumed, how many destination
+// units were produced and why they stopped:
+//
+//   kConvertOk          -- all of src was converted
+//   kConvertIncomplete  -- src ends part-way through a character; the rest
+//                          was converted (the string-returning forms above
+//                          ignore such a tail)
+//   kConvertTargetFull  -- the next character did not fit in what was left
+//                          of dst
+//   kConvertInvalid     -- the character at src + consumed is wrongly
+//                          encoded (including lone UTF-16 halves)
+//   kConvertOutOfRange  -- the character at src + consumed cannot be
+//                          represented in the target encoding
+//
+// Given kConvertReplace or kConvertSkip as policy they go on past what they
+// would stop at for those last two, and never return them. They still stop
+// with kConvertIncomplete, as more of src may yet come.
+//
+// As characters are written whole, dst must have room for the longest one:
+// 6 bytes of UTF-8 (4 from UTF-16, whose characters never take 5 or 6), 2
+// UTF-16 units, or 1 UCS-2 or UCS-4 unit. With less, kConvertTargetFull
+// having produced nothing may never clear, however often it is called.
+//
+// requiredLength gives the number of units the matching conversion of all
+// of src produces (kUtf8, kUtf16, kUcs2 or kUcs4 as target), so that dst
+// can be sized exactly. It returns 0 if the conversion would stop with
+// kConvertInvalid or kConvertOutOfRange, or if no such conversion exists.
+///////////////////////////////////////////////////////////////////////////
+
+enum ConvertStatus : int {
+    kConvertOk,
+    kConvertIncomplete,
+    kConvertTargetFull,
+    kConvertInvalid,
+    kConvertOutOfRange
+};
+
+struct ConvertResult
+{
+    size_t          consumed;           // source units read
+    size_t          produced;           // destination units written
+    ConvertStatus   status;             // why it stopped
+};
+
+ConvertResult toUtf8
+(
+    const char16_t*         src,        // I - UCS-2 or UTF-16 source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    char*                   dst,        // O - destination buffer
+    size_t                  dstCapacity // I - its size in bytes
+);
+ConvertResult toUtf8(const char32_t* src, size_t srcLength, char* dst, size_t dstCapacity);
+
+ConvertResult toUcs2(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity);
+ConvertResult toUcs2(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity);
+
+ConvertResult toUtf16(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity);
+ConvertResult toUtf16(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity);
+
+ConvertResult toUcs4(const char* src, size_t srcLength, char32_t* dst, size_t dstCapacity);
+ConvertResult toUcs4(const char16_t* src, size_t srcLength, char32_t* dst, size_t dstCapacity);
+
+ConvertResult toUtf8
+(
+    const char16_t*         src,        // I - UCS-2 or UTF-16 source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    char*                   dst,        // O - destination buffer
+    size_t                  dstCapacity,// I - its size in bytes
+    ConvertPolicy           policy      // I - what to do with bad input
+);
+ConvertResult toUtf8(const char32_t* src, size_t srcLength, char* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUcs2(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUcs2(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUtf16(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUtf16(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUcs4(const char* src, size_t srcLength, char32_t* dst, size_t dstCapacity, ConvertPolicy policy);
+ConvertResult toUcs4(const char16_t* src, size_t srcLength, char32_t* dst, size_t dstCapacity, ConvertPolicy policy);
+
+size_t requiredLength
+(
+    const char*             src,        // I - UTF-8 source
+    size_t                  srcLength,  // I - its length in bytes
+    RangeType               target,     // I - kUtf16, kUcs2 or kUcs4
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+);
+size_t requiredLength(const char16_t* src, size_t srcLength, RangeType target,
+                      ConvertPolicy policy = kConvertStrict);
+size_t requiredLength(const char32_t* src, size_t srcLength, RangeType target,
+                      ConvertPolicy policy = kConvertStrict);
+
+///////////////////////////////////////////////////////////////////////////
+// class StreamConverter<S, D>
+//
+// The into-a-buffer converters above for a source that arrives a chunk at
+// a time, so that a file or socket of any size converts in constant
+// memory. Construct one with the target encoding (kUtf8 for char, kUtf16
+// or kUcs2 for char16_t, kUcs4 for char32_t output; anything else fails
+// every call with kConvertOutOfRange), then call convert with each chunk in
+// turn. It converts as much as fits into dst, and returns a ConvertResult
+// just like the buffer converters' (given the same policy).
+//
+// Where a chunk ends part-way through a character (or a UTF-16 or CESU-8
+// pair) those units are consumed and held back, and convert reports
+// kConvertOk; the character is converted with the start of the next chunk.
+// On kConvertTargetFull, empty dst and call again with the rest of the
+// chunk; as for the buffer converters, dst must have room for the longest
+// character, or it may never make progress. finish reports
+// kConvertIncomplete if a character is still held back when the source has
+// run out, kConvertOk otherwise.
+//
+// Defined for each source and destination type the buffer converters have.
+///////////////////////////////////////////////////////////////////////////
+
+template<typename S, typename D>
+class StreamConverter {
+
+public:
+
+    explicit StreamConverter
+    (
+        RangeType               target,     // I - target encoding
+        ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+    );
+
+    // Convert the next chunk, or as much of it as fits
+    ConvertResult convert
+    (
+        const S*                src,        // I - the next chunk
+        size_t                  srcLength,  // I - its length in units
+        D*                      dst,        // O - destination buffer
+        size_t                  dstCapacity // I - its size in units
+    );
+
+    // Has all of the source been converted?
+    ConvertStatus finish() const;
+
+    // Start over with a new source, same target
+    void reset();
+
+private:
+
+    static const size_t kLongestCarry = 6;
+
+    ConvertResult         (*m_convert)(const S*, size_t, D*, size_t, ConvertPolicy);  // the buffer converter
+    ConvertPolicy           m_policy;                   // ... and what it does with bad input
+    S                       m_carry[kLongestCarry];     // a character cut short
+    size_t                  m_carryLength;              // ... and its length so far
+};
 
 ///////////////////////////////////////////////////////////////////////////
 // unicodeLength
 //
 // Finds the number of Unicode code points in a UTF-8 or UTF-16 string.
 // Returns 0 when it encounters invalid encoding sequences
+//
+// The (pointer, size_t length) forms count exactly length units, a null
+// being U+0000, and return a size_t. They also return 0 if any code point is
+// outside targetRange (kUnicode matches the UTF-8 checks of the older forms)
+// or if the last character is cut short by the end of the length.
 
 ////////////////////////////////////////////////////////////////////////////////
 // for utf8
@@ -399,18 +822,39 @@ unsigned int unicodeLength
     const char*         src,            // I - A null- or length-term'd source
     unsigned int        textLength = 0  // I - length of source, 0 if null-term'd
 );
+size_t unicodeLength
+(
+    const char*         src,            // I - A length-delimited source
+    size_t              srcLength,      // I - its length in bytes
+    RangeType           targetRange     // I - range every code point must fit
+);
 
 ////////////////////////////////////////////////////////////////////////////////
 // for utf16
 
 unsigned int unicodeLength(const utf16String& src);
 unsigned int unicodeLength(const char16_t* src, unsigned int testLength = 0);
+size_t unicodeLength(const char16_t* src, size_t srcLength, RangeType targetRange);
 
 ////////////////////////////////////////////////////////////////////////////////
 // for ucs4
 
 unsigned int unicodeLength(const ucs4String& src);
 unsigned int unicodeLength(const char32_t* src, unsigned int testLength = 0);
+size_t unicodeLength(const char32_t* src, size_t srcLength, RangeType targetRange);
+
+///////////////////////////////////////////////////////////////////////////
+// unicodeLengthUnchecked
+//
+// Counts the code points in text the caller has already validated (with
+// isUtf8, validateUtf16 and the like) without checking it again: one for
+// each UTF-8 byte that isn't a continuation (a CESU-8 pair counting once),
+// one for each UTF-16 unit that isn't a second half. Text that isn't valid
+// gets some count, not 0.
+
+size_t unicodeLengthUnchecked(const char* src, size_t srcLength);
+size_t unicodeLengthUnchecked(const char16_t* src, size_t srcLength);
+size_t unicodeLengthUnchecked(const char32_t* src, size_t srcLength);
 
 ///////////////////////////////////////////////////////////////////////////
 // toLower function
@@ -427,6 +871,9 @@ unsigned int unicodeLength(const char32_t* src, unsigned int testLength = 0);
 // Turkish behaviour is selected by passing in a pointer to "az", "aze",
 // "azj", "azb", "kk", "kaz", "tt", "tat", "tr" or "tur". Any other value
 // selects non-Turkish behaviour.
+//
+// The (pointer, size_t length) forms lower-case exactly length units; nulls
+// within the length are carried through.
 ///////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -438,6 +885,19 @@ utf8String toLower
     const char*             lang = nullptr  // I - the optional language code
 );
 
+utf8String toLower
+(
+    const char*             src,            // I - the null-terminated source
+    const char*             lang = nullptr  // I - the optional language code
+);
+
+utf8String toLower
+(
+    const char*             src,            // I - the length-delimited source
+    size_t                  srcLength,      // I - its length in bytes
+    const char*             lang = nullptr  // I - the optional language code
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 // for utf16
 
@@ -447,6 +907,19 @@ utf16String toLower
     const char*             lang = nullptr  // I - the optional language code
 );
 
+utf16String toLower
+(
+    const char16_t*         src,            // I - the null-terminated source
+    const char*             lang = nullptr  // I - the optional language code
+);
+
+utf16String toLower
+(
+    const char16_t*         src,            // I - the length-delimited source
+    size_t                  srcLength,      // I - its length in 16-bit units
+    const char*             lang = nullptr  // I - the optional language code
+);
+
 ////////////////////////////////////////////////////////////////////////////////
 // for ucs4
 
@@ -456,6 +929,574 @@ ucs4String toLower
     const char*             lang = nullptr  // I - the optional language code
 );
 
+ucs4String toLower
+(
+    const char32_t*         src,            // I - the null-terminated source
+    const char*             lang = nullptr  // I - the optional language code
+);
+
+ucs4String toLower
+(
+    const char32_t*         src,            // I - the length-delimited source
+    size_t                  srcLength,      // I - its length in characters
+    const char*             lang = nullptr  // I - the optional language code
+);
+
+///////////////////////////////////////////////////////////////////////////
+// to<RangeType>Batch and toLowerBatch functions
+//
+// The (pointer, size_t length) to<RangeType> and toLower functions over
+// many sources at once, for when there are a great many short ones. Every
+// result goes into one arena, result i being the units from offsets[i] to
+// offsets[i + 1]; whatever arena and offsets held before is replaced.
+//
+// Sources are packed together a few thousand units at a time and each
+// pack is converted (or lower-cased) in one pass, so the vector kernels
+// see long runs instead of many short ones, and nothing is allocated per
+// source. A pack holding anything that can't be converted, or a source
+// that doesn't start on a character, is done again a source at a time.
+// Either way, each result is what the single-source function would give.
+//
+// They return how many sources came out empty when they weren't: those
+// that can't be converted under a strict policy, and those holding only a
+// character cut short.
+///////////////////////////////////////////////////////////////////////////
+
+template<typename C>
+struct StringSpan
+{
+    const C*        data;               // the source
+    size_t          length;             // its length in units
+};
+
+size_t toUtf8Batch
+(
+    const StringSpan<char16_t>* srcs,   // I - UCS-2 or UTF-16 sources
+    size_t                  count,      // I - how many there are
+    utf8String&             arena,      // O - all of the results, in order
+    std::vector<size_t>&    offsets,    // O - where each starts, count + 1 of them
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+);
+size_t toUtf8Batch(const StringSpan<char32_t>* srcs, size_t count, utf8String& arena,
+                   std::vector<size_t>& offsets, ConvertPolicy policy = kConvertStrict);
+size_t toUtf16Batch(const StringSpan<char>* srcs, size_t count, utf16String& arena,
+                    std::vector<size_t>& offsets, ConvertPolicy policy = kConvertStrict);
+size_t toUtf16Batch(const StringSpan<char32_t>* srcs, size_t count, utf16String& arena,
+                    std::vector<size_t>& offsets, ConvertPolicy policy = kConvertStrict);
+size_t toUcs4Batch(const StringSpan<char>* srcs, size_t count, ucs4String& arena,
+                   std::vector<size_t>& offsets, ConvertPolicy policy = kConvertStrict);
+size_t toUcs4Batch(const StringSpan<char16_t>* srcs, size_t count, ucs4String& arena,
+                   std::vector<size_t>& offsets, ConvertPolicy policy = kConvertStrict);
+
+size_t toLowerBatch
+(
+    const StringSpan<char>* srcs,       // I - UTF-8 sources
+    size_t                  count,      // I - how many there are
+    utf8String&             arena,      // O - all of the results, in order
+    std::vector<size_t>&    offsets,    // O - where each starts, count + 1 of them
+    const char*             lang = nullptr  // I - the optional language code
+);
+size_t toLowerBatch(const StringSpan<char16_t>* srcs, size_t count, utf16String& arena,
+                    std::vector<size_t>& offsets, const char* lang = nullptr);
+size_t toLowerBatch(const StringSpan<char32_t>* srcs, size_t count, ucs4String& arena,
+                    std::vector<size_t>& offsets, const char* lang = nullptr);
+
+///////////////////////////////////////////////////////////////////////////
+// to<RangeType> and toLower functions into a string of any allocator
+//
+// The (pointer, size_t length) to<RangeType> and toLower functions, giving
+// a basic_string whose allocator is alloc (a custom one, a pool, an arena)
+// instead of the default one. A is the allocator type, its value_type the
+// result's unit type; the result is allocated through alloc alone, and
+// sized once, as the other forms are. A source in a basic_string with some
+// other allocator goes in as src.data(), src.size().
+//
+// Each returns what the form without alloc returns, in a string of its own
+// type: empty if src can't be converted.
+///////////////////////////////////////////////////////////////////////////
+
+namespace internal {
+
+//=========================================================================
+// Where the library writes an allocator-templated result: a basic_string
+// of some allocator the library was never built with, behind size and
+// resize (which keeps what the string held and returns where it starts).
+// The functions taking one add their result to the end of what's there
+// and return true, or return false with it left as it was.
+
+template<typename C>
+class ResultSink
+{
+public:
+    virtual ~ResultSink() {}
+    virtual size_t size() const = 0;
+    virtual C* resize(size_t length) = 0;
+};
+
+template<typename C, typename A>
+class StringSink : public ResultSink<C>
+{
+public:
+    explicit StringSink(std::basic_string<C, std::char_traits<C>, A>& s) : m_s(s) {}
+
+    size_t size() const override { return m_s.size(); }
+    C* resize(size_t length) override { m_s.resize(length); return &m_s[0]; }
+
+private:
+    std::basic_string<C, std::char_traits<C>, A>&   m_s;
+};
+
+// the result of an allocator-templated form: a basic_string of C whose
+// allocator is A, when A allocates C (which keeps those forms out of the
+// way of the ones taking a ConvertPolicy or a language code)
+template<typename C, typename A>
+using AllocString = typename std::enable_if<std::is_same<typename A::value_type, C>::value,
+                                            std::basic_string<C, std::char_traits<C>, A> >::type;
+
+bool toUtf8Onto(const char16_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char>& result);
+bool toUtf8Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char>& result);
+bool toUcs2Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result);
+bool toUcs2Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result);
+bool toUtf16Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result);
+bool toUtf16Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result);
+bool toUcs4Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char32_t>& result);
+bool toUcs4Onto(const char16_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char32_t>& result);
+
+bool lowerOnto(const char* src, size_t srcLength, const char* lang, ResultSink<char>& result);
+bool lowerOnto(const char16_t* src, size_t srcLength, const char* lang, ResultSink<char16_t>& result);
+bool lowerOnto(const char32_t* src, size_t srcLength, const char* lang, ResultSink<char32_t>& result);
+
+}
+
+template<typename A>
+internal::AllocString<char, A> toUtf8
+(
+    const char16_t*         src,        // I - A length-delimited source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    const A&                alloc,      // I - the result's allocator
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+)
+{
+    std::basic_string<char, std::char_traits<char>, A> result(alloc);
+    internal::StringSink<char, A> sink(result);
+    internal::toUtf8Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char, A> toUtf8(const char32_t* src, size_t srcLength, const A& alloc,
+                                      ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char, std::char_traits<char>, A> result(alloc);
+    internal::StringSink<char, A> sink(result);
+    internal::toUtf8Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char16_t, A> toUcs2(const char* src, size_t srcLength, const A& alloc,
+                                          ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char16_t, std::char_traits<char16_t>, A> result(alloc);
+    internal::StringSink<char16_t, A> sink(result);
+    internal::toUcs2Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char16_t, A> toUcs2(const char32_t* src, size_t srcLength, const A& alloc,
+                                          ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char16_t, std::char_traits<char16_t>, A> result(alloc);
+    internal::StringSink<char16_t, A> sink(result);
+    internal::toUcs2Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char16_t, A> toUtf16(const char* src, size_t srcLength, const A& alloc,
+                                           ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char16_t, std::char_traits<char16_t>, A> result(alloc);
+    internal::StringSink<char16_t, A> sink(result);
+    internal::toUtf16Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char16_t, A> toUtf16(const char32_t* src, size_t srcLength, const A& alloc,
+                                           ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char16_t, std::char_traits<char16_t>, A> result(alloc);
+    internal::StringSink<char16_t, A> sink(result);
+    internal::toUtf16Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char32_t, A> toUcs4(const char* src, size_t srcLength, const A& alloc,
+                                          ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char32_t, std::char_traits<char32_t>, A> result(alloc);
+    internal::StringSink<char32_t, A> sink(result);
+    internal::toUcs4Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char32_t, A> toUcs4(const char16_t* src, size_t srcLength, const A& alloc,
+                                          ConvertPolicy policy = kConvertStrict)
+{
+    std::basic_string<char32_t, std::char_traits<char32_t>, A> result(alloc);
+    internal::StringSink<char32_t, A> sink(result);
+    internal::toUcs4Onto(src, srcLength, policy, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char, A> toLower
+(
+    const char*             src,            // I - the length-delimited source
+    size_t                  srcLength,      // I - its length in bytes
+    const A&                alloc,          // I - the result's allocator
+    const char*             lang = nullptr  // I - the optional language code
+)
+{
+    std::basic_string<char, std::char_traits<char>, A> result(alloc);
+    internal::StringSink<char, A> sink(result);
+    internal::lowerOnto(src, srcLength, lang, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char16_t, A> toLower(const char16_t* src, size_t srcLength, const A& alloc,
+                                           const char* lang = nullptr)
+{
+    std::basic_string<char16_t, std::char_traits<char16_t>, A> result(alloc);
+    internal::StringSink<char16_t, A> sink(result);
+    internal::lowerOnto(src, srcLength, lang, sink);
+    return result;
+}
+
+template<typename A>
+internal::AllocString<char32_t, A> toLower(const char32_t* src, size_t srcLength, const A& alloc,
+                                           const char* lang = nullptr)
+{
+    std::basic_string<char32_t, std::char_traits<char32_t>, A> result(alloc);
+    internal::StringSink<char32_t, A> sink(result);
+    internal::lowerOnto(src, srcLength, lang, sink);
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// append<RangeType> and appendLower functions
+//
+// The to<RangeType> and toLower functions, adding their result onto the
+// end of dst (a basic_string of any allocator) instead of giving a new
+// string: dst grows once, by the exact length of what is added, and the
+// result goes straight into it, with no string in between. Assembling a
+// document from many converted pieces costs no more than the pieces.
+//
+// They return true, or false with dst as it was if src can't be converted
+// (only possible with kConvertStrict, the default, or in appendLower).
+// Sources are taken as by the matching to<RangeType> forms: null-
+// terminated pointers and basic_strings up to the first null, (pointer,
+// size_t length) forms exactly length units, nulls within being U+0000.
+///////////////////////////////////////////////////////////////////////////
+
+template<typename A>
+bool appendUtf8
+(
+    std::basic_string<char, std::char_traits<char>, A>&
+                            dst,        // I/O - what to add the result to
+    const char16_t*         src,        // I - A length-delimited source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    ConvertPolicy           policy = kConvertStrict // I - optional, for bad input
+)
+{
+    internal::StringSink<char, A> sink(dst);
+    return internal::toUtf8Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUtf8(std::basic_string<char, std::char_traits<char>, A>& dst, const char32_t* src,
+                size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char, A> sink(dst);
+    return internal::toUtf8Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const char* src,
+                size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char16_t, A> sink(dst);
+    return internal::toUcs2Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const char32_t* src,
+                size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char16_t, A> sink(dst);
+    return internal::toUcs2Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const char* src,
+                 size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char16_t, A> sink(dst);
+    return internal::toUtf16Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const char32_t* src,
+                 size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char16_t, A> sink(dst);
+    return internal::toUtf16Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, const char* src,
+                size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char32_t, A> sink(dst);
+    return internal::toUcs4Onto(src, srcLength, policy, sink);
+}
+
+template<typename A>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, const char16_t* src,
+                size_t srcLength, ConvertPolicy policy = kConvertStrict)
+{
+    internal::StringSink<char32_t, A> sink(dst);
+    return internal::toUcs4Onto(src, srcLength, policy, sink);
+}
+
+template<typename C, typename A>
+bool appendLower
+(
+    std::basic_string<C, std::char_traits<C>, A>&
+                            dst,            // I/O - what to add the result to
+    const C*                src,            // I - the length-delimited source
+    size_t                  srcLength,      // I - its length in units
+    const char*             lang = nullptr  // I - the optional language code
+)
+{
+    internal::StringSink<C, A> sink(dst);
+    return internal::lowerOnto(src, srcLength, lang, sink);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// from null-terminated pointers and basic_strings
+
+template<typename A, typename S>
+bool appendUtf8(std::basic_string<char, std::char_traits<char>, A>& dst, const S* src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUtf8(dst, src, src ? std::char_traits<S>::length(src) : 0, policy); }
+template<typename A, typename S, typename SA>
+bool appendUtf8(std::basic_string<char, std::char_traits<char>, A>& dst,
+               const std::basic_string<S, std::char_traits<S>, SA>& src, ConvertPolicy policy = kConvertStrict)
+{ return appendUtf8(dst, src.c_str(), policy); }
+
+template<typename A, typename S>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const S* src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs2(dst, src, src ? std::char_traits<S>::length(src) : 0, policy); }
+template<typename A, typename S, typename SA>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst,
+               const std::basic_string<S, std::char_traits<S>, SA>& src, ConvertPolicy policy = kConvertStrict)
+{ return appendUcs2(dst, src.c_str(), policy); }
+
+template<typename A, typename S>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, const S* src,
+                ConvertPolicy policy = kConvertStrict)
+{ return appendUtf16(dst, src, src ? std::char_traits<S>::length(src) : 0, policy); }
+template<typename A, typename S, typename SA>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst,
+                const std::basic_string<S, std::char_traits<S>, SA>& src, ConvertPolicy policy = kConvertStrict)
+{ return appendUtf16(dst, src.c_str(), policy); }
+
+template<typename A, typename S>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, const S* src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs4(dst, src, src ? std::char_traits<S>::length(src) : 0, policy); }
+template<typename A, typename S, typename SA>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst,
+               const std::basic_string<S, std::char_traits<S>, SA>& src, ConvertPolicy policy = kConvertStrict)
+{ return appendUcs4(dst, src.c_str(), policy); }
+
+template<typename C, typename A>
+bool appendLower(std::basic_string<C, std::char_traits<C>, A>& dst, const C* src,
+                 const char* lang = nullptr)
+{ return appendLower(dst, src, src ? std::char_traits<C>::length(src) : 0, lang); }
+template<typename C, typename A, typename SA>
+bool appendLower(std::basic_string<C, std::char_traits<C>, A>& dst,
+                 const std::basic_string<C, std::char_traits<C>, SA>& src, const char* lang = nullptr)
+{ return appendLower(dst, src.c_str(), lang); }
+
+#if defined(ANSAK_HAS_STRING_VIEW)
+
+////////////////////////////////////////////////////////////////////////////////
+// std::basic_string_view forms (C++17 and later) of all of the above. They are
+// the (pointer, size_t length) forms by another name: no copy, no terminator
+// needed, nulls within the view are characters.
+
+inline bool isUtf8(std::string_view test, RangeType targetRange = kUtf8,
+                   const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return isUtf8(test.data(), test.size(), targetRange, pred); }
+inline bool isUtf8(std::string_view test, const EncodingCheckPredicate& pred)
+{ return isUtf8(test.data(), test.size(), kUtf8, pred); }
+
+inline bool isUtf16(std::u16string_view test, RangeType targetRange = kUtf16,
+                    const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return isUtf16(test.data(), test.size(), targetRange, pred); }
+inline bool isUtf16(std::u16string_view test, const EncodingCheckPredicate& pred)
+{ return isUtf16(test.data(), test.size(), kUtf16, pred); }
+
+inline bool isUcs2(std::u16string_view test, RangeType targetRange = kUcs2,
+                   const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return isUcs2(test.data(), test.size(), targetRange, pred); }
+inline bool isUcs2(std::u16string_view test, const EncodingCheckPredicate& pred)
+{ return isUcs2(test.data(), test.size(), kUcs2, pred); }
+
+inline bool isUcs4(std::u32string_view test, RangeType targetRange = kUcs4,
+                   const EncodingCheckPredicate& pred = EncodingCheckPredicate())
+{ return isUcs4(test.data(), test.size(), targetRange, pred); }
+inline bool isUcs4(std::u32string_view test, const EncodingCheckPredicate& pred)
+{ return isUcs4(test.data(), test.size(), kUcs4, pred); }
+
+inline utf8String toUtf8(std::u16string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUtf8(src.data(), src.size(), policy); }
+inline utf8String toUtf8(std::u32string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUtf8(src.data(), src.size(), policy); }
+inline ucs2String toUcs2(std::string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUcs2(src.data(), src.size(), policy); }
+inline ucs2String toUcs2(std::u32string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUcs2(src.data(), src.size(), policy); }
+inline utf16String toUtf16(std::string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUtf16(src.data(), src.size(), policy); }
+inline utf16String toUtf16(std::u32string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUtf16(src.data(), src.size(), policy); }
+inline ucs4String toUcs4(std::string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUcs4(src.data(), src.size(), policy); }
+inline ucs4String toUcs4(std::u16string_view src, ConvertPolicy policy = kConvertStrict)
+{ return toUcs4(src.data(), src.size(), policy); }
+
+inline size_t unicodeLength(std::string_view src, RangeType targetRange = kUnicode)
+{ return unicodeLength(src.data(), src.size(), targetRange); }
+inline size_t unicodeLength(std::u16string_view src, RangeType targetRange = kUnicode)
+{ return unicodeLength(src.data(), src.size(), targetRange); }
+inline size_t unicodeLength(std::u32string_view src, RangeType targetRange = kUcs4)
+{ return unicodeLength(src.data(), src.size(), targetRange); }
+inline size_t unicodeLengthUnchecked(std::string_view src)
+{ return unicodeLengthUnchecked(src.data(), src.size()); }
+inline size_t unicodeLengthUnchecked(std::u16string_view src)
+{ return unicodeLengthUnchecked(src.data(), src.size()); }
+inline size_t unicodeLengthUnchecked(std::u32string_view src)
+{ return unicodeLengthUnchecked(src.data(), src.size()); }
+
+inline utf8String toLower(std::string_view src, const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), lang); }
+inline utf16String toLower(std::u16string_view src, const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), lang); }
+inline ucs4String toLower(std::u32string_view src, const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), lang); }
+
+template<typename A>
+bool appendUtf8(std::basic_string<char, std::char_traits<char>, A>& dst, std::u16string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUtf8(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUtf8(std::basic_string<char, std::char_traits<char>, A>& dst, std::u32string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUtf8(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, std::string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs2(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUcs2(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, std::u32string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs2(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, std::string_view src,
+                ConvertPolicy policy = kConvertStrict)
+{ return appendUtf16(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUtf16(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, std::u32string_view src,
+                ConvertPolicy policy = kConvertStrict)
+{ return appendUtf16(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, std::string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs4(dst, src.data(), src.size(), policy); }
+template<typename A>
+bool appendUcs4(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, std::u16string_view src,
+               ConvertPolicy policy = kConvertStrict)
+{ return appendUcs4(dst, src.data(), src.size(), policy); }
+
+template<typename A>
+bool appendLower(std::basic_string<char, std::char_traits<char>, A>& dst, std::string_view src,
+                 const char* lang = nullptr)
+{ return appendLower(dst, src.data(), src.size(), lang); }
+template<typename A>
+bool appendLower(std::basic_string<char16_t, std::char_traits<char16_t>, A>& dst, std::u16string_view src,
+                 const char* lang = nullptr)
+{ return appendLower(dst, src.data(), src.size(), lang); }
+template<typename A>
+bool appendLower(std::basic_string<char32_t, std::char_traits<char32_t>, A>& dst, std::u32string_view src,
+                 const char* lang = nullptr)
+{ return appendLower(dst, src.data(), src.size(), lang); }
+
+#endif
+
+#if defined(ANSAK_HAS_PMR)
+
+////////////////////////////////////////////////////////////////////////////////
+// std::pmr forms (C++17 and later) of the converters and toLower: the views'
+// forms, giving std::pmr strings allocated from alloc. Pass the memory
+// resource itself (a monotonic_buffer_resource for one request, say) and it
+// becomes the allocator; everything converted from it goes when it does.
+
+inline std::pmr::string toUtf8(std::u16string_view src, std::pmr::polymorphic_allocator<char> alloc,
+                               ConvertPolicy policy = kConvertStrict)
+{ return toUtf8(src.data(), src.size(), alloc, policy); }
+inline std::pmr::string toUtf8(std::u32string_view src, std::pmr::polymorphic_allocator<char> alloc,
+                               ConvertPolicy policy = kConvertStrict)
+{ return toUtf8(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u16string toUcs2(std::string_view src, std::pmr::polymorphic_allocator<char16_t> alloc,
+                                  ConvertPolicy policy = kConvertStrict)
+{ return toUcs2(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u16string toUcs2(std::u32string_view src, std::pmr::polymorphic_allocator<char16_t> alloc,
+                                  ConvertPolicy policy = kConvertStrict)
+{ return toUcs2(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u16string toUtf16(std::string_view src, std::pmr::polymorphic_allocator<char16_t> alloc,
+                                   ConvertPolicy policy = kConvertStrict)
+{ return toUtf16(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u16string toUtf16(std::u32string_view src, std::pmr::polymorphic_allocator<char16_t> alloc,
+                                   ConvertPolicy policy = kConvertStrict)
+{ return toUtf16(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u32string toUcs4(std::string_view src, std::pmr::polymorphic_allocator<char32_t> alloc,
+                                  ConvertPolicy policy = kConvertStrict)
+{ return toUcs4(src.data(), src.size(), alloc, policy); }
+inline std::pmr::u32string toUcs4(std::u16string_view src, std::pmr::polymorphic_allocator<char32_t> alloc,
+                                  ConvertPolicy policy = kConvertStrict)
+{ return toUcs4(src.data(), src.size(), alloc, policy); }
+
+inline std::pmr::string toLower(std::string_view src, std::pmr::polymorphic_allocator<char> alloc,
+                                const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), alloc, lang); }
+inline std::pmr::u16string toLower(std::u16string_view src, std::pmr::polymorphic_allocator<char16_t> alloc,
+                                   const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), alloc, lang); }
+inline std::pmr::u32string toLower(std::u32string_view src, std::pmr::polymorphic_allocator<char32_t> alloc,
+                                   const char* lang = nullptr)
+{ return toLower(src.data(), src.size(), alloc, lang); }
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // isXxxxx and toXxxxx for wchar_t -- Doing as well as we can with a bad deal
 //
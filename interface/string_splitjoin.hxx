@@ -43,9 +43,10 @@
 #pragma once
 
 #include <string>
-#include <list>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace ansak
@@ -54,94 +55,95 @@ namespace ansak
 //=========================================================================
 // Template function split()
 //
-// Splits a basic_string-of-C by some delimiter, also C.
-
-template <typename C>
-std::vector< std::basic_string<C> > split(const std::basic_string<C>& src, C delim)
+// Splits a basic_string-of-C by some delimiter, also C. The parts, and the
+// vector holding them, are allocated through src's allocator (so parts of
+// a std::pmr string come from the same memory resource it did).
+
+template <typename C, typename T, typename A>
+std::vector< std::basic_string<C, T, A>,
+             typename std::allocator_traits<A>::template rebind_alloc< std::basic_string<C, T, A> > >
+split(const std::basic_string<C, T, A>& src, C delim)
 {
     static_assert(std::is_integral<C>::value, "split needs an integral type.");
 
-    typedef std::basic_string<C> elem_type;
+    typedef std::basic_string<C, T, A> elem_type;
     typedef typename elem_type::size_type size_type;
-    typedef std::vector< elem_type > return_type;
+    typedef typename std::allocator_traits<A>::template rebind_alloc<elem_type> vector_alloc_type;
+    typedef std::vector< elem_type, vector_alloc_type > return_type;
 
+    vector_alloc_type alloc(src.get_allocator());
+    return_type result(alloc);
     if (src.empty())
     {
-        return return_type();
+        return result;
     }
 
     const auto npos = elem_type::npos;
 
-    size_type n = src.find(delim);
-    if (n == npos)
-    {
-        return_type result;
-        result.push_back(src);
-        return result;
-    }
-    else
+    size_type start = 0;
+    for (;;)
     {
-        std::list<size_type> breaks;
-        do
+        size_type n = src.find(delim, start);
+        if (n == npos)
         {
-            breaks.push_back(n);
-            n = src.find(delim, n + 1);
-        } while (n != npos);
-
-        return_type result(breaks.size() + 1);
-        int iResX = 0;
-        result[iResX++] = src.substr(0, *breaks.begin());
-        for (auto iBreak = breaks.begin(); iBreak != breaks.end(); ++iBreak)
-        {
-            auto nStart = *iBreak + 1;
-            auto nextBreak = iBreak; ++nextBreak;
-            if (nextBreak == breaks.end())
-            {
-                result[iResX] = src.substr(nStart);
-            }
-            else
-            {
-                result[iResX++] = src.substr(nStart, *nextBreak - nStart);
-            }
+            result.push_back(elem_type(src.data() + start, src.size() - start, src.get_allocator()));
+            return result;
         }
-        return result;
+        result.push_back(elem_type(src.data() + start, n - start, src.get_allocator()));
+        start = n + 1;
     }
 }
 
 //=========================================================================
 // Template function join()
 //
-// Joins a basic_string-of-C with some delimiter, also C.
-
-template <typename C>
-std::basic_string<C> join(const std::vector< std::basic_string<C> >& src, C delim)
+// Joins a basic_string-of-C with some delimiter, also C. The result is
+// allocated through alloc; without one, through the first part's allocator
+// (so joined std::pmr strings stay in their memory resource), or a default
+// one when there are no parts.
+
+template <typename C, typename T, typename A, typename VA>
+std::basic_string<C, T, A> join(const std::vector< std::basic_string<C, T, A>, VA >& src, C delim,
+                                const typename std::basic_string<C, T, A>::allocator_type& alloc)
 {
     static_assert(std::is_integral<C>::value, "join needs an integral type.");
 
-    typedef std::basic_string<C> return_type;
+    typedef std::basic_string<C, T, A> return_type;
 
+    return_type r(alloc);
     if (src.empty())
     {
-        return return_type();
+        return r;
     }
-    else
+
+    C delimStr[2] = {0};
+    delimStr[0] = delim;
+    typename return_type::size_type length = src.size() - 1;
+    for (const auto& s : src)
     {
-        C delimStr[2] = {0};
-        delimStr[0] = delim;
-        return_type r;
-        bool first = true;
-        for (auto s : src)
+        length += s.size();
+    }
+    r.reserve(length);
+
+    bool first = true;
+    for (const auto& s : src)
+    {
+        if (!first)
         {
-            if (!first)
-            {
-                r.append(delimStr);
-            }
-            first = false;
-            r.append(s);
+            r.append(delimStr);
         }
-
-        return r;
+        first = false;
+        r.append(s);
     }
+
+    return r;
+}
+
+template <typename C, typename T, typename A, typename VA>
+std::basic_string<C, T, A> join(const std::vector< std::basic_string<C, T, A>, VA >& src, C delim)
+{
+    return src.empty() ? std::basic_string<C, T, A>()
+                       : join(src, delim, src.front().get_allocator());
 }
 
 }
@@ -0,0 +1,627 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// mkBenchCorpora.cxx -- reads UnicodeData.txt and writes the text that
+//                       ansakStringBench runs over: a corpus per script
+//                       mix and size, in UTF-8, UTF-16 and UCS-4, and a
+//                       header naming them. Characters are drawn from the
+//                       Unicode data by a fixed pseudo-random sequence, so
+//                       every machine builds the same corpora from the
+//                       same Unicode version. Stands alone (no ansakString)
+//                       so the text doesn't depend on the code under test.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+const uint32_t kCodePointCount = 0x110000;
+
+///////////////////////////////////////////////////////////////////////////
+// Random -- splitmix64, whose output is fixed by its definition (unlike
+// the standard distributions, which vary between library implementations)
+
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : m_state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // a value from 0 to n - 1
+    size_t below(size_t n) { return static_cast<size_t>(next() % n); }
+
+private:
+    uint64_t    m_state;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// readCategories -- the two-letter general category of every code point,
+// "Cn" for those UnicodeData.txt doesn't list, expanding the
+// "<..., First>" / "<..., Last>" pairs that stand for ranges
+
+vector<string> readCategories(istream& inStream)
+{
+    vector<string> categories(kCodePointCount, "Cn");
+
+    string oneLine;
+    uint32_t rangeFirst = 0;
+    bool inRange = false;
+    while (getline(inStream, oneLine))
+    {
+        if (oneLine.size() < 10)
+        {
+            continue;
+        }
+
+        vector<string> fields;
+        istringstream lineStream(oneLine);
+        string field;
+        while (getline(lineStream, field, ';'))
+        {
+            fields.push_back(field);
+        }
+        if (fields.size() < 3)
+        {
+            throw runtime_error("short line in Unicode data: " + oneLine);
+        }
+
+        auto codePoint = static_cast<uint32_t>(stoul(fields[0], nullptr, 16));
+        if (codePoint >= kCodePointCount)
+        {
+            throw runtime_error("code point out of range: " + fields[0]);
+        }
+        if (fields[1].find(", First>") != string::npos)
+        {
+            rangeFirst = codePoint;
+            inRange = true;
+            continue;
+        }
+
+        uint32_t first = codePoint;
+        if (inRange && fields[1].find(", Last>") != string::npos)
+        {
+            first = rangeFirst;
+        }
+        inRange = false;
+        for (auto c = first; c <= codePoint; ++c)
+        {
+            categories[c] = fields[2];
+        }
+    }
+    return categories;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Pool -- the characters some part of a corpus draws on: those in the given
+// ranges whose general category starts with the given prefix ("L" for any
+// letter, "So" for symbols, "Co" for private use)
+
+typedef vector<char32_t> Pool;
+
+Pool makePool
+(
+    const vector<string>&   categories, // I - from readCategories
+    const char*             prefix,     // I - general category prefix
+    const char32_t          (*ranges)[2], // I - first/last pairs...
+    size_t                  rangeCount  // I - ...and how many
+)
+{
+    Pool pool;
+    auto prefixLength = strlen(prefix);
+    for (size_t r = 0; r < rangeCount; ++r)
+    {
+        for (auto c = ranges[r][0]; c <= ranges[r][1]; ++c)
+        {
+            if (categories[c].compare(0, prefixLength, prefix) == 0)
+            {
+                pool.push_back(c);
+            }
+        }
+    }
+    if (pool.empty())
+    {
+        throw runtime_error(string("no characters of category ") + prefix + " in a corpus's ranges");
+    }
+    return pool;
+}
+
+//=========================================================================
+// The script mixes. Each has a pool of word characters; words are two to
+// nine of them, separated by spaces (or, for CJK, not separated at all)
+// with a little punctuation. "multilingual" switches scripts every few
+// words; "invalid" is multilingual with ill-formed units injected.
+
+const char32_t kAsciiRanges[][2] = { { 0x41, 0x5a }, { 0x61, 0x7a } };
+const char32_t kLatin1Ranges[][2] = { { 0x41, 0x5a }, { 0x61, 0x7a }, { 0xc0, 0x24f } };
+const char32_t kCyrillicRanges[][2] = { { 0x400, 0x4ff } };
+const char32_t kGreekRanges[][2] = { { 0x370, 0x3ff } };
+const char32_t kCjkRanges[][2] = { { 0x3041, 0x30ff }, { 0x4e00, 0x9fff } };
+const char32_t kEmojiRanges[][2] = { { 0x1f300, 0x1faff } };
+const char32_t kPrivateRanges[][2] = { { 0xe000, 0xf8ff }, { 0xf0000, 0xffffd } };
+
+enum MixKind : int {
+    kMixAscii,
+    kMixLatin1,
+    kMixCyrillic,
+    kMixGreek,
+    kMixCjk,
+    kMixEmoji,
+    kMixPrivate,
+    kMixMultilingual,
+    kMixInvalid,
+    kMixCount
+};
+
+const char* const kMixNames[kMixCount] = {
+    "ascii", "latin1", "cyrillic", "greek", "cjk", "emoji", "private", "multilingual", "invalid"
+};
+
+struct Pools
+{
+    Pool    scripts[kMixPrivate + 1];
+};
+
+Pools makePools(const vector<string>& categories)
+{
+#define ANSAK_POOL(prefix, ranges) makePool(categories, prefix, ranges, sizeof(ranges) / sizeof(ranges[0]))
+    Pools pools;
+    pools.scripts[kMixAscii] = ANSAK_POOL("L", kAsciiRanges);
+    pools.scripts[kMixLatin1] = ANSAK_POOL("L", kLatin1Ranges);
+    pools.scripts[kMixCyrillic] = ANSAK_POOL("L", kCyrillicRanges);
+    pools.scripts[kMixGreek] = ANSAK_POOL("L", kGreekRanges);
+    pools.scripts[kMixCjk] = ANSAK_POOL("L", kCjkRanges);
+    pools.scripts[kMixEmoji] = ANSAK_POOL("So", kEmojiRanges);
+    pools.scripts[kMixPrivate] = ANSAK_POOL("Co", kPrivateRanges);
+#undef ANSAK_POOL
+    return pools;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Encoding -- each corpus is built as code points, then written out in all
+// three forms; ill-formed stretches are carried as negative markers that
+// each form writes its own way
+
+const int32_t kInvalidMarker = -1;
+
+size_t utf8Size(int32_t c)
+{
+    return c < 0 ? 3 : c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+}
+
+void appendUtf8(string& out, char32_t c)
+{
+    if (c < 0x80)
+    {
+        out += static_cast<char>(c);
+    }
+    else if (c < 0x800)
+    {
+        out += static_cast<char>(0xc0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else if (c < 0x10000)
+    {
+        out += static_cast<char>(0xe0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else
+    {
+        out += static_cast<char>(0xf0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+}
+
+void appendLittleEndian(string& out, uint32_t unit, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        out += static_cast<char>((unit >> (8 * i)) & 0xff);
+    }
+}
+
+// The n-th ill-formed stretch: three bytes of UTF-8, as utf8Size counted,
+// and a single wider unit:
+//   UTF-8:  a stray continuation pair, an overlong '/', an encoded surrogate,
+//           a byte that never appears (0xff) with two spaces, a cut-off
+//           3-byte sequence followed by a space
+//   UTF-16: a lone first or second half of a surrogate pair
+//   UCS-4:  a surrogate, or a value past U+10FFFF
+
+void appendInvalid(string& utf8, string& utf16, string& ucs4, size_t n)
+{
+    static const char* const utf8Forms[] = {
+        "\x80\xbf ", "\xc0\xaf ", "\xed\xa0\x80", "\xff  ", "\xe4\xb8 "
+    };
+    utf8 += utf8Forms[n % 5];
+    appendLittleEndian(utf16, n % 2 == 0 ? 0xd800 : 0xdc00, 2);
+    appendLittleEndian(ucs4, n % 2 == 0 ? 0xdfff : 0x110000, 4);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// makeCorpus -- code points (and invalid markers) for one mix, up to
+// utf8Bytes of UTF-8 and never a character over
+
+vector<int32_t> makeCorpus
+(
+    const Pools&    pools,          // I - the characters to draw on
+    MixKind         kind,           // I - which mix
+    size_t          utf8Bytes       // I - how long to make it
+)
+{
+    Random random(0x616e73616bull + static_cast<uint64_t>(kind));
+    static const char32_t punctuation[] = { '.', ',', ';', '!', '?' };
+    static const char32_t cjkPunctuation[] = { 0x3001, 0x3002, 0xff0c, 0xff01 };
+
+    vector<int32_t> corpus;
+    size_t size = 0;
+    size_t words = 0;
+    auto script = kind;
+    auto add = [&corpus, &size, utf8Bytes](int32_t c) {
+        auto n = utf8Size(c);
+        if (size + n > utf8Bytes)
+        {
+            return false;
+        }
+        corpus.push_back(c);
+        size += n;
+        return true;
+    };
+
+    for (bool room = true; room; ++words)
+    {
+        if (kind >= kMixMultilingual && words % 4 == 0)
+        {
+            script = static_cast<MixKind>(random.below(kMixPrivate + 1));
+        }
+        const auto& pool = pools.scripts[script];
+
+        auto length = 2 + random.below(8);
+        for (size_t i = 0; room && i < length; ++i)
+        {
+            room = add(static_cast<int32_t>(pool[random.below(pool.size())]));
+        }
+        if (kind == kMixInvalid && random.below(64) == 0)
+        {
+            room = room && add(kInvalidMarker);
+        }
+
+        if (script == kMixCjk)
+        {
+            if (random.below(6) == 0)
+            {
+                room = room && add(static_cast<int32_t>(cjkPunctuation[random.below(4)]));
+            }
+        }
+        else
+        {
+            if (random.below(6) == 0)
+            {
+                room = room && add(static_cast<int32_t>(punctuation[random.below(5)]));
+            }
+            room = room && add(random.below(12) == 0 ? '\n' : ' ');
+        }
+    }
+    return corpus;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// writeCorpus -- one corpus in its three forms: <name>.utf8, .utf16 and
+// .ucs4, the wider ones little-endian whatever the machine
+
+void writeFile(const string& name, const string& contents)
+{
+    ofstream out(name.c_str(), ios::out | ios::trunc | ios::binary);
+    out.write(contents.data(), static_cast<streamsize>(contents.size()));
+    if (!out)
+    {
+        throw runtime_error("could not write " + name);
+    }
+}
+
+void writeCorpus(const string& baseName, const vector<int32_t>& corpus)
+{
+    string utf8;
+    string utf16;
+    string ucs4;
+    size_t invalidCount = 0;
+    for (auto c : corpus)
+    {
+        if (c == kInvalidMarker)
+        {
+            appendInvalid(utf8, utf16, ucs4, invalidCount++);
+            continue;
+        }
+        appendUtf8(utf8, static_cast<char32_t>(c));
+        if (c >= 0x10000)
+        {
+            appendLittleEndian(utf16, 0xd800 + ((c - 0x10000) >> 10), 2);
+            appendLittleEndian(utf16, 0xdc00 + ((c - 0x10000) & 0x3ff), 2);
+        }
+        else
+        {
+            appendLittleEndian(utf16, static_cast<uint32_t>(c), 2);
+        }
+        appendLittleEndian(ucs4, static_cast<uint32_t>(c), 4);
+    }
+    writeFile(baseName + ".utf8", utf8);
+    writeFile(baseName + ".utf16", utf16);
+    writeFile(baseName + ".ucs4", ucs4);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// writeHeader -- where the corpora are and what they're called, for the
+// benchmarks to register themselves over
+
+void writeHeader
+(
+    ostream&                outStream,  // I - where to write
+    const string&           outDir,     // I - the corpora's directory
+    const vector<size_t>&   sizes       // I - the sizes written
+)
+{
+    string escapedDir;
+    for (auto c : outDir)
+    {
+        if (c == '\\' || c == '"')
+        {
+            escapedDir += '\\';
+        }
+        escapedDir += c;
+    }
+
+    outStream << "// Generated by mkBenchCorpora -- do not edit." << endl
+              << endl
+              << "#pragma once" << endl
+              << endl
+              << "#include <cstddef>" << endl
+              << endl
+              << "namespace ansak {" << endl
+              << endl
+              << "namespace internal {" << endl
+              << endl
+              << "// <dir>/<name>_<size>.utf8, .utf16 and .ucs4 (the last two little-endian)" << endl
+              << "const char* const kBenchCorpusDir = \"" << escapedDir << "\";" << endl
+              << endl
+              << "const char* const kBenchCorpusNames[] = {";
+    for (int kind = 0; kind < kMixCount; ++kind)
+    {
+        outStream << (kind == 0 ? " \"" : ", \"") << kMixNames[kind] << '"';
+    }
+    outStream << " };" << endl
+              << "const int kBenchCorpusCount = " << kMixCount << ';' << endl
+              << "// the one with ill-formed units injected" << endl
+              << "const int kBenchCorpusInvalid = " << kMixInvalid << ';' << endl
+              << endl
+              << "// bytes of UTF-8 in each corpus, at most" << endl
+              << "const size_t kBenchCorpusSizes[] = {";
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        outStream << (i == 0 ? " " : ", ") << sizes[i];
+    }
+    outStream << " };" << endl
+              << "const int kBenchCorpusSizeCount = " << sizes.size() << ';' << endl
+              << endl
+              << "}" << endl
+              << endl
+              << "}" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// process -- read the data, make every corpus and write them and the header
+
+void process
+(
+    filebuf&                inbuf,      // I - UnicodeData.txt
+    filebuf&                headerBuf,  // I - the header to write
+    const string&           outDir,     // I - where the corpora go
+    const vector<size_t>&   sizes       // I - UTF-8 bytes in each
+)
+{
+    istream inStream(&inbuf);
+    ostream headerStream(&headerBuf);
+
+    auto pools = makePools(readCategories(inStream));
+    for (int kind = 0; kind < kMixCount; ++kind)
+    {
+        for (auto size : sizes)
+        {
+            // each size is made afresh, so a smaller corpus is the start of
+            // a larger one
+            ostringstream baseName;
+            baseName << outDir << '/' << kMixNames[kind] << '_' << size;
+            writeCorpus(baseName.str(), makeCorpus(pools, static_cast<MixKind>(kind), size));
+        }
+    }
+
+    writeHeader(headerStream, outDir, sizes);
+    if (!headerStream)
+    {
+        throw runtime_error("could not write header");
+    }
+}
+
+//=========================================================================
+// "1024,65536,1048576" as sizes; false if any isn't a positive number
+
+bool parseSizes(const char* text, vector<size_t>& sizes)
+{
+    sizes.clear();
+    istringstream textStream(text);
+    string one;
+    while (getline(textStream, one, ','))
+    {
+        char* end = nullptr;
+        auto size = strtoul(one.c_str(), &end, 10);
+        if (one.empty() || *end != '\0' || size == 0)
+        {
+            return false;
+        }
+        sizes.push_back(static_cast<size_t>(size));
+    }
+    return !sizes.empty();
+}
+
+void usage(const char* name)
+{
+    cerr << "Usage: " << name << " [--sizes N,N,...] <infile> <outheader> <outdir>" << endl;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// main -- simple parameter parsing and set up for "process" above.
+
+int main(int argc, char* argv[])
+{
+    vector<size_t> sizes;
+    parseSizes("1024,65536,1048576", sizes);
+    int argn = 1;
+    for (; argn < argc && strncmp(argv[argn], "--", 2) == 0; ++argn)
+    {
+        if (strcmp(argv[argn], "--sizes") == 0 && argn + 1 < argc)
+        {
+            if (!parseSizes(argv[++argn], sizes))
+            {
+                usage(argv[0]);
+                cerr << "    sizes must be positive numbers of bytes, comma-separated." << endl;
+                return 1;
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - argn != 3)
+    {
+        usage(argv[0]);
+        cerr << "    to make benchmark corpora from ;-delimited Unicode data." << endl;
+        return 1;
+    }
+    const char* inName = argv[argn];
+    const char* headerName = argv[argn + 1];
+    string outDir(argv[argn + 2]);
+
+    // if the infile or the outdir does not exist, complain and leave
+    struct stat statData;
+    auto rc = stat(inName, &statData);
+    if (rc != 0)
+    {
+        usage(argv[0]);
+        cerr << "    infile does not exist." << endl;
+        return 2;
+    }
+    rc = stat(outDir.c_str(), &statData);
+    if (rc != 0 || (statData.st_mode & S_IFDIR) == 0)
+    {
+        usage(argv[0]);
+        cerr << "    outdir does not exist." << endl;
+        return 2;
+    }
+
+    // if the outfiles can not be created, complain and leave
+    bool opened1 = false;
+    bool opened2 = false;
+    try
+    {
+        filebuf inBuf;
+        if (inBuf.open(inName, std::ios::in) == nullptr)
+        {
+            throw runtime_error("infile");
+        }
+        opened1 = true;
+
+        filebuf headerBuf;
+        if (headerBuf.open(headerName, std::ios::out | std::ios::trunc) == nullptr)
+        {
+            throw runtime_error("outfile");
+        }
+        opened2 = true;
+
+        process(inBuf, headerBuf, outDir, sizes);
+        inBuf.close();
+        headerBuf.close();
+    }
+    catch (exception& e)
+    {
+        usage(argv[0]);
+        if (opened2)
+        {
+            cerr << "    an error occurred in making the corpora: " << e.what() << endl;
+            return 4;
+        }
+        else if (opened1)
+        {
+            cerr << "    the outheader could not be created." << endl;
+            return 3;
+        }
+        else
+        {
+            cerr << "    infile could not be opened." << endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,524 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// mkUnicodeTables.cxx -- reads UnicodeData.txt and writes the block tables
+//                        behind isUnicodeAssigned, isUnicodePrivate,
+//                        isControlChar, isWhitespaceChar,
+//                        charToEncodingTypeMask and toLower: a header of
+//                        layout constants and declarations, and a source
+//                        file of the tables themselves. Stands alone (no
+//                        ansakString) because ansakString is built from it.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+// mirror the EncodingTypeFlags in string_internal.hxx
+const uint8_t kIsAssignedFlag = 0x01;
+const uint8_t kIsPrivateFlag = 0x02;
+const uint8_t kIsControlFlag = 0x04;
+const uint8_t kIsWhiteSpaceFlag = 0x08;
+
+const uint32_t kCodePointCount = 0x110000;
+
+///////////////////////////////////////////////////////////////////////////
+// Layout -- the choices a build can make about the tables' shape
+
+struct Layout
+{
+    unsigned    blockBits;      // log2 of code points per block, 4..16
+    bool        packed;         // two code points' property flags per byte
+};
+
+///////////////////////////////////////////////////////////////////////////
+// BlockTable -- values for every code point, cut into blocks, with each
+// distinct block kept once and an index from block number to kept block
+
+struct BlockTable
+{
+    vector<uint32_t>    index;
+    vector<uint8_t>     blocks;
+    size_t              blockCount;
+};
+
+BlockTable makeBlockTable(const vector<uint8_t>& values, unsigned blockBits)
+{
+    const uint32_t blockSize = 1u << blockBits;
+
+    BlockTable table;
+    map<vector<uint8_t>, uint32_t> blockNumbers;
+    for (uint32_t base = 0; base < kCodePointCount; base += blockSize)
+    {
+        vector<uint8_t> block(values.begin() + base, values.begin() + base + blockSize);
+        auto found = blockNumbers.find(block);
+        if (found == blockNumbers.end())
+        {
+            found = blockNumbers.insert(make_pair(block,
+                        static_cast<uint32_t>(blockNumbers.size()))).first;
+            table.blocks.insert(table.blocks.end(), block.begin(), block.end());
+        }
+        table.index.push_back(found->second);
+    }
+    table.blockCount = blockNumbers.size();
+    return table;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// packNibbles -- property flags need only four bits; put even code points
+// in the low nibble and odd ones in the high
+
+vector<uint8_t> packNibbles(const vector<uint8_t>& values)
+{
+    vector<uint8_t> packed(values.size() / 2);
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        packed[i] = static_cast<uint8_t>(values[2 * i] | (values[2 * i + 1] << 4));
+    }
+    return packed;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// propertiesOf -- the flags for one code point given its general category.
+// Private-use and surrogate code points are not "assigned" for ansakString's
+// purposes; the C0/C1 whitespace controls aren't in Zs/Zl/Zp but count.
+
+uint8_t propertiesOf(uint32_t codePoint, const string& category)
+{
+    uint8_t flags = 0;
+    if (category == "Co")
+    {
+        flags |= kIsPrivateFlag;
+    }
+    else if (category != "Cs")
+    {
+        flags |= kIsAssignedFlag;
+    }
+    if (category == "Cc")
+    {
+        flags |= kIsControlFlag;
+    }
+    if (category == "Zs" || category == "Zl" || category == "Zp" ||
+        (codePoint >= 9 && codePoint <= 13) || codePoint == 0x85)
+    {
+        flags |= kIsWhiteSpaceFlag;
+    }
+    return flags;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// readUnicodeData -- fill in the flags and the simple lower-case mapping
+// (as a distance from the code point) for every code point, expanding the
+// "<..., First>" / "<..., Last>" pairs that stand for ranges
+
+void readUnicodeData
+(
+    istream&            inStream,       // I - UnicodeData.txt
+    vector<uint8_t>&    properties,     // O - flags for every code point
+    vector<int32_t>&    lowerDeltas     // O - lower case minus code point
+)
+{
+    properties.assign(kCodePointCount, 0);
+    lowerDeltas.assign(kCodePointCount, 0);
+
+    string oneLine;
+    uint32_t rangeFirst = 0;
+    bool inRange = false;
+    while (getline(inStream, oneLine))
+    {
+        if (oneLine.size() < 10)
+        {
+            continue;
+        }
+
+        vector<string> fields;
+        istringstream lineStream(oneLine);
+        string field;
+        while (getline(lineStream, field, ';'))
+        {
+            fields.push_back(field);
+        }
+        if (fields.size() < 14)
+        {
+            throw runtime_error("short line in Unicode data: " + oneLine);
+        }
+
+        auto codePoint = static_cast<uint32_t>(stoul(fields[0], nullptr, 16));
+        if (codePoint >= kCodePointCount)
+        {
+            throw runtime_error("code point out of range: " + fields[0]);
+        }
+        const string& name = fields[1];
+        if (name.find(", First>") != string::npos)
+        {
+            rangeFirst = codePoint;
+            inRange = true;
+            continue;
+        }
+
+        uint32_t first = codePoint;
+        if (inRange && name.find(", Last>") != string::npos)
+        {
+            first = rangeFirst;
+        }
+        inRange = false;
+        for (auto c = first; c <= codePoint; ++c)
+        {
+            properties[c] = propertiesOf(c, fields[2]);
+        }
+        if (!fields[13].empty())
+        {
+            auto lower = static_cast<int32_t>(stoul(fields[13], nullptr, 16));
+            lowerDeltas[codePoint] = lower - static_cast<int32_t>(codePoint);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// writeValues -- an initializer list, 16 to a line (hex for the tables of
+// bytes and indexes, decimal for the signed deltas)
+
+template <typename T>
+void writeValues(ostream& outStream, const vector<T>& values, bool asHex)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        outStream << ((i % 16) == 0 ? "\n    " : " ");
+        if (asHex)
+        {
+            outStream << "0x" << hex << setfill('0') << setw(2)
+                      << static_cast<uint32_t>(values[i]) << dec << ',';
+        }
+        else
+        {
+            outStream << static_cast<int64_t>(values[i]) << ',';
+        }
+    }
+    outStream << endl;
+}
+
+const char* indexType(const BlockTable& table)
+{
+    return table.blockCount <= 0x100 ? "uint8_t" : "uint16_t";
+}
+
+///////////////////////////////////////////////////////////////////////////
+// writeHeader -- the layout constants and table declarations that
+// string_internal.hxx builds its lookups on
+
+void writeHeader
+(
+    ostream&            outStream,      // I - where to write
+    const Layout&       layout,         // I - the layout chosen
+    const BlockTable&   properties,     // I - property flag table
+    const BlockTable&   lowerCase,      // I - lower-case delta table
+    size_t              deltaCount      // I - distinct lower-case deltas
+)
+{
+    outStream << "// Generated by mkUnicodeTables -- do not edit." << endl
+              << endl
+              << "#pragma once" << endl
+              << endl
+              << "#include <cstdint>" << endl
+              << endl
+              << "namespace ansak {" << endl
+              << endl
+              << "namespace internal {" << endl
+              << endl
+              << "// " << (1u << layout.blockBits) << " code points per block; property flags "
+              << (layout.packed ? "packed two to a byte" : "one byte each") << endl
+              << "const unsigned kCharTableBlockBits = " << layout.blockBits << ';' << endl
+              << "const bool kCharPropertiesPacked = " << (layout.packed ? "true" : "false") << ';' << endl
+              << endl
+              << "// " << properties.blockCount << " distinct blocks of property flags" << endl
+              << "typedef " << indexType(properties) << " CharPropertyIndex;" << endl
+              << "extern const CharPropertyIndex kCharPropertyIndex[];" << endl
+              << "extern const uint8_t kCharPropertyBlocks[];" << endl
+              << endl
+              << "// " << lowerCase.blockCount << " distinct blocks of indexes into "
+              << deltaCount << " distinct lower-case deltas" << endl
+              << "typedef " << indexType(lowerCase) << " LowerCaseIndex;" << endl
+              << "extern const LowerCaseIndex kLowerCaseIndex[];" << endl
+              << "extern const uint8_t kLowerCaseBlocks[];" << endl
+              << "extern const int32_t kLowerCaseDeltas[];" << endl
+              << endl
+              << "}" << endl
+              << endl
+              << "}" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// writeSource -- the tables
+
+void writeSource
+(
+    ostream&                outStream,      // I - where to write
+    const string&           headerName,     // I - what to include
+    const BlockTable&       properties,     // I - property flag table
+    const vector<uint8_t>&  propertyBlocks, // I - its blocks, packed or not
+    const BlockTable&       lowerCase,      // I - lower-case delta table
+    const vector<int32_t>&  deltas          // I - distinct lower-case deltas
+)
+{
+    outStream << "// Generated by mkUnicodeTables -- do not edit." << endl
+              << "// " << (properties.index.size() * (properties.blockCount <= 0x100 ? 1 : 2) +
+                           propertyBlocks.size())
+              << " bytes of property tables, "
+              << (lowerCase.index.size() * (lowerCase.blockCount <= 0x100 ? 1 : 2) +
+                  lowerCase.blocks.size() + deltas.size() * 4)
+              << " bytes of lower-case tables." << endl
+              << endl
+              << "#include \"" << headerName << '"' << endl
+              << endl
+              << "namespace ansak {" << endl
+              << endl
+              << "namespace internal {" << endl
+              << endl
+              << "const CharPropertyIndex kCharPropertyIndex[" << properties.index.size() << "] = {";
+    writeValues(outStream, properties.index, true);
+    outStream << "};" << endl
+              << endl
+              << "const uint8_t kCharPropertyBlocks[" << propertyBlocks.size() << "] = {";
+    writeValues(outStream, propertyBlocks, true);
+    outStream << "};" << endl
+              << endl
+              << "const LowerCaseIndex kLowerCaseIndex[" << lowerCase.index.size() << "] = {";
+    writeValues(outStream, lowerCase.index, true);
+    outStream << "};" << endl
+              << endl
+              << "const uint8_t kLowerCaseBlocks[" << lowerCase.blocks.size() << "] = {";
+    writeValues(outStream, lowerCase.blocks, true);
+    outStream << "};" << endl
+              << endl
+              << "const int32_t kLowerCaseDeltas[" << deltas.size() << "] = {";
+    writeValues(outStream, deltas, false);
+    outStream << "};" << endl
+              << endl
+              << "}" << endl
+              << endl
+              << "}" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// process -- read the data, lay out the tables and write them
+
+void process
+(
+    filebuf&        inbuf,          // I - UnicodeData.txt
+    filebuf&        headerBuf,      // I - the header to write
+    filebuf&        sourceBuf,      // I - the source to write
+    const string&   headerName,     // I - the header's name, for #include
+    const Layout&   layout          // I - the layout chosen
+)
+{
+    istream inStream(&inbuf);
+    ostream headerStream(&headerBuf);
+    ostream sourceStream(&sourceBuf);
+
+    vector<uint8_t> properties;
+    vector<int32_t> lowerDeltas;
+    readUnicodeData(inStream, properties, lowerDeltas);
+
+    // lower case goes through one more step: each code point keeps a byte
+    // naming one of the few distinct deltas
+    map<int32_t, uint8_t> deltaNumbers;
+    deltaNumbers[0] = 0;
+    for (auto d : lowerDeltas)
+    {
+        if (deltaNumbers.find(d) == deltaNumbers.end())
+        {
+            if (deltaNumbers.size() > 0xff)
+            {
+                throw runtime_error("too many distinct lower-case deltas for a byte");
+            }
+            deltaNumbers[d] = 0;
+        }
+    }
+    vector<int32_t> deltas;
+    for (auto& number : deltaNumbers)
+    {
+        number.second = static_cast<uint8_t>(deltas.size());
+        deltas.push_back(number.first);
+    }
+    vector<uint8_t> lowerNumbers(kCodePointCount);
+    for (uint32_t c = 0; c < kCodePointCount; ++c)
+    {
+        lowerNumbers[c] = deltaNumbers[lowerDeltas[c]];
+    }
+
+    auto propertyTable = makeBlockTable(properties, layout.blockBits);
+    auto lowerTable = makeBlockTable(lowerNumbers, layout.blockBits);
+    if (propertyTable.blockCount > 0x10000 || lowerTable.blockCount > 0x10000)
+    {
+        throw runtime_error("too many distinct blocks for a 16-bit index");
+    }
+
+    writeHeader(headerStream, layout, propertyTable, lowerTable, deltas.size());
+    writeSource(sourceStream, headerName, propertyTable,
+                layout.packed ? packNibbles(propertyTable.blocks) : propertyTable.blocks,
+                lowerTable, deltas);
+    if (!headerStream || !sourceStream)
+    {
+        throw runtime_error("could not write tables");
+    }
+}
+
+void usage(const char* name)
+{
+    cerr << "Usage: " << name << " [--block-bits N] [--packed] <infile> <outheader> <outsource>" << endl;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// main -- simple parameter parsing and set up for "process" above.
+
+int main(int argc, char* argv[])
+{
+    Layout layout = { 8, false };
+    int argn = 1;
+    for (; argn < argc && strncmp(argv[argn], "--", 2) == 0; ++argn)
+    {
+        if (strcmp(argv[argn], "--packed") == 0)
+        {
+            layout.packed = true;
+        }
+        else if (strcmp(argv[argn], "--block-bits") == 0 && argn + 1 < argc)
+        {
+            layout.blockBits = static_cast<unsigned>(atoi(argv[++argn]));
+            if (layout.blockBits < 4 || layout.blockBits > 16)
+            {
+                usage(argv[0]);
+                cerr << "    block bits must be from 4 to 16." << endl;
+                return 1;
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - argn != 3)
+    {
+        usage(argv[0]);
+        cerr << "    to convert ;-delimited Unicode data into character tables." << endl;
+        return 1;
+    }
+    const char* inName = argv[argn];
+    const char* headerName = argv[argn + 1];
+    const char* sourceName = argv[argn + 2];
+
+    // if the infile does not exist, complain and leave
+    struct stat statData;
+    auto rc = stat(inName, &statData);
+    if (rc != 0)
+    {
+        usage(argv[0]);
+        cerr << "    infile does not exist." << endl;
+        return 2;
+    }
+
+    // if the outfiles can not be created, complain and leave
+    bool opened1 = false;
+    bool opened2 = false;
+    try
+    {
+        filebuf inBuf;
+        if (inBuf.open(inName, std::ios::in) == nullptr)
+        {
+            throw runtime_error("infile");
+        }
+        opened1 = true;
+
+        filebuf headerBuf;
+        filebuf sourceBuf;
+        if (headerBuf.open(headerName, std::ios::out | std::ios::trunc) == nullptr ||
+            sourceBuf.open(sourceName, std::ios::out | std::ios::trunc) == nullptr)
+        {
+            throw runtime_error("outfile");
+        }
+        opened2 = true;
+
+        string headerFile(headerName);
+        auto slash = headerFile.find_last_of("/\\");
+        process(inBuf, headerBuf, sourceBuf,
+                slash == string::npos ? headerFile : headerFile.substr(slash + 1), layout);
+        inBuf.close();
+        headerBuf.close();
+        sourceBuf.close();
+    }
+    catch (exception& e)
+    {
+        usage(argv[0]);
+        if (opened2)
+        {
+            cerr << "    an error occurred in processing the Unicode data: " << e.what() << endl;
+            return 4;
+        }
+        else if (opened1)
+        {
+            cerr << "    an outfile could not be created." << endl;
+            return 3;
+        }
+        else
+        {
+            cerr << "    infile could not be opened." << endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -48,8 +48,13 @@
 
 #include "string.hxx"
 #include "string_internal.hxx"
+#include "string_simd.hxx"
+#include "string_utf8_dfa.hxx"
 #include "internal/string_decode_utf8.hxx"
 
+#include <algorithm>
+#include <string.h>
+
 using namespace std;
 using namespace ansak::internal;
 
@@ -63,25 +68,238 @@ namespace {
 RangeTypeFlags rangeTypeToRangeFlag[RangeType::kFirstInvalidRange] =
     { kAsciiFlag, kUtf8Flag, kUcs2Flag, kUtf16Flag, kUcs4Flag, kUnicodeFlag };
 
+// highest byte a vector kernel may pass for each target: ASCII stops at 7f,
+// UCS-2 at the last 3-byte lead; the rest are limited only by well-formedness
+unsigned char rangeTypeToHighestByte[RangeType::kFirstInvalidRange] =
+    { 0x7f, 0xff, 0xef, 0xff, 0xff, 0xff };
+
+// highest character each target takes from UCS-4; beyond surrogates, the
+// range flags ask no more than this
+char32_t rangeTypeToLastChar[RangeType::kFirstInvalidRange] =
+    { 0x7f, 0x7fffffff, 0xffff, 0x10ffff, 0xffffffff, 0x10ffff };
+
+// after a vector kernel stops short, how far the scalar loop runs on its own
+// before handing back
+const size_t kScalarResyncLength = 64;
+
 ///////////////////////////////////////////////////////////////////////////
 // Local Functions
 
 //=========================================================================
-// Is character (of whatever type) encodable as UTF-16? (in range 0..10FFFF)
+// Converts all of src onto the end of result, sized once, up front, to the
+// exact length the result will have, then trims off anything not produced
+// (an incomplete character at the end of src).
 //
-// Returns true if in range, false otherwise.
+// When policy lets bad input through, length (counted as if there were
+// none) may fall short; the result grows and conversion carries on from
+// where it stopped. An incomplete character at the end is replaced too.
+//
+// Returns true, or false (with result as it was) if src can't be converted.
 
-template<typename C>
-bool isUtf16Encodable
+template<typename D, typename S>
+bool convertOnto
+(
+    const S*                src,        // I - the source
+    size_t                  srcLength,  // I - its length in units
+    size_t                  length,     // I - the exact length of a strict result
+    ConvertResult         (*convert)(const S*, size_t, D*, size_t, ConvertPolicy),  // I - the converter
+    ConvertPolicy           policy,     // I - what to do with bad input
+    ResultSink<D>&          result      // I/O - what to add the result to
+)
+{
+    if (!src || srcLength == 0)
+    {
+        return true;
+    }
+
+    auto base = result.size();
+    auto room = length;
+    auto dst = result.resize(base + room) + base;
+    size_t consumed = 0;
+    size_t produced = 0;
+    for (;;)
+    {
+        auto r = convert(src + consumed, srcLength - consumed, dst + produced, room - produced, policy);
+        consumed += r.consumed;
+        produced += r.produced;
+        if (r.status == kConvertTargetFull && policy != kConvertStrict)
+        {
+            room += room / 2 + 8;
+            dst = result.resize(base + room) + base;
+            continue;
+        }
+        if (r.status == kConvertIncomplete && policy == kConvertReplace)
+        {
+            // one U+FFFD for each maximal subpart of what's left
+            D units[3];
+            auto n = encodeUnits(0xfffd, units);
+            for (auto p = src + consumed; p < src + srcLength; p += maximalSubpart(p, src + srcLength))
+            {
+                if (produced + n > room)
+                {
+                    room = produced + n;
+                    dst = result.resize(base + room) + base;
+                }
+                copy(units, units + n, dst + produced);
+                produced += n;
+            }
+        }
+        else if (r.status != kConvertOk && r.status != kConvertIncomplete)
+        {
+            result.resize(base);
+            return false;
+        }
+        break;
+    }
+    result.resize(base + produced);
+    return true;
+}
+
+//=========================================================================
+// Converts all of src into a string of its own, as convertOnto does.
+//
+// Returns the converted string, empty if src can't be converted.
+
+template<typename D, typename S>
+std::basic_string<D> convertWhole
+(
+    const S*                src,        // I - the source
+    size_t                  srcLength,  // I - its length in units
+    size_t                  length,     // I - the exact length of a strict result
+    ConvertResult         (*convert)(const S*, size_t, D*, size_t, ConvertPolicy),  // I - the converter
+    ConvertPolicy           policy      // I - what to do with bad input
+)
+{
+    std::basic_string<D> result;
+    if (src && srcLength != 0 && (length != 0 || policy != kConvertStrict))
+    {
+        StringSink<D, std::allocator<D>> sink(result);
+        convertOnto(src, srcLength, length, convert, policy, sink);
+    }
+    return result;
+}
+
+//=========================================================================
+// Counts the code points in a null- or length-terminated UTF-16 source for
+// unicodeLength, reading no further than readable units (to the null, or
+// to testLength, or to the end of a basic_string that holds it).
+//
+// Returns the number of code points, 0 if the source is not valid
+
+unsigned int terminatedUnicodeLength
 (
-    C                   c       // I - character to test
+    const char16_t*     src,            // I - A null- or length-term'd source
+    unsigned int        testLength,     // I - length of source, 0 if null-term'd
+    size_t              readable        // I - units that may be read
 )
 {
-    static_assert(std::is_integral<C>::value, "isUtf16Encodable needs an integral type.");
+    // some behaviour is changed if the scan is length terminated
+    bool lengthTerminated = testLength != 0;
+
+    auto lengthLeft = testLength;
+    auto pLast = src - 1;
+    unsigned int usedThisTime = 0;
+    unsigned int r = 0;
+
+    // the vector kernels take well-formed runs, stopping at any null
+    auto fastEnd = src + readable;
+    auto resumeFastAt = src;
+
+    for (auto p = src; *p; ++p, ++r)
+    {
+        if (p >= resumeFastAt && p < fastEnd)
+        {
+            auto skipped = validUtf16Prefix(p, static_cast<size_t>(fastEnd - p), 1);
+            if (skipped != 0)
+            {
+                r += static_cast<unsigned int>(leadCount(p, skipped));
+                p += skipped;
+                if (lengthTerminated)
+                {
+                    if (lengthLeft <= skipped)
+                    {
+                        return r;
+                    }
+                    lengthLeft -= static_cast<unsigned int>(skipped);
+                    pLast = p - 1;
+                }
+                if (!*p)
+                {
+                    break;
+                }
+            }
+            resumeFastAt = p + kScalarResyncLength;
+        }
+
+        // fetch the current character -- is it invalid UTF-16
+        auto c = *p;
+        if (isSecondHalfUtf16(c))
+        {
+            return 0;
+        }
+
+        // is this the first of two parts?
+        bool isFirstHalf = isFirstHalfUtf16(c);
+        unsigned int wordsNeeded = isFirstHalf ? 2 : 1;
+
+        // have we got another half to deal with it?
+        if (lengthTerminated && wordsNeeded > lengthLeft)
+        {
+            return r;
+        }
+
+        // or if null terminated, is there another piece?
+        auto c1 = p[1];
+        if (isFirstHalf && c1 == 0)
+        {
+            return r - 1;
+        }
+
+        // and if in two pieces, is it valid?
+        bool isTwoHalves = isFirstHalf && isSecondHalfUtf16(c1);
+
+        if (isTwoHalves)
+        {
+            // ah, okay -- advance the pointer an extra bit
+            ++p;
+        }
+        else if (isFirstHalf)
+        {
+            // not so good! encoding error...
+            return 0;
+        }
+
+        // decoded -- how much was used?
+        if (lengthTerminated)
+        {
+            usedThisTime = static_cast<unsigned int>(p - pLast);
+            pLast = p;
+        }
+
+        if (lengthTerminated)
+        {
+            if (lengthLeft == usedThisTime)
+            {
+                return r + 1;
+            }
+            lengthLeft -= usedThisTime;
+        }
+    }
+
+    return lengthTerminated ? 0 : r;
+}
+
+
+//=========================================================================
+// Length of a null-terminated string of any character type, 0 for nullptr
 
-    // don't depend on signed-ness -- first half covers unsigned case,
-    // second half covers negative numbers without calling them so.
-    return c <= 0x10ffff && (c & ~0x1fffff) == 0;
+template<typename C>
+size_t nullTerminatedLength
+(
+    const C*            src     // I - the null-terminated source, or nullptr
+)
+{
+    return src ? std::char_traits<C>::length(src) : 0;
 }
 
 //=========================================================================
@@ -197,6 +415,52 @@ inline bool isSecondHalfUtf16AsUtf8
                 static_cast<unsigned char>(p[2])));
 }
 
+//=========================================================================
+// Work out why the decoder refused the sequence starting at p. Only called
+// once it has, so that validating costs nothing extra until then.
+//
+// Returns the kind of error.
+
+ValidationError whyRefused
+(
+    const char*         p,      // I - the first byte of the sequence
+    const char*         end     // I - one past the last byte available
+)
+{
+    static const char32_t smallest[] = { 0, 0, 0x80, 0x800, 0x10000, 0x200000, 0x4000000 };
+
+    auto length = sequenceSizeCharStarts(p);
+    if (length <= 0)
+    {
+        return kValidationMalformed;
+    }
+    auto lead = static_cast<unsigned char>(*p);
+    char32_t c = lead & (0x7f >> length);
+    for (int i = 1; i < length; ++i)
+    {
+        if (p + i == end)
+        {
+            return kValidationTruncated;
+        }
+        auto b = static_cast<unsigned char>(p[i]);
+        if ((b & 0xc0) != 0x80)
+        {
+            return kValidationMalformed;
+        }
+        c = (c << 6) | (b & 0x3f);
+    }
+    if (c < smallest[length])
+    {
+        return kValidationOverlong;
+    }
+    // a second half on its own, or a first half without one after it
+    if (isFirstHalfUtf16(c) || isSecondHalfUtf16(c))
+    {
+        return kValidationSurrogate;
+    }
+    return kValidationMalformed;
+}
+
 //=========================================================================
 // Utility function to check the UTF-8 encoding of a length- or null-
 // terminated string of bytes.
@@ -232,11 +496,50 @@ bool isUtf8
     RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
     bool isNullPred = pred == EncodingCheckPredicate();
 
+    // the vector kernels vouch for runs of well-formed UTF-8 short of any
+    // null; the loop below takes over wherever they stop, to rule on CESU-8
+    // pairs, 5- and 6-byte sequences, predicates and the end of the run
+    auto fastEnd = test;
+    if (isNullPred && lengthTerminated)
+    {
+        auto nul = static_cast<const char*>(memchr(test, 0, testLength));
+        fastEnd = nul != nullptr ? nul : test + testLength;
+    }
+    else if (isNullPred)
+    {
+        fastEnd = test + strlen(test);
+    }
+    auto highestByte = rangeTypeToHighestByte[targetRange];
+    auto resumeFastAt = test;
+
     auto lengthLeft = testLength;
     auto pLast = test - 1;
     unsigned int usedThisTime = 0;
     for (auto p = test; *p; ++p)
     {
+        if (p >= resumeFastAt && p < fastEnd)
+        {
+            auto skipped = validUtf8Prefix(p, static_cast<size_t>(fastEnd - p), highestByte);
+            if (skipped != 0)
+            {
+                p += skipped;
+                if (lengthTerminated)
+                {
+                    if (lengthLeft <= skipped)
+                    {
+                        return true;
+                    }
+                    lengthLeft -= static_cast<unsigned int>(skipped);
+                    pLast = p - 1;
+                }
+                if (!*p)
+                {
+                    break;
+                }
+            }
+            resumeFastAt = p + kScalarResyncLength;
+        }
+
         RangeTypeFlags rangeFlag = getRangeFlag(*p);
         if ((rangeFlag & restrictToThis) == 0)
         {
@@ -269,7 +572,7 @@ bool isUtf8
             }
         }
 
-        auto c = decodeUtf8(p);
+        auto c = utf8dfa::decode(p);
 
         // how did decoding go?
         if (p == nullptr)
@@ -319,6 +622,53 @@ bool isUtf8
 
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Internal Functions
+
+namespace internal {
+
+bool toUtf8Onto(const char16_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char>& result)
+{
+    return !src || convertOnto<char>(src, srcLength, utf8Length(src, srcLength), toUtf8, policy, result);
+}
+
+bool toUtf8Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char>& result)
+{
+    return !src || convertOnto<char>(src, srcLength, utf8Length(src, srcLength), toUtf8, policy, result);
+}
+
+bool toUcs2Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result)
+{
+    return !src || convertOnto<char16_t>(src, srcLength, ucs4Length(src, srcLength), toUcs2, policy, result);
+}
+
+bool toUcs2Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result)
+{
+    return !src || convertOnto<char16_t>(src, srcLength, srcLength, toUcs2, policy, result);
+}
+
+bool toUtf16Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result)
+{
+    return !src || convertOnto<char16_t>(src, srcLength, utf16Length(src, srcLength), toUtf16, policy, result);
+}
+
+bool toUtf16Onto(const char32_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char16_t>& result)
+{
+    return !src || convertOnto<char16_t>(src, srcLength, utf16Length(src, srcLength), toUtf16, policy, result);
+}
+
+bool toUcs4Onto(const char* src, size_t srcLength, ConvertPolicy policy, ResultSink<char32_t>& result)
+{
+    return !src || convertOnto<char32_t>(src, srcLength, ucs4Length(src, srcLength), toUcs4, policy, result);
+}
+
+bool toUcs4Onto(const char16_t* src, size_t srcLength, ConvertPolicy policy, ResultSink<char32_t>& result)
+{
+    return !src || convertOnto<char32_t>(src, srcLength, ucs4Length(src, srcLength), toUcs4, policy, result);
+}
+
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Public Functions
 
@@ -337,12 +687,12 @@ utf8String getUnicodeVersionSupported()
 
 bool isUtf8(const std::string& test, RangeType targetRange, const EncodingCheckPredicate& pred)
 {
-    return isUtf8(test.c_str(), 0, targetRange, pred);
+    return isUtf8(test.c_str(), 0u, targetRange, pred);
 }
 
 bool isUtf8(const char* test, RangeType targetRange, const EncodingCheckPredicate& pred)
 {
-    return isUtf8(test, 0, targetRange, pred);
+    return isUtf8(test, 0u, targetRange, pred);
 }
 
 bool isUtf8(const char* test, unsigned int testLength, const EncodingCheckPredicate& pred)
@@ -350,101 +700,389 @@ bool isUtf8(const char* test, unsigned int testLength, const EncodingCheckPredic
     return isUtf8(test, testLength, kUtf8, pred);
 }
 
-//////////////////// Is it (valid) UTF-16, compatible with this encoding?
+bool isUtf8(const char* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    // a whole run is one chunk, and a sequence it cuts short is let go
+    return Utf8Validator(targetRange, pred).feed(test, testLength);
+}
 
-bool isUtf16(const utf16String& test, RangeType targetRange, const EncodingCheckPredicate& pred)
+ValidationResult validateUtf8(const char* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
 {
-    return isUtf16(test.c_str(), targetRange, pred);
+    Utf8Validator v(targetRange, pred);
+    v.feed(test, testLength);
+    return v.result();
 }
 
-bool isUtf16(const char16_t* test, RangeType targetRange, const EncodingCheckPredicate& pred)
+//////////// Is it (valid) UTF-8, a chunk at a time?
+
+const size_t Utf8Validator::kLongestCarry;
+
+Utf8Validator::Utf8Validator(RangeType targetRange, const EncodingCheckPredicate& pred)
+    : m_targetRange(targetRange)
+    , m_pred(pred)
+    , m_isNullPred(pred == EncodingCheckPredicate())
+    , m_error(targetRange < kAscii || targetRange > kUnicode ? kValidationOutOfRange : kValidationOk)
+    , m_errorOffset(0)
+    , m_fed(0)
+    , m_state(utf8dfa::kAccept)
+    , m_bits(0)
+    , m_carry()
+    , m_carryLength(0)
 {
-    if (targetRange < kAscii || targetRange > kUnicode)
+}
+
+bool Utf8Validator::feed(const char* chunk, size_t chunkLength)
+{
+    if (m_error != kValidationOk)
     {
         return false;
     }
-    if (!test || !*test)
+    if (!chunk || chunkLength == 0)
     {
         return true;
     }
 
-    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
-    bool isNullPred = pred == EncodingCheckPredicate();
-    
-    for (auto p = test; *p; ++p)
+    auto p = chunk;
+    auto end = chunk + chunkLength;
+
+    // first, the rest of any sequence the last chunk cut short
+    if (m_state != utf8dfa::kAccept)
     {
-        RangeTypeFlags rangeFlag = getRangeFlag(*p);
-        if ((rangeFlag & restrictToThis) == 0)
+        auto state = static_cast<utf8dfa::DecodeState>(m_state);
+        auto bits = m_bits;
+        while (state > utf8dfa::kReject && p < end)
         {
-            return false;
+            state = utf8dfa::step(state, static_cast<uint8_t>(*p++), bits);
         }
-        auto c = *p;
-        RangeTypeFlags charFlag;
-        /* Never hit, 2nd half UTF16 is invalid range
-        if (isSecondHalfUtf16(c))
+        if (state > utf8dfa::kReject)
         {
-            return false;
-        } */
-        if (isFirstHalfUtf16(c))
+            // still not all there
+            copy(chunk, end, m_carry + m_carryLength);
+            m_carryLength += chunkLength;
+            m_fed += chunkLength;
+            m_state = state;
+            m_bits = bits;
+            return true;
+        }
+        m_state = utf8dfa::kAccept;
+        auto q = p;
+        auto c = utf8dfa::finish(state, bits, q);
+        auto lead = m_fed - m_carryLength;
+        if (q == nullptr)
         {
-            char16_t c1 = *++p; if (c1 == 0) { break; }
-            if (!isSecondHalfUtf16(c1))
+            // all the bytes of it, to see what went wrong
+            char joined[kLongestCarry * 2];
+            auto taken = min(chunkLength, kLongestCarry);
+            copy(m_carry, m_carry + m_carryLength, joined);
+            copy(chunk, chunk + taken, joined + m_carryLength);
+            return fail(lead, whyRefused(joined, joined + m_carryLength + taken));
+        }
+        auto error = check(c);
+        if (error != kValidationOk)
+        {
+            return fail(lead, error);
+        }
+    }
+
+    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[m_targetRange];
+    auto highestByte = rangeTypeToHighestByte[m_targetRange];
+    auto resumeFastAt = m_isNullPred ? p : end;
+
+    for (; p < end; ++p)
+    {
+        // with no null to stop at, the vector kernels may run to the end
+        if (p >= resumeFastAt)
+        {
+            p += validUtf8Prefix(p, static_cast<size_t>(end - p), highestByte);
+            if (p == end)
             {
-                return false;
+                break;
             }
-            // Could make this function call but it is unnecessary
-            // charFlag = getCharEncodableRangeFlags(rawDecodeUtf16(c, c1));
-            charFlag = k21BitUnicodeFlags;
+            resumeFastAt = p + kScalarResyncLength;
         }
-        else
+
+        auto lead = p;
+        auto rangeFlag = getRangeFlag(*p);
+        if ((rangeFlag & restrictToThis) == 0)
         {
-            charFlag = getCharEncodableRangeFlags(c);
+            // the lead alone says it can't fit (when it can start anything)
+            return fail(m_fed + static_cast<size_t>(lead - chunk),
+                        rangeFlag == kInvalidRangeFlag ? kValidationMalformed : kValidationOutOfRange);
         }
-        if ((charFlag & restrictToThis) == 0 || (!isNullPred && !pred(c)))
+        auto c = utf8dfa::decode(p, end);
+        if (p == nullptr)
         {
-            return false;
+            return fail(m_fed + static_cast<size_t>(lead - chunk), whyRefused(lead, end));
+        }
+        if (p == end)
+        {
+            // cut short by the end of the chunk, otherwise fine so far
+            m_fed += chunkLength;
+            return carry(lead, end);
+        }
+        auto error = check(c);
+        if (error != kValidationOk)
+        {
+            return fail(m_fed + static_cast<size_t>(lead - chunk), error);
         }
     }
 
+    m_fed += chunkLength;
     return true;
 }
 
-//////////////////// Is it (valid) UCS-2, compatible with this encoding?
-
-bool isUcs2(const ucs2String& test, RangeType targetRange, const EncodingCheckPredicate& pred)
+bool Utf8Validator::finish() const
 {
-    return isUcs2(test.c_str(), targetRange, pred);
+    return m_error == kValidationOk && m_state == utf8dfa::kAccept;
 }
 
-bool isUcs2(const char16_t* test, RangeType targetRange, const EncodingCheckPredicate& pred)
+ValidationResult Utf8Validator::result() const
 {
-    if (targetRange < kAscii || targetRange > kUnicode)
-    {
-        return false;
-    }
-    if (!test || !*test)
+    ValidationResult r = { false, m_errorOffset, m_error };
+    if (m_error == kValidationOk)
     {
-        return true;
+        if (m_state != utf8dfa::kAccept)
+        {
+            r.offset = m_fed - m_carryLength;
+            r.error = kValidationTruncated;
+        }
+        else
+        {
+            r.valid = true;
+            r.offset = m_fed;
+        }
+    }
+    return r;
+}
+
+void Utf8Validator::reset()
+{
+    m_error = m_targetRange < kAscii || m_targetRange > kUnicode ? kValidationOutOfRange : kValidationOk;
+    m_errorOffset = 0;
+    m_fed = 0;
+    m_state = utf8dfa::kAccept;
+    m_bits = 0;
+    m_carryLength = 0;
+}
+
+//=========================================================================
+// Note the first error found; nothing fed after it matters.
+//
+// Returns false, for feed to pass on.
+
+bool Utf8Validator::fail
+(
+    size_t              offset, // I - where the bad character starts
+    ValidationError     error   // I - what's wrong with it
+)
+{
+    m_error = error;
+    m_errorOffset = offset;
+    m_state = utf8dfa::kAccept;
+    return false;
+}
+
+//=========================================================================
+// Keep the state of a sequence running from lead to the end of a chunk (at
+// most 5 bytes, so just decode them again) for the next chunk to finish,
+// and the bytes themselves in case it doesn't.
+//
+// Returns true, as nothing wrong has been seen yet.
+
+bool Utf8Validator::carry
+(
+    const char*         lead,   // I - the first byte of the sequence
+    const char*         end     // I - one past the last byte of the chunk
+)
+{
+    uint32_t bits;
+    auto state = utf8dfa::start(static_cast<uint8_t>(*lead), bits);
+    for (auto p = lead + 1; p < end; ++p)
+    {
+        state = utf8dfa::step(state, static_cast<uint8_t>(*p), bits);
+    }
+    m_state = state;
+    m_bits = bits;
+    m_carryLength = static_cast<size_t>(end - lead);
+    copy(lead, end, m_carry);
+    return true;
+}
+
+//=========================================================================
+// Does a decoded character fit the target range and pass the predicate?
+//
+// Returns kValidationOk if so, what it fails otherwise.
+
+ValidationError Utf8Validator::check
+(
+    char32_t            c       // I - the character
+) const
+{
+    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[m_targetRange];
+    if ((getCharEncodableRangeFlags(c) & restrictToThis) == 0)
+    {
+        return kValidationOutOfRange;
+    }
+    return m_isNullPred || m_pred(c) ? kValidationOk : kValidationPredicate;
+}
+
+//////////////////// Is it (valid) UTF-16, compatible with this encoding?
+
+bool isUtf16(const utf16String& test, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isUtf16(test.c_str(), targetRange, pred);
+}
+
+bool isUtf16(const char16_t* test, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isUtf16(test, nullTerminatedLength(test), targetRange, pred);
+}
+
+bool isUtf16(const char16_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    // a first half cut off by the end of the run is let go
+    auto r = validateUtf16(test, testLength, targetRange, pred);
+    return r.valid || r.error == kValidationTruncated;
+}
+
+ValidationResult validateUtf16(const char16_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    ValidationResult result = { false, 0, kValidationOutOfRange };
+    if (targetRange < kAscii || targetRange > kUnicode)
+    {
+        return result;
+    }
+    if (!test || testLength == 0)
+    {
+        result.valid = true;
+        result.error = kValidationOk;
+        return result;
     }
 
     RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
     bool isNullPred = pred == EncodingCheckPredicate();
-    
-    for (auto p = test; *p; ++p)
+    auto end = test + testLength;
+
+    // with nothing to ask of each character, well-formed runs are all in
+    // range unless the target is ASCII or UCS-2
+    auto resumeFastAt = !isNullPred || targetRange == kAscii || targetRange == kUcs2 ? end : test;
+
+    for (auto p = test; p < end; ++p)
+    {
+        if (p >= resumeFastAt)
+        {
+            p += validUtf16Prefix(p, static_cast<size_t>(end - p), 0);
+            if (p == end)
+            {
+                break;
+            }
+            resumeFastAt = p + kScalarResyncLength;
+        }
+
+        RangeTypeFlags rangeFlag = getRangeFlag(*p);
+        if ((rangeFlag & restrictToThis) == 0)
+        {
+            // a lone second half is no character at all
+            result.offset = static_cast<size_t>(p - test);
+            result.error = isSecondHalfUtf16(*p) ? kValidationSurrogate : kValidationOutOfRange;
+            return result;
+        }
+        auto c = *p;
+        RangeTypeFlags charFlag;
+        if (isFirstHalfUtf16(c))
+        {
+            if (++p == end)
+            {
+                result.offset = testLength - 1;
+                result.error = kValidationTruncated;
+                return result;
+            }
+            char16_t c1 = *p;
+            if (!isSecondHalfUtf16(c1))
+            {
+                result.offset = static_cast<size_t>(p - test) - 1;
+                result.error = kValidationSurrogate;
+                return result;
+            }
+            // Could make this function call but it is unnecessary
+            // charFlag = getCharEncodableRangeFlags(rawDecodeUtf16(c, c1));
+            charFlag = k21BitUnicodeFlags;
+        }
+        else
+        {
+            charFlag = getCharEncodableRangeFlags(c);
+        }
+        if ((charFlag & restrictToThis) == 0 || (!isNullPred && !pred(c)))
+        {
+            result.offset = static_cast<size_t>(p - test) - (isFirstHalfUtf16(c) ? 1 : 0);
+            result.error = (charFlag & restrictToThis) == 0 ? kValidationOutOfRange : kValidationPredicate;
+            return result;
+        }
+    }
+
+    result.valid = true;
+    result.offset = testLength;
+    result.error = kValidationOk;
+    return result;
+}
+
+//////////////////// Is it (valid) UCS-2, compatible with this encoding?
+
+bool isUcs2(const ucs2String& test, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isUcs2(test.c_str(), targetRange, pred);
+}
+
+bool isUcs2(const char16_t* test, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isUcs2(test, nullTerminatedLength(test), targetRange, pred);
+}
+
+bool isUcs2(const char16_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return validateUcs2(test, testLength, targetRange, pred).valid;
+}
+
+ValidationResult validateUcs2(const char16_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    ValidationResult result = { false, 0, kValidationOutOfRange };
+    if (targetRange < kAscii || targetRange > kUnicode)
+    {
+        return result;
+    }
+    if (!test || testLength == 0)
+    {
+        result.valid = true;
+        result.error = kValidationOk;
+        return result;
+    }
+
+    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
+    bool isNullPred = pred == EncodingCheckPredicate();
+    auto end = test + testLength;
+
+    for (auto p = test; p < end; ++p)
     {
         auto c = *p;
         RangeTypeFlags charFlag = getCharEncodableRangeFlags(c);
         if (isUtf16EscapedRange(c))
         {
-            return false;
+            result.offset = static_cast<size_t>(p - test);
+            result.error = kValidationSurrogate;
+            return result;
         }
         if ((charFlag & restrictToThis) == 0 || (!isNullPred && !pred(c)))
         {
-            return false;
+            result.offset = static_cast<size_t>(p - test);
+            result.error = (charFlag & restrictToThis) == 0 ? kValidationOutOfRange : kValidationPredicate;
+            return result;
         }
     }
 
-    return true;
+    result.valid = true;
+    result.offset = testLength;
+    result.error = kValidationOk;
+    return result;
 }
 
 //////////////////// Is it (valid) UCS-4, compatible with this encoding?
@@ -456,285 +1094,193 @@ bool isUcs4(const ucs4String& test, RangeType targetRange, const EncodingCheckPr
 
 bool isUcs4(const char32_t* test, RangeType targetRange, const EncodingCheckPredicate& pred)
 {
+    return isUcs4(test, nullTerminatedLength(test), targetRange, pred);
+}
+
+bool isUcs4(const char32_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return validateUcs4(test, testLength, targetRange, pred).valid;
+}
+
+ValidationResult validateUcs4(const char32_t* test, size_t testLength, RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    ValidationResult result = { false, 0, kValidationOutOfRange };
     if (targetRange < kAscii || targetRange > kUnicode)
     {
-        return false;
+        return result;
     }
-    if (!test || !*test)
+    if (!test || testLength == 0)
     {
-        return true;
+        result.valid = true;
+        result.error = kValidationOk;
+        return result;
     }
 
     RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
     bool isNullPred = pred == EncodingCheckPredicate();
-    
-    for (auto p = test; *p; ++p)
+    auto end = test + testLength;
+
+    for (auto p = test; p < end; ++p)
     {
         auto c = *p;
-        if ((getCharEncodableRangeFlags(c) & restrictToThis) == 0 || (!isNullPred && !pred(c)))
+        auto charFlag = getCharEncodableRangeFlags(c);
+        if ((charFlag & restrictToThis) == 0 || (!isNullPred && !pred(c)))
         {
-            return false;
+            result.offset = static_cast<size_t>(p - test);
+            result.error = (charFlag & restrictToThis) != 0 ? kValidationPredicate :
+                           isUtf16EscapedRange(c) ? kValidationSurrogate : kValidationOutOfRange;
+            return result;
         }
     }
 
-    return true;
+    result.valid = true;
+    result.offset = testLength;
+    result.error = kValidationOk;
+    return result;
 }
 
 //////////////////// Convert to UTF-8
 
 // From UCS-2 or UTF-16 //////////////////////////////////
 
-string toUtf8(const char16_t* src)
+string toUtf8(const char16_t* src, ConvertPolicy policy)
 {
-    string result;
-    if (src && *src)
-    {
-        CharacterAdder<char> adder(result);
-        for (auto p = src; *p; ++p)
-        {
-            auto c = *p;
-            if (isFirstHalfUtf16(c))
-            {
-                char16_t c1 = *++p; if (c1 == 0) { break; }
-                if (!isSecondHalfUtf16(c1))
-                {
-                    return string();
-                }
-                char32_t c32 = rawDecodeUtf16(c, c1);
-                encodeUtf8(c32, adder);
-            }
-            else
-            {
-                encodeUtf8(c, adder);
-            }
-        }
-    }
+    return toUtf8(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+string toUtf8(const utf16String& src, ConvertPolicy policy)
+{
+    return toUtf8(src.c_str(), policy);
 }
 
-string toUtf8(const utf16String& src)
+string toUtf8(const char16_t* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUtf8(src.c_str());
+    return convertWhole<char>(src, srcLength, utf8Length(src, srcLength), toUtf8, policy);
 }
 
 // From UCS-4 ////////////////////////////////////////////
 
-string toUtf8(const char32_t* src)
+string toUtf8(const char32_t* src, ConvertPolicy policy)
 {
-    string result;
-    if (src && *src)
-    {
-        CharacterAdder<char> adder(result);
-        for (auto p = src; *p; ++p)
-        {
-            auto c = *p;
-            if ((c & 0x80000000) == 0 && !isFirstHalfUtf16(c) && !isSecondHalfUtf16(c))
-            {
-                encodeUtf8(c, adder);
-            }
-            else
-            {
-                return string();
-            }
-        }
-    }
+    return toUtf8(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+string toUtf8(const ucs4String& src, ConvertPolicy policy)
+{
+    return toUtf8(src.c_str(), policy);
 }
 
-string toUtf8(const ucs4String& src)
+string toUtf8(const char32_t* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUtf8(src.c_str());
+    return convertWhole<char>(src, srcLength, utf8Length(src, srcLength), toUtf8, policy);
 }
 
 //////////////////// Convert to UCS-2
 
 // From char or UTF-8 ////////////////////////////////////
 
-ucs2String toUcs2(const char* src)
+ucs2String toUcs2(const char* src, ConvertPolicy policy)
 {
-    ucs2String result;
-    if (src && *src)
-    {
-        for (auto p = src; *p; ++p)
-        {
-            auto c = decodeUtf8(p);
-            if (p == nullptr || c > 0xffff)
-            {
-                return ucs2String();
-            }
-            else if (c == 0)
-            {
-                break;
-            }
-            result.push_back(static_cast<char16_t>(c));
-        }
-    }
+    return toUcs2(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+ucs2String toUcs2(const string& src, ConvertPolicy policy)
+{
+    return toUcs2(src.c_str(), policy);
 }
 
-ucs2String toUcs2(const string& src)
+ucs2String toUcs2(const char* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUcs2(src.c_str());
+    return convertWhole<char16_t>(src, srcLength, ucs4Length(src, srcLength), toUcs2, policy);
 }
 
 // From UCS-4 ////////////////////////////////////////////
 
-ucs2String toUcs2(const char32_t* src)
+ucs2String toUcs2(const char32_t* src, ConvertPolicy policy)
 {
-    ucs2String result;
-    if (src && *src)
-    {
-        for (auto p = src; *p; ++p)
-        {
-            if (isFirstHalfUtf16(*p) || isSecondHalfUtf16(*p) || *p >= 0x10000)
-            {
-                return ucs2String();
-            }
-            result.push_back(static_cast<char16_t>(*p));
-        }
-    }
+    return toUcs2(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+ucs2String toUcs2(const ucs4String& src, ConvertPolicy policy)
+{
+    return toUcs2(src.c_str(), policy);
 }
 
-ucs2String toUcs2(const ucs4String& src)
+ucs2String toUcs2(const char32_t* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUcs2(src.c_str());
+    return convertWhole<char16_t>(src, srcLength, srcLength, toUcs2, policy);
 }
 
 //////////////////// Convert to UTF-16
 
 // From char or UTF-8 ////////////////////////////////////
 
-utf16String toUtf16(const char* src)
+utf16String toUtf16(const char* src, ConvertPolicy policy)
 {
-    utf16String result;
-    if (src && *src)
-    {
-        CharacterAdder<char16_t> adder(result);
-        for (auto p = src; *p; ++p)
-        {
-            auto c = decodeUtf8(p);
-            if (p == nullptr || !isUtf16Encodable(c))
-            {
-                return utf16String();
-            }
-            else if (c == 0)
-            {
-                break;
-            }
-            rawEncodeUtf16(c, adder);
-        }
-    }
+    return toUtf16(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+utf16String toUtf16(const string& src, ConvertPolicy policy)
+{
+    return toUtf16(src.c_str(), policy);
 }
 
-utf16String toUtf16(const string& src)
+utf16String toUtf16(const char* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUtf16(src.c_str());
+    return convertWhole<char16_t>(src, srcLength, utf16Length(src, srcLength), toUtf16, policy);
 }
 
 // From UCS-4 ////////////////////////////////////////////
 
-utf16String toUtf16(const char32_t* src)
+utf16String toUtf16(const char32_t* src, ConvertPolicy policy)
 {
-    utf16String result;
-    if (src && *src)
-    {
-        CharacterAdder<char16_t> adder(result);
-        for (auto p = src; *p; ++p)
-        {
-            auto c = *p;
-            if (p == nullptr || !isUtf16Encodable(c) ||
-                isFirstHalfUtf16(c) || isSecondHalfUtf16(c))
-            {
-                return utf16String();
-            }
-            rawEncodeUtf16(c, adder);
-        }
-    }
+    return toUtf16(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+utf16String toUtf16(const ucs4String& src, ConvertPolicy policy)
+{
+    return toUtf16(src.c_str(), policy);
 }
 
-utf16String toUtf16(const ucs4String& src)
+utf16String toUtf16(const char32_t* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUtf16(src.c_str());
+    return convertWhole<char16_t>(src, srcLength, utf16Length(src, srcLength), toUtf16, policy);
 }
 
 //////////////////// Convert to UCS-4
 
 // From char or UTF-8 ////////////////////////////////////
 
-ucs4String toUcs4(const char* src)
+ucs4String toUcs4(const char* src, ConvertPolicy policy)
 {
-    ucs4String result;
-    if (src && *src)
-    {
-        for (auto p = src; *p; ++p)
-        {
-            auto c = decodeUtf8(p);
-            if (p == nullptr)
-            {
-                return ucs4String();
-            }
-            else if (c == 0)
-            {
-                break;
-            }
-            result.push_back(c);
-        }
-    }
+    return toUcs4(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+ucs4String toUcs4(const string& src, ConvertPolicy policy)
+{
+    return toUcs4(src.c_str(), policy);
 }
 
-ucs4String toUcs4(const string& src)
+ucs4String toUcs4(const char* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUcs4(src.c_str());
+    return convertWhole<char32_t>(src, srcLength, ucs4Length(src, srcLength), toUcs4, policy);
 }
 
 // From UCS-2 or UTF-16 //////////////////////////////////
 
-ucs4String toUcs4(const char16_t* src)
+ucs4String toUcs4(const char16_t* src, ConvertPolicy policy)
 {
-    ucs4String result;
-    if (src && *src)
-    {
-        for (auto p = src; *p; ++p)
-        {
-            auto c = *p;
-            if (isFirstHalfUtf16(c))
-            {
-                char16_t c1 = *++p; if (c1 == 0) { break; }
-                if (!isSecondHalfUtf16(c1))
-                {
-                    return ucs4String();
-                }
-                char32_t c32 = rawDecodeUtf16(c, c1);
-                result.push_back(c32);
-            }
-            else if (isSecondHalfUtf16(c))
-            {
-                return ucs4String();
-            }
-            else
-            {
-                result.push_back(c);
-            }
-        }
-    }
+    return toUcs4(src, nullTerminatedLength(src), policy);
+}
 
-    return result;
+ucs4String toUcs4(const utf16String& src, ConvertPolicy policy)
+{
+    return toUcs4(src.c_str(), policy);
 }
 
-ucs4String toUcs4(const utf16String& src)
+ucs4String toUcs4(const char16_t* src, size_t srcLength, ConvertPolicy policy)
 {
-    return toUcs4(src.c_str());
+    return convertWhole<char32_t>(src, srcLength, ucs4Length(src, srcLength), toUcs4, policy);
 }
 
 //////////////////// Test Unicode Length
@@ -762,8 +1308,47 @@ unsigned int unicodeLength(const char* src, unsigned int testLength)
     unsigned int r = 0;
     RangeTypeFlags restrictToUnicode = rangeTypeToRangeFlag[kUnicode];
 
+    const char* fastEnd;
+    if (lengthTerminated)
+    {
+        auto nul = static_cast<const char*>(memchr(src, 0, testLength));
+        fastEnd = nul != nullptr ? nul : src + testLength;
+    }
+    else
+    {
+        fastEnd = src + strlen(src);
+    }
+
+    auto resumeFastAt = src;
     for (auto p = src; *p; ++p, ++r)
     {
+        // the vector kernels vouch for runs of well-formed UTF-8 short of any
+        // null, and count them; the loop below goes on from where they stop
+        if (p >= resumeFastAt && p < fastEnd)
+        {
+            // (7-bit text needs no counting, so it's taken first)
+            auto ascii = asciiPrefix(p, static_cast<size_t>(fastEnd - p));
+            auto skipped = ascii + validUtf8Prefix(p + ascii, static_cast<size_t>(fastEnd - p) - ascii, 0xff);
+            if (skipped != 0)
+            {
+                r += static_cast<unsigned int>(ascii + leadCount(p + ascii, skipped - ascii));
+                p += skipped;
+                if (lengthTerminated)
+                {
+                    if (lengthLeft <= skipped)
+                    {
+                        return r;
+                    }
+                    lengthLeft -= static_cast<unsigned int>(skipped);
+                    pLast = p - 1;
+                }
+                if (!*p)
+                {
+                    break;
+                }
+            }
+            resumeFastAt = p + kScalarResyncLength;
+        }
         // if we won't have enough length-terminted buffer left to satisfy this
         // sequence, quit, now
         if (lengthTerminated)
@@ -793,7 +1378,7 @@ unsigned int unicodeLength(const char* src, unsigned int testLength)
         // GUARANTEE: if lengthTerminated, lengthLeft >= to-be-usedThisTime
 
         // decode a character
-        auto c = decodeUtf8(p);
+        auto c = utf8dfa::decode(p);
 
         // how did decoding go?
         if (p == nullptr || (restrictToUnicode & getCharEncodableRangeFlags(c)) == 0 )
@@ -835,83 +1420,120 @@ unsigned int unicodeLength(const char* src, unsigned int testLength)
     return lengthTerminated ? 0 : r;
 }
 
+size_t unicodeLength(const char* src, size_t srcLength, RangeType targetRange)
+{
+    if (targetRange < kAscii || targetRange > kUnicode || !src)
+    {
+        return 0;
+    }
+
+    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
+    auto highestByte = rangeTypeToHighestByte[targetRange];
+    auto end = src + srcLength;
+    auto resumeFastAt = src;
+    size_t r = 0;
+
+    for (auto p = src; p < end; ++p, ++r)
+    {
+        // well-formed runs are checked and counted by the vector kernels;
+        // 7-bit text needs no counting, so it's taken first
+        if (p >= resumeFastAt)
+        {
+            auto ascii = asciiPrefix(p, static_cast<size_t>(end - p));
+            auto skipped = ascii + validUtf8Prefix(p + ascii, static_cast<size_t>(end - p) - ascii, highestByte);
+            r += ascii + leadCount(p + ascii, skipped - ascii);
+            p += skipped;
+            if (p == end)
+            {
+                break;
+            }
+            resumeFastAt = p + kScalarResyncLength;
+        }
+
+        auto c = utf8dfa::decode(p, end);
+        if (p == nullptr || (restrictToThis & getCharEncodableRangeFlags(c)) == 0)
+        {
+            return 0;
+        }
+        if (p == end)
+        {
+            // cut short by the end of the run
+            return 0;
+        }
+    }
+
+    return r;
+}
+
 //////////////////// Test Unicode Length
 
 // From UCS-2/UTF-16 /////////////////////////////////////
 
 unsigned int unicodeLength(const utf16String& src)
 {
-    return unicodeLength(src.c_str());
+    // the kernels stop at a null themselves, so there's no need to find it
+    return terminatedUnicodeLength(src.c_str(), 0, src.size());
 }
 
 unsigned int unicodeLength(const char16_t* src, unsigned int testLength)
 {
-    // some behaviour is changed if the scan is length terminated
-    bool lengthTerminated = testLength != 0;
-
-    auto lengthLeft = testLength;
-    auto pLast = src - 1;
-    unsigned int usedThisTime = 0;
-    unsigned int r = 0;
+    if (!src)
+    {
+        return 0;
+    }
+    return terminatedUnicodeLength(src, testLength, testLength != 0 ? testLength : nullTerminatedLength(src));
+}
 
-    for (auto p = src; *p; ++p, ++r)
+size_t unicodeLength(const char16_t* src, size_t srcLength, RangeType targetRange)
+{
+    if (targetRange < kAscii || targetRange > kUnicode || !src)
     {
-        // fetch the current character -- is it invalid UTF-16
-        auto c = *p;
-        if (isSecondHalfUtf16(c))
-        {
-            return 0;
-        }
+        return 0;
+    }
 
-        // is this the first of two parts?
-        bool isFirstHalf = isFirstHalfUtf16(c);
-        unsigned int wordsNeeded = isFirstHalf ? 2 : 1;
+    RangeTypeFlags restrictToThis = rangeTypeToRangeFlag[targetRange];
+    auto end = src + srcLength;
+    size_t r = 0;
 
-        // have we got another half to deal with it?
-        if (lengthTerminated && wordsNeeded > lengthLeft)
-        {
-            return r;
-        }
+    // well-formed UTF-16 is all in range unless the target is ASCII or UCS-2
+    auto resumeFastAt = targetRange == kAscii || targetRange == kUcs2 ? end : src;
 
-        // or if null terminated, is there another piece?
-        auto c1 = p[1];
-        if (isFirstHalf && c1 == 0)
+    for (auto p = src; p < end; ++p, ++r)
+    {
+        if (p >= resumeFastAt)
         {
-            return r - 1;
+            auto skipped = validUtf16Prefix(p, static_cast<size_t>(end - p), 0);
+            r += leadCount(p, skipped);
+            p += skipped;
+            if (p == end)
+            {
+                break;
+            }
+            resumeFastAt = p + kScalarResyncLength;
         }
 
-        // and if in two pieces, is it valid?
-        bool isTwoHalves = isFirstHalf && isSecondHalfUtf16(c1);
-
-        if (isTwoHalves)
-        {
-            // ah, okay -- advance the pointer an extra bit
-            ++p;
-        }
-        else if (isFirstHalf)
+        auto c = *p;
+        char32_t c32 = c;
+        if (isSecondHalfUtf16(c))
         {
-            // not so good! encoding error...
             return 0;
         }
-
-        // decoded -- how much was used?
-        if (lengthTerminated)
-        {
-            usedThisTime = static_cast<unsigned int>(p - pLast);
-            pLast = p;
-        }
-
-        if (lengthTerminated)
+        if (isFirstHalfUtf16(c))
         {
-            if (lengthLeft == usedThisTime)
+            if (++p == end) { return 0; }
+            if (!isSecondHalfUtf16(*p))
             {
-                return r + 1;
+                return 0;
             }
-            lengthLeft -= usedThisTime;
+            c32 = rawDecodeUtf16(c, *p);
+        }
+        if ((restrictToThis & getCharEncodableRangeFlags(c32)) == 0)
+        {
+            return 0;
         }
     }
 
-    return lengthTerminated ? 0 : r;
+    return r;
 }
 
 //////////////////// Test Unicode Length
@@ -920,29 +1542,69 @@ unsigned int unicodeLength(const char16_t* src, unsigned int testLength)
 
 unsigned int unicodeLength(const ucs4String& src)
 {
-    return unicodeLength(src.c_str());
+    // up to the first null, as for a pointer, found in the same pass
+    auto length = inRangeUcs4Prefix(src.data(), src.size(), 1, 0xffffffff);
+    return length == src.size() || src[length] == 0 ? static_cast<unsigned int>(length) : 0;
 }
 
 unsigned int unicodeLength(const char32_t* src, unsigned int testLength)
 {
-    // some behaviour is changed if the scan is length terminated
-    bool lengthTerminated = testLength != 0;
+    if (!src)
+    {
+        return 0;
+    }
+
+    // In UCS-4, UTF-16 escape pairs are not allowed; length terminated, a
+    // null before testLength isn't either
+    if (testLength != 0)
+    {
+        return inRangeUcs4Prefix(src, testLength, 1, 0xffffffff) == testLength ? testLength : 0;
+    }
 
     unsigned int r = 0;
     for (auto p = src; *p; ++p, ++r)
     {
-        // In UCS-4, UTF-16 escape pairs are not allowed
         if (isFirstHalfUtf16(*p) || isSecondHalfUtf16(*p))
         {
             return 0;
         }
-        if (lengthTerminated && p + 1 == src + testLength)
-        {
-            return r + 1;
-        }
     }
 
-    return lengthTerminated ? 0 : r;
+    return r;
+}
+
+
+size_t unicodeLength(const char32_t* src, size_t srcLength, RangeType targetRange)
+{
+    if (targetRange < kAscii || targetRange > kUnicode || !src)
+    {
+        return 0;
+    }
+
+    // In UCS-4, UTF-16 escape pairs are not allowed; they fail every range
+    if (inRangeUcs4Prefix(src, srcLength, 0, rangeTypeToLastChar[targetRange]) != srcLength)
+    {
+        return 0;
+    }
+
+    return srcLength;
+}
+
+//////////////////// Unicode Length, unchecked
+
+size_t unicodeLengthUnchecked(const char* src, size_t srcLength)
+{
+    return src ? ucs4Length(src, srcLength) : 0;
+}
+
+size_t unicodeLengthUnchecked(const char16_t* src, size_t srcLength)
+{
+    return src ? leadCount(src, srcLength) : 0;
+}
+
+size_t unicodeLengthUnchecked(const char32_t* src, size_t srcLength)
+{
+    return src ? srcLength : 0;
 }
 
 }
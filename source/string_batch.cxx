@@ -0,0 +1,390 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_batch.cxx -- convert and lower-case many short strings at once,
+//                     packed together so that the vector kernels see long
+//                     runs, into one arena.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string.hxx"
+#include "string_internal.hxx"
+#include "string_simd.hxx"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ansak::internal;
+
+namespace ansak {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Units packed together to be converted in one pass: enough for the
+// vector kernels to run long, few enough to stay in cache
+
+const size_t kBatchPackLength = 16 * 1024;
+
+//=========================================================================
+// Does a source start on a character -- not on a continuation byte, the
+// second half of a CESU-8 pair or the second half of a UTF-16 pair? Packed
+// after another source, one that doesn't might join with its end.
+//
+// Returns true if it does, or is empty.
+
+bool startsCharacter(const char* src, size_t srcLength)
+{
+    if (srcLength == 0)
+    {
+        return true;
+    }
+    auto lead = static_cast<unsigned char>(src[0]);
+    return (lead & 0xc0) != 0x80 &&
+           !(lead == 0xed && srcLength > 1 && (static_cast<unsigned char>(src[1]) & 0xf0) >= 0xb0);
+}
+
+bool startsCharacter(const char16_t* src, size_t srcLength)
+{
+    return srcLength == 0 || !isSecondHalfUtf16(src[0]);
+}
+
+bool startsCharacter(const char32_t*, size_t)
+{
+    return true;
+}
+
+//=========================================================================
+// Is a unit of a well-formed result the first of a character?
+
+inline bool isLead(char c) { return (c & 0xc0) != 0x80; }
+inline bool isLead(char16_t c) { return !isSecondHalfUtf16(c); }
+inline bool isLead(char32_t) { return true; }
+
+//=========================================================================
+// Characters in n units of a well-formed source, as toLower counts them (a
+// CESU-8 pair is one)
+
+size_t characterCount(const char* p, size_t n) { return ucs4Length(p, n); }
+size_t characterCount(const char16_t* p, size_t n) { return ucs4Length(p, n); }
+size_t characterCount(const char32_t*, size_t n) { return n; }
+
+//=========================================================================
+// A source's length, none if it has no data
+
+template<typename S>
+size_t spanLength(const StringSpan<S>& src)
+{
+    return src.data ? src.length : 0;
+}
+
+//=========================================================================
+// Gather sources from first on (one at least, more while they fit in
+// kBatchPackLength units) into packed, unless there is only one to take,
+// when it stays where it is.
+//
+// Returns one past the last source taken; pack and packLength give the
+// units to convert, and joinable whether each source starts on a character.
+
+template<typename S>
+size_t packSources
+(
+    const StringSpan<S>*    srcs,       // I - the sources
+    size_t                  first,      // I - the first one to take
+    size_t                  count,      // I - how many there are
+    std::basic_string<S>&   packed,     // O - where they are packed
+    const S*&               pack,       // O - the units to convert
+    size_t&                 packLength, // O - ... and how many there are
+    bool&                   joinable    // O - does every source start a character?
+)
+{
+    joinable = true;
+    packLength = 0;
+    auto last = first;
+    for (; last < count; ++last)
+    {
+        auto length = spanLength(srcs[last]);
+        if (last != first && packLength + length > kBatchPackLength)
+        {
+            break;
+        }
+        packLength += length;
+        joinable = joinable && startsCharacter(srcs[last].data, length);
+    }
+
+    if (last == first + 1)
+    {
+        pack = srcs[first].data;
+        return last;
+    }
+    packed.clear();
+    packed.reserve(packLength);
+    for (auto i = first; i < last; ++i)
+    {
+        packed.append(srcs[i].data ? srcs[i].data : packed.data(), spanLength(srcs[i]));
+    }
+    pack = packed.data();
+    return last;
+}
+
+//=========================================================================
+// The to<RangeType>Batch functions: each pack is converted by the strict
+// buffer converter into the exact room its sources need between them,
+// which (every source starting on a character) is where each one's result
+// starts and ends. A pack that doesn't convert whole is done again a
+// source at a time, with policy, straight onto the end of the arena.
+//
+// Returns how many sources came out empty when they weren't.
+
+template<typename S, typename D>
+size_t convertBatch
+(
+    const StringSpan<S>*    srcs,       // I - the sources
+    size_t                  count,      // I - how many there are
+    std::basic_string<D>&   arena,      // O - all of the results, in order
+    vector<size_t>&         offsets,    // O - where each starts, count + 1 of them
+    size_t                (*lengthOf)(const S*, size_t),    // I - exact length of a result
+    ConvertResult         (*convert)(const S*, size_t, D*, size_t),     // I - the buffer converter
+    bool                  (*convertOnto)(const S*, size_t, ConvertPolicy, ResultSink<D>&),  // I - ... and the other one
+    ConvertPolicy           policy      // I - what to do with bad input
+)
+{
+    arena.clear();
+    offsets.assign(1, 0);
+    offsets.reserve(count + 1);
+
+    std::basic_string<S> packed;
+    StringSink<D, std::allocator<D>> sink(arena);
+    size_t emptied = 0;
+    for (size_t first = 0; first < count; )
+    {
+        const S* pack;
+        size_t packLength;
+        bool joinable;
+        auto last = packSources(srcs, first, count, packed, pack, packLength, joinable);
+
+        auto base = arena.size();
+        if (joinable)
+        {
+            auto end = base;
+            for (auto i = first; i < last; ++i)
+            {
+                end += spanLength(srcs[i]) != 0 ? lengthOf(srcs[i].data, srcs[i].length) : 0;
+                offsets.push_back(end);
+            }
+            arena.resize(end);
+            auto r = packLength == 0 ? ConvertResult{ 0, 0, kConvertOk } :
+                                       convert(pack, packLength, &arena[base], end - base);
+            if (r.status == kConvertOk && r.produced == end - base)
+            {
+                first = last;
+                continue;
+            }
+            arena.resize(base);
+            offsets.resize(first + 1);
+        }
+
+        for (auto i = first; i < last; ++i)
+        {
+            if (spanLength(srcs[i]) != 0)
+            {
+                convertOnto(srcs[i].data, srcs[i].length, policy, sink);
+                emptied += arena.size() == offsets.back() ? 1 : 0;
+            }
+            offsets.push_back(arena.size());
+        }
+        first = last;
+    }
+    return emptied;
+}
+
+//=========================================================================
+// The toLowerBatch functions: each pack is lower-cased onto the end of the
+// arena in one pass and each source's result found there by counting off
+// as many characters as it has (lower-casing keeps them one for one). A
+// pack that doesn't lower-case whole is done again a source at a time.
+//
+// Returns how many sources came out empty when they weren't.
+
+template<typename C>
+size_t lowerBatch
+(
+    const StringSpan<C>*    srcs,       // I - the sources
+    size_t                  count,      // I - how many there are
+    std::basic_string<C>&   arena,      // O - all of the results, in order
+    vector<size_t>&         offsets,    // O - where each starts, count + 1 of them
+    const char*             lang        // I - the optional language code
+)
+{
+    arena.clear();
+    offsets.assign(1, 0);
+    offsets.reserve(count + 1);
+
+    std::basic_string<C> packed;
+    StringSink<C, std::allocator<C>> sink(arena);
+    size_t emptied = 0;
+    for (size_t first = 0; first < count; )
+    {
+        const C* pack;
+        size_t packLength;
+        bool joinable;
+        auto last = packSources(srcs, first, count, packed, pack, packLength, joinable);
+
+        auto base = arena.size();
+        if (joinable && (packLength == 0 || lowerOnto(pack, packLength, lang, sink)))
+        {
+            if (sizeof(C) == 4)
+            {
+                // one unit, one character
+                for (auto i = first; i < last; ++i)
+                {
+                    offsets.push_back(offsets.back() + spanLength(srcs[i]));
+                }
+                first = last;
+                continue;
+            }
+
+            auto q = base;
+            auto end = arena.size();
+            for (auto i = first; i < last; ++i)
+            {
+                auto characters = spanLength(srcs[i]) != 0 ? characterCount(srcs[i].data, srcs[i].length) : 0;
+                size_t seen = 0;
+                for (; q < end; ++q)
+                {
+                    if (isLead(arena[q]))
+                    {
+                        if (seen == characters)
+                        {
+                            break;
+                        }
+                        ++seen;
+                    }
+                }
+                if (seen != characters)
+                {
+                    // a character cut short at the end of the pack, left out
+                    break;
+                }
+                offsets.push_back(q);
+            }
+            if (offsets.size() == last + 1 && q == end)
+            {
+                first = last;
+                continue;
+            }
+            arena.resize(base);
+            offsets.resize(first + 1);
+        }
+
+        for (auto i = first; i < last; ++i)
+        {
+            if (spanLength(srcs[i]) != 0)
+            {
+                lowerOnto(srcs[i].data, srcs[i].length, lang, sink);
+                emptied += arena.size() == offsets.back() ? 1 : 0;
+            }
+            offsets.push_back(arena.size());
+        }
+        first = last;
+    }
+    return emptied;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Public Functions
+
+size_t toUtf8Batch(const StringSpan<char16_t>* srcs, size_t count, utf8String& arena,
+                   vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char16_t, char>(srcs, count, arena, offsets, utf8Length, toUtf8, toUtf8Onto, policy);
+}
+
+size_t toUtf8Batch(const StringSpan<char32_t>* srcs, size_t count, utf8String& arena,
+                   vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char32_t, char>(srcs, count, arena, offsets, utf8Length, toUtf8, toUtf8Onto, policy);
+}
+
+size_t toUtf16Batch(const StringSpan<char>* srcs, size_t count, utf16String& arena,
+                    vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char, char16_t>(srcs, count, arena, offsets, utf16Length, toUtf16, toUtf16Onto, policy);
+}
+
+size_t toUtf16Batch(const StringSpan<char32_t>* srcs, size_t count, utf16String& arena,
+                    vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char32_t, char16_t>(srcs, count, arena, offsets, utf16Length, toUtf16, toUtf16Onto, policy);
+}
+
+size_t toUcs4Batch(const StringSpan<char>* srcs, size_t count, ucs4String& arena,
+                   vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char, char32_t>(srcs, count, arena, offsets, ucs4Length, toUcs4, toUcs4Onto, policy);
+}
+
+size_t toUcs4Batch(const StringSpan<char16_t>* srcs, size_t count, ucs4String& arena,
+                   vector<size_t>& offsets, ConvertPolicy policy)
+{
+    return convertBatch<char16_t, char32_t>(srcs, count, arena, offsets, ucs4Length, toUcs4, toUcs4Onto, policy);
+}
+
+size_t toLowerBatch(const StringSpan<char>* srcs, size_t count, utf8String& arena,
+                    vector<size_t>& offsets, const char* lang)
+{
+    return lowerBatch(srcs, count, arena, offsets, lang);
+}
+
+size_t toLowerBatch(const StringSpan<char16_t>* srcs, size_t count, utf16String& arena,
+                    vector<size_t>& offsets, const char* lang)
+{
+    return lowerBatch(srcs, count, arena, offsets, lang);
+}
+
+size_t toLowerBatch(const StringSpan<char32_t>* srcs, size_t count, ucs4String& arena,
+                    vector<size_t>& offsets, const char* lang)
+{
+    return lowerBatch(srcs, count, arena, offsets, lang);
+}
+
+}
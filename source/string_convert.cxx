@@ -0,0 +1,741 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_convert.cxx -- re-encode length-delimited strings into buffers the
+//                       caller provides, a whole character at a time, with
+//                       no allocation.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string.hxx"
+#include "string_internal.hxx"
+#include "string_simd.hxx"
+#include "string_utf8_dfa.hxx"
+#include "internal/string_decode_utf8.hxx"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ansak::internal;
+
+namespace ansak {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Decode the next character from a length-delimited source of each kind,
+// advancing p past it.
+//
+// Returns kConvertOk with c set, kConvertIncomplete if end cuts the
+// character short, or kConvertInvalid; p is only moved on kConvertOk.
+
+ConvertStatus decodeNext
+(
+    const char*&            p,          // I/O - the next character
+    const char*             end,        // I - end of the source
+    char32_t&               c           // O - the character decoded
+)
+{
+    auto q = p;
+    c = utf8dfa::decode(q, end);
+    if (q == nullptr)
+    {
+        return kConvertInvalid;
+    }
+    else if (q == end)
+    {
+        return kConvertIncomplete;
+    }
+    p = q + 1;
+    return kConvertOk;
+}
+
+ConvertStatus decodeNext
+(
+    const char16_t*&        p,          // I/O - the next character
+    const char16_t*         end,        // I - end of the source
+    char32_t&               c           // O - the character decoded
+)
+{
+    c = *p;
+    if (isFirstHalfUtf16(c))
+    {
+        if (p + 1 == end)
+        {
+            return kConvertIncomplete;
+        }
+        if (!isSecondHalfUtf16(p[1]))
+        {
+            return kConvertInvalid;
+        }
+        c = rawDecodeUtf16(p[0], p[1]);
+        p += 2;
+        return kConvertOk;
+    }
+    // a lone second half is left for the target check to refuse
+    ++p;
+    return kConvertOk;
+}
+
+ConvertStatus decodeNext
+(
+    const char32_t*&        p,          // I/O - the next character
+    const char32_t*         ,           // I - end of the source
+    char32_t&               c           // O - the character decoded
+)
+{
+    c = *p++;
+    return kConvertOk;
+}
+
+//=========================================================================
+// Can a decoded character be written in the target encoding?
+//
+// Returns kConvertOk if so, kConvertInvalid for UTF-16 halves (from
+// whatever source), kConvertOutOfRange for values beyond the target.
+
+template<RangeType Target>
+ConvertStatus targetStatus
+(
+    char32_t                c           // I - a decoded character
+)
+{
+    if (isFirstHalfUtf16(c) || isSecondHalfUtf16(c))
+    {
+        return kConvertInvalid;
+    }
+    switch (Target)
+    {
+    case kUtf8:
+        return (c & 0x80000000) == 0 ? kConvertOk : kConvertOutOfRange;
+    case kUtf16:
+        return c <= 0x10ffff ? kConvertOk : kConvertOutOfRange;
+    case kUcs2:
+        return c <= 0xffff ? kConvertOk : kConvertOutOfRange;
+    default:
+        return kConvertOk;
+    }
+}
+
+//=========================================================================
+// Convert the run at p that a kernel can take in one block, as far as room
+// allows, advancing p past it: whole BMP characters from UTF-8 to UTF-16
+// (which any target of char16_t holds), RFC 3629 UTF-8 to UCS-4,
+// well-formed UTF-16 or UCS-4 that UTF-8 can hold the other way, UTF-16 to
+// UCS-4 and UCS-4 that target can hold to UTF-16 or UCS-2. The other pairs
+// take nothing.
+//
+// Returns the number of units written.
+
+template<typename S, typename D>
+size_t convertRun(const S*&, const S*, D*, size_t, RangeType)
+{
+    return 0;
+}
+
+// a stray continuation, or a lead past what the kernel takes, is the
+// caller's either way
+inline bool startsKernelRun(const char* p, unsigned char lastLead)
+{
+    auto c = static_cast<unsigned char>(*p);
+    return c <= lastLead && (c & 0xc0) != 0x80;
+}
+
+size_t convertRun
+(
+    const char*&            p,          // I/O - start of the run
+    const char*             end,        // I - end of the source
+    char16_t*               dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType                           // I - what the destination holds
+)
+{
+    if (!startsKernelRun(p, 0xef))
+    {
+        return 0;
+    }
+    // no character makes more UTF-16 units than it has bytes
+    size_t produced = 0;
+    p += utf8ToUtf16Prefix(p, min(static_cast<size_t>(end - p), room), dst, produced);
+    return produced;
+}
+
+size_t convertRun
+(
+    const char*&            p,          // I/O - start of the run
+    const char*             end,        // I - end of the source
+    char32_t*               dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType                           // I - what the destination holds
+)
+{
+    if (!startsKernelRun(p, 0xf4))
+    {
+        return 0;
+    }
+    size_t produced = 0;
+    p += utf8ToUcs4Prefix(p, min(static_cast<size_t>(end - p), room), dst, produced);
+    return produced;
+}
+
+size_t convertRun
+(
+    const char16_t*&        p,          // I/O - start of the run
+    const char16_t*         end,        // I - end of the source
+    char*                   dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType                           // I - what the destination holds
+)
+{
+    size_t produced = 0;
+    p += utf16ToUtf8Prefix(p, static_cast<size_t>(end - p), dst, room, produced);
+    return produced;
+}
+
+size_t convertRun
+(
+    const char32_t*&        p,          // I/O - start of the run
+    const char32_t*         end,        // I - end of the source
+    char*                   dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType                           // I - what the destination holds
+)
+{
+    size_t produced = 0;
+    p += ucs4ToUtf8Prefix(p, static_cast<size_t>(end - p), dst, room, produced);
+    return produced;
+}
+
+size_t convertRun
+(
+    const char16_t*&        p,          // I/O - start of the run
+    const char16_t*         end,        // I - end of the source
+    char32_t*               dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType                           // I - what the destination holds
+)
+{
+    size_t produced = 0;
+    p += utf16ToUcs4Prefix(p, min(static_cast<size_t>(end - p), room), dst, produced);
+    return produced;
+}
+
+size_t convertRun
+(
+    const char32_t*&        p,          // I/O - start of the run
+    const char32_t*         end,        // I - end of the source
+    char16_t*               dst,        // O - where to convert it to
+    size_t                  room,       // I - units left in dst
+    RangeType               target      // I - what the destination holds
+)
+{
+    auto n = static_cast<size_t>(end - p);
+    if (target == kUcs2)
+    {
+        auto taken = ucs4ToUcs2Prefix(p, min(n, room), dst);
+        p += taken;
+        return taken;
+    }
+    size_t produced = 0;
+    p += ucs4ToUtf16Prefix(p, n, dst, room, produced);
+    return produced;
+}
+
+//=========================================================================
+// How many units at p to give up on when decodeNext and targetStatus have
+// refused what's there: a maximal subpart of bad UTF-8, a lone UTF-16 half,
+// or a whole character the target can't hold.
+
+template<typename S>
+size_t unconvertible
+(
+    const S*                p,          // I - the character refused
+    const S*                next,       // I - where decodeNext left off
+    const S*                end         // I - end of the source
+)
+{
+    if (sizeof(S) == 1)
+    {
+        return maximalSubpart(p, end);
+    }
+    return next > p ? static_cast<size_t>(next - p) : 1;
+}
+
+//=========================================================================
+// Re-encode srcLength units of S into at most dstCapacity units of D, a
+// whole character at a time, replacing or skipping what can't be converted
+// if policy says to.
+//
+// Returns what was consumed and produced, and why it stopped.
+
+template<RangeType Target, typename S, typename D>
+ConvertResult convertInto
+(
+    const S*                src,        // I - the source
+    size_t                  srcLength,  // I - its length in units
+    D*                      dst,        // O - the destination
+    size_t                  dstCapacity,// I - its size in units
+    ConvertPolicy           policy      // I - what to do with bad input
+)
+{
+    ConvertResult result = { 0, 0, kConvertOk };
+    if (src == nullptr || srcLength == 0)
+    {
+        return result;
+    }
+
+    // enough room for any character?
+    const size_t kLongest = sizeof(D) == 1 ? 6 : sizeof(D) == 2 ? 2 : 1;
+    auto end = src + srcLength;
+    auto p = src;
+    size_t produced = 0;
+
+    while (p < end)
+    {
+        produced += convertRun(p, end, dst + produced, dstCapacity - produced, Target);
+        if (p == end)
+        {
+            break;
+        }
+
+        auto next = p;
+        char32_t c = 0;
+        auto status = decodeNext(next, end, c);
+        if (status == kConvertOk)
+        {
+            status = targetStatus<Target>(c);
+        }
+        if (status != kConvertOk)
+        {
+            if (status == kConvertIncomplete || policy == kConvertStrict)
+            {
+                result.status = status;
+                break;
+            }
+            if (policy == kConvertReplace)
+            {
+                D units[3];
+                auto n = encodeUnits(0xfffd, units);
+                if (n > dstCapacity - produced)
+                {
+                    result.status = kConvertTargetFull;
+                    break;
+                }
+                copy(units, units + n, dst + produced);
+                produced += n;
+            }
+            p += unconvertible(p, next, end);
+            continue;
+        }
+
+        auto room = dstCapacity - produced;
+        if (room >= kLongest)
+        {
+            produced += encodeUnits(c, dst + produced);
+        }
+        else
+        {
+            D units[6];
+            auto n = encodeUnits(c, units);
+            if (n > room)
+            {
+                result.status = kConvertTargetFull;
+                break;
+            }
+            copy(units, units + n, dst + produced);
+            produced += n;
+        }
+        p = next;
+    }
+
+    result.consumed = static_cast<size_t>(p - src);
+    result.produced = produced;
+    return result;
+}
+
+//=========================================================================
+// Count the units of D that convertInto would produce for all of src.
+//
+// Returns that count, or 0 if the conversion would fail before the end.
+
+template<RangeType Target, typename S, typename D>
+size_t lengthOf
+(
+    const S*                src,        // I - the source
+    size_t                  srcLength,  // I - its length in units
+    ConvertPolicy           policy      // I - what to do with bad input
+)
+{
+    if (src == nullptr)
+    {
+        return 0;
+    }
+
+    auto end = src + srcLength;
+    size_t r = 0;
+    for (auto p = src; p < end; )
+    {
+        // runs of ASCII are one unit each, whatever the target
+        if (sizeof(S) == 1 && static_cast<unsigned char>(*p) < 0x80)
+        {
+            auto n = asciiPrefix(reinterpret_cast<const char*>(p), static_cast<size_t>(end - p));
+            p += n;
+            r += n;
+            continue;
+        }
+
+        char32_t c = 0;
+        auto next = p;
+        auto status = decodeNext(next, end, c);
+        if (status == kConvertIncomplete)
+        {
+            break;
+        }
+        if (status == kConvertOk)
+        {
+            status = targetStatus<Target>(c);
+        }
+        if (status != kConvertOk)
+        {
+            if (policy == kConvertStrict)
+            {
+                return 0;
+            }
+            r += policy == kConvertReplace ? encodedLength<D>(0xfffd) : 0;
+            p += unconvertible(p, next, end);
+            continue;
+        }
+        r += encodedLength<D>(c);
+        p = next;
+    }
+    return r;
+}
+
+//=========================================================================
+// The buffer converter a StreamConverter<S, D> uses to reach its target;
+// left nullptr for a target D can't hold.
+
+template<typename S, typename D>
+using BufferConverter = ConvertResult (*)(const S*, size_t, D*, size_t, ConvertPolicy);
+
+void pickConverter(RangeType target, BufferConverter<char, char16_t>& convert)
+{
+    if (target == kUtf16)
+    {
+        convert = toUtf16;
+    }
+    else if (target == kUcs2)
+    {
+        convert = toUcs2;
+    }
+}
+
+void pickConverter(RangeType target, BufferConverter<char, char32_t>& convert)
+{
+    if (target == kUcs4)
+    {
+        convert = toUcs4;
+    }
+}
+
+void pickConverter(RangeType target, BufferConverter<char16_t, char>& convert)
+{
+    if (target == kUtf8)
+    {
+        convert = toUtf8;
+    }
+}
+
+void pickConverter(RangeType target, BufferConverter<char16_t, char32_t>& convert)
+{
+    if (target == kUcs4)
+    {
+        convert = toUcs4;
+    }
+}
+
+void pickConverter(RangeType target, BufferConverter<char32_t, char>& convert)
+{
+    if (target == kUtf8)
+    {
+        convert = toUtf8;
+    }
+}
+
+void pickConverter(RangeType target, BufferConverter<char32_t, char16_t>& convert)
+{
+    if (target == kUtf16)
+    {
+        convert = toUtf16;
+    }
+    else if (target == kUcs2)
+    {
+        convert = toUcs2;
+    }
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Public Functions
+
+//////////////////// Convert into a caller's buffer
+
+ConvertResult toUtf8(const char16_t* src, size_t srcLength, char* dst, size_t dstCapacity)
+{
+    return convertInto<kUtf8>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUtf8(const char16_t* src, size_t srcLength, char* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUtf8>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUtf8(const char32_t* src, size_t srcLength, char* dst, size_t dstCapacity)
+{
+    return convertInto<kUtf8>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUtf8(const char32_t* src, size_t srcLength, char* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUtf8>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUcs2(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUcs2>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUcs2(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUcs2>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUcs2(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUcs2>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUcs2(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUcs2>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUtf16(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUtf16>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUtf16(const char* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUtf16>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUtf16(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUtf16>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUtf16(const char32_t* src, size_t srcLength, char16_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUtf16>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUcs4(const char* src, size_t srcLength, char32_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUcs4>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUcs4(const char* src, size_t srcLength, char32_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUcs4>(src, srcLength, dst, dstCapacity, policy);
+}
+
+ConvertResult toUcs4(const char16_t* src, size_t srcLength, char32_t* dst, size_t dstCapacity)
+{
+    return convertInto<kUcs4>(src, srcLength, dst, dstCapacity, kConvertStrict);
+}
+
+ConvertResult toUcs4(const char16_t* src, size_t srcLength, char32_t* dst, size_t dstCapacity, ConvertPolicy policy)
+{
+    return convertInto<kUcs4>(src, srcLength, dst, dstCapacity, policy);
+}
+
+//////////////////// Length of a conversion
+
+size_t requiredLength(const char* src, size_t srcLength, RangeType target, ConvertPolicy policy)
+{
+    switch (target)
+    {
+    case kUtf16:    return lengthOf<kUtf16, char, char16_t>(src, srcLength, policy);
+    case kUcs2:     return lengthOf<kUcs2, char, char16_t>(src, srcLength, policy);
+    case kUcs4:     return lengthOf<kUcs4, char, char32_t>(src, srcLength, policy);
+    default:        return 0;
+    }
+}
+
+size_t requiredLength(const char16_t* src, size_t srcLength, RangeType target, ConvertPolicy policy)
+{
+    switch (target)
+    {
+    case kUtf8:     return lengthOf<kUtf8, char16_t, char>(src, srcLength, policy);
+    case kUcs4:     return lengthOf<kUcs4, char16_t, char32_t>(src, srcLength, policy);
+    default:        return 0;
+    }
+}
+
+size_t requiredLength(const char32_t* src, size_t srcLength, RangeType target, ConvertPolicy policy)
+{
+    switch (target)
+    {
+    case kUtf8:     return lengthOf<kUtf8, char32_t, char>(src, srcLength, policy);
+    case kUtf16:    return lengthOf<kUtf16, char32_t, char16_t>(src, srcLength, policy);
+    case kUcs2:     return lengthOf<kUcs2, char32_t, char16_t>(src, srcLength, policy);
+    default:        return 0;
+    }
+}
+
+
+//////////////////// Convert a chunk at a time
+
+template<typename S, typename D>
+const size_t StreamConverter<S, D>::kLongestCarry;
+
+template<typename S, typename D>
+StreamConverter<S, D>::StreamConverter(RangeType target, ConvertPolicy policy)
+    : m_convert(nullptr)
+    , m_policy(policy)
+    , m_carry()
+    , m_carryLength(0)
+{
+    pickConverter(target, m_convert);
+}
+
+template<typename S, typename D>
+ConvertResult StreamConverter<S, D>::convert(const S* src, size_t srcLength, D* dst, size_t dstCapacity)
+{
+    ConvertResult result = { 0, 0, kConvertOk };
+    if (m_convert == nullptr)
+    {
+        result.status = kConvertOutOfRange;
+        return result;
+    }
+    if (src == nullptr || srcLength == 0)
+    {
+        return result;
+    }
+
+    // first, the character the last chunk cut short -- joined to enough of
+    // this one to finish any character, whatever else it holds
+    if (m_carryLength != 0)
+    {
+        S joined[kLongestCarry * 2];
+        auto taken = min(srcLength, kLongestCarry);
+        copy(m_carry, m_carry + m_carryLength, joined);
+        copy(src, src + taken, joined + m_carryLength);
+        auto r = m_convert(joined, m_carryLength + taken, dst, dstCapacity, m_policy);
+        if (r.consumed < m_carryLength)
+        {
+            // what was converted of it (one U+FFFD of several, say) is done;
+            // hold back only the rest
+            copy(m_carry + r.consumed, m_carry + m_carryLength, m_carry);
+            m_carryLength -= r.consumed;
+            result.produced = r.produced;
+            if (r.status == kConvertIncomplete && taken == srcLength)
+            {
+                // still cut short: the whole chunk joins what's held back
+                copy(src, src + taken, m_carry + m_carryLength);
+                m_carryLength += taken;
+                result.consumed = taken;
+            }
+            else
+            {
+                result.status = r.status;
+            }
+            return result;
+        }
+        result.consumed = r.consumed - m_carryLength;
+        result.produced = r.produced;
+        m_carryLength = 0;
+        if (r.status != kConvertOk && r.status != kConvertIncomplete)
+        {
+            result.status = r.status;
+            return result;
+        }
+    }
+
+    auto r = m_convert(src + result.consumed, srcLength - result.consumed,
+                       dst + result.produced, dstCapacity - result.produced, m_policy);
+    result.consumed += r.consumed;
+    result.produced += r.produced;
+    if (r.status == kConvertIncomplete)
+    {
+        // hold back the start of a character the chunk cut short
+        m_carryLength = srcLength - result.consumed;
+        copy(src + result.consumed, src + srcLength, m_carry);
+        result.consumed = srcLength;
+    }
+    else
+    {
+        result.status = r.status;
+    }
+    return result;
+}
+
+template<typename S, typename D>
+ConvertStatus StreamConverter<S, D>::finish() const
+{
+    return m_carryLength != 0 ? kConvertIncomplete : kConvertOk;
+}
+
+template<typename S, typename D>
+void StreamConverter<S, D>::reset()
+{
+    m_carryLength = 0;
+}
+
+template class StreamConverter<char, char16_t>;
+template class StreamConverter<char, char32_t>;
+template class StreamConverter<char16_t, char>;
+template class StreamConverter<char16_t, char32_t>;
+template class StreamConverter<char32_t, char>;
+template class StreamConverter<char32_t, char16_t>;
+
+}
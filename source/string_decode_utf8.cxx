@@ -46,6 +46,10 @@
 
 #include "string.hxx"
 #include "string_internal.hxx"
+#include "string_utf8_dfa.hxx"
+
+#include <stdint.h>
+#include <string.h>
 
 using namespace std;
 
@@ -200,6 +204,162 @@ char32_t decodeUtf8
     }
 }
 
+//=========================================================================
+// Utility function to decode a single UCS-4 character from "the next
+// character" in a length-delimited run of bytes. See header for details.
+
+char32_t decodeUtf8
+(
+    const char*&        p,      // I/O - points to current character
+    const char*         end     // I - one past the last byte available
+)
+{
+    // the longest sequence, a 6-byte one or a CESU-8 pair, fits -- decode in
+    // place, but a null met part-way is an error, not an end
+    if (end - p >= 6)
+    {
+        auto first = *p;
+        auto c = decodeUtf8(p);
+        if (p != nullptr && c == 0 && first != 0)
+        {
+            p = nullptr;
+        }
+        return c;
+    }
+
+    // otherwise decode from a null-padded copy: a null inside the run is an
+    // error, a null in the padding means that end came first
+    char tail[8] = { 0 };
+    auto available = end - p;
+    memcpy(tail, p, static_cast<size_t>(available));
+    const char* q = tail;
+    auto c = decodeUtf8(q);
+    if (q == nullptr)
+    {
+        p = nullptr;
+    }
+    else if (c == 0 && tail[0] != 0)
+    {
+        p = (q - tail < available) ? nullptr : end;
+    }
+    else
+    {
+        p += q - tail;
+    }
+    return c;
+}
+
+namespace utf8dfa {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+const uint8_t kClassOf[256] = {
+    // 00..7f
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii, kAscii,
+    // 80..bf
+    kCont80, kCont80, kCont80, kCont80, kCont84, kCont84, kCont84, kCont84,
+    kCont88, kCont88, kCont88, kCont88, kCont88, kCont88, kCont88, kCont88,
+    kCont90, kCont90, kCont90, kCont90, kCont90, kCont90, kCont90, kCont90,
+    kCont90, kCont90, kCont90, kCont90, kCont90, kCont90, kCont90, kCont90,
+    kContA0, kContA0, kContA0, kContA0, kContA0, kContA0, kContA0, kContA0,
+    kContA0, kContA0, kContA0, kContA0, kContA0, kContA0, kContA0, kContA0,
+    kContB0, kContB0, kContB0, kContB0, kContB0, kContB0, kContB0, kContB0,
+    kContB0, kContB0, kContB0, kContB0, kContB0, kContB0, kContB0, kContB0,
+    // c0..ff
+    kLeadC0, kLeadC0, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2,
+    kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2,
+    kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2,
+    kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2, kLeadC2,
+    kLeadE0, kLeadE1, kLeadE1, kLeadE1, kLeadE1, kLeadE1, kLeadE1, kLeadE1,
+    kLeadE1, kLeadE1, kLeadE1, kLeadE1, kLeadE1, kLeadED, kLeadE1, kLeadE1,
+    kLeadF0, kLeadF1, kLeadF1, kLeadF1, kLeadF1, kLeadF1, kLeadF1, kLeadF1,
+    kLeadF8, kLeadF9, kLeadF9, kLeadF9, kLeadFC, kLeadFD, kNever, kNever
+};
+
+const uint8_t kPayloadOf[kByteClasses] = {
+    0x7f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f,   // ASCII, continuations
+    0x1f, 0x1f,                                 // 2-byte leads
+    0x0f, 0x0f, 0x0f,                           // 3-byte leads
+    0x07, 0x07,                                 // 4-byte leads
+    0x03, 0x03,                                 // 5-byte leads
+    0x01, 0x01,                                 // 6-byte leads
+    0x00
+};
+
+const uint8_t kShiftOf[kByteClasses] = {
+    0, 6, 6, 6, 6, 6, 6,                        // ASCII, continuations
+    0, 0,                                       // 2-byte leads
+    4, 4, 4,                                    // 3-byte leads, maybe a pair's second half
+    0, 0, 0, 0, 0, 0, 0
+};
+
+// short names to keep the rows readable
+const uint8_t R = kReject;
+const uint8_t D1 = kDoomed1;
+const uint8_t D2 = kDoomed2;
+const uint8_t D3 = kDoomed3;
+
+// one row per DecodeState, one column per ByteClass, both in order
+const uint8_t kNextState[kDecodeStates][kByteClasses] = {
+    { kAccept, R, R, R, R, R, R, D1, kNeed1, kAfterE0, kNeed2, kAfterED, kAfterF0, kNeed3, kAfterF8, kNeed4, kAfterFC, kNeed5, R },     // kAccept
+    { R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },                                                                      // kReject
+    { R, kAccept, kAccept, kAccept, kAccept, kAccept, kAccept, R, R, R, R, R, R, R, R, R, R, R, R },                                  // kNeed1
+    { R, kNeed1, kNeed1, kNeed1, kNeed1, kNeed1, kNeed1, R, R, R, R, R, R, R, R, R, R, R, R },                                        // kNeed2
+    { R, kNeed2, kNeed2, kNeed2, kNeed2, kNeed2, kNeed2, R, R, R, R, R, R, R, R, R, R, R, R },                                        // kNeed3
+    { R, kNeed3, kNeed3, kNeed3, kNeed3, kNeed3, kNeed3, R, R, R, R, R, R, R, R, R, R, R, R },                                        // kNeed4
+    { R, kNeed4, kNeed4, kNeed4, kNeed4, kNeed4, kNeed4, R, R, R, R, R, R, R, R, R, R, R, R },                                        // kNeed5
+    { R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R, R },                                                                      // kDoomed1
+    { R, D1, D1, D1, D1, D1, D1, R, R, R, R, R, R, R, R, R, R, R, R },                                                                // kDoomed2
+    { R, D2, D2, D2, D2, D2, D2, R, R, R, R, R, R, R, R, R, R, R, R },                                                                // kDoomed3
+    { R, D3, D3, D3, D3, D3, D3, R, R, R, R, R, R, R, R, R, R, R, R },                                                                // kDoomed4
+    { R, D1, D1, D1, D1, kNeed1, kNeed1, R, R, R, R, R, R, R, R, R, R, R, R },                                                        // kAfterE0
+    { R, kNeed1, kNeed1, kNeed1, kNeed1, kFirstHalf, D1, R, R, R, R, R, R, R, R, R, R, R, R },                                        // kAfterED
+    { R, D2, D2, D2, kNeed2, kNeed2, kNeed2, R, R, R, R, R, R, R, R, R, R, R, R },                                                    // kAfterF0
+    { R, D3, D3, kNeed3, kNeed3, kNeed3, kNeed3, R, R, R, R, R, R, R, R, R, R, R, R },                                                // kAfterF8
+    { R, kDoomed4, kNeed4, kNeed4, kNeed4, kNeed4, kNeed4, R, R, R, R, R, R, R, R, R, R, R, R },                                      // kAfterFC
+    { R, kPairLead, kPairLead, kPairLead, kPairLead, kPairLead, kPairLead, R, R, R, R, R, R, R, R, R, R, R, R },                      // kFirstHalf
+    { R, R, R, R, R, R, R, R, R, D2, D2, kPairED, R, R, R, R, R, R, R },                                                              // kPairLead
+    { R, D1, D1, D1, D1, D1, kNeed1, R, R, R, R, R, R, R, R, R, R, R, R }                                                             // kPairED
+};
+
+}
+
+//=========================================================================
+// decodeUtf8 by state machine. See header for details.
+
+char32_t decodeUtf8Dfa
+(
+    const char*&        p       // I/O - points to current non-null character
+)
+{
+    return utf8dfa::decode(p);
+}
+
+char32_t decodeUtf8Dfa
+(
+    const char*&        p,      // I/O - points to current character
+    const char*         end     // I - one past the last byte available
+)
+{
+    return utf8dfa::decode(p, end);
+}
+
 }
 
 }
@@ -43,6 +43,7 @@
 #pragma once
 
 #include "string.hxx"
+#include "char_tables.hxx"
 #include <functional>
 
 namespace ansak {
@@ -111,25 +112,59 @@ private:
 extern const utf8String supportedUnicodeVersion;
 
 //=========================================================================
-// Returns true if the character is in the selected Unicode 8 standard, false
-// otherwise. Note, all 8-bit values are in the standard. Gaps first begin
-// after U+0377
+// Per-code-point EncodingTypeFlags, from tables that mkUnicodeTables
+// generates at build time from the selected UnicodeData.txt (its header,
+// char_tables.hxx, sets the layout). kCharPropertyIndex gives, for each block
+// of code points, which of the distinct blocks in kCharPropertyBlocks holds
+// its flags, so any code point costs two loads. No range check for c.
+
+inline uint32_t charPropertyAt(uint32_t c)
+{
+    const uint32_t kLowBits = (1u << kCharTableBlockBits) - 1;
+    uint32_t block = kCharPropertyIndex[c >> kCharTableBlockBits];
+    if (kCharPropertiesPacked)
+    {
+        auto flags = kCharPropertyBlocks[(block << (kCharTableBlockBits - 1)) | ((c & kLowBits) >> 1)];
+        return (flags >> ((c & 1) * 4)) & 0xf;
+    }
+    return kCharPropertyBlocks[(block << kCharTableBlockBits) | (c & kLowBits)];
+}
+
+inline uint32_t charPropertyMask(char c)
+{
+    return charPropertyAt(static_cast<unsigned char>(c));
+}
+
+inline uint32_t charPropertyMask(char16_t c)
+{
+    return charPropertyAt(c);
+}
+
+inline uint32_t charPropertyMask(char32_t c)
+{
+    return c > 0x10ffff ? 0 : charPropertyAt(c);
+}
+
+//=========================================================================
+// Returns true if the character is in the selected Unicode standard, false
+// otherwise. Note, all 8-bit values are in the standard. Private-use code
+// points are not "assigned" here.
 
 inline bool isUnicodeAssigned(char ) { return true; }
-bool isUnicodeAssigned(char16_t c);
-bool isUnicodeAssigned(char32_t c);
+inline bool isUnicodeAssigned(char16_t c) { return (charPropertyMask(c) & kIsAssignedFlag) != 0; }
+inline bool isUnicodeAssigned(char32_t c) { return (charPropertyMask(c) & kIsAssignedFlag) != 0; }
 
 inline bool isUnicodePrivate(char ) { return false; }
-bool isUnicodePrivate(char16_t c);
-bool isUnicodePrivate(char32_t c);
+inline bool isUnicodePrivate(char16_t c) { return (charPropertyMask(c) & kIsPrivateFlag) != 0; }
+inline bool isUnicodePrivate(char32_t c) { return (charPropertyMask(c) & kIsPrivateFlag) != 0; }
 
-bool isControlChar(char c);
-bool isControlChar(char16_t c);
-bool isControlChar(char32_t c);
+inline bool isControlChar(char c) { return (charPropertyMask(c) & kIsControlFlag) != 0; }
+inline bool isControlChar(char16_t c) { return (charPropertyMask(c) & kIsControlFlag) != 0; }
+inline bool isControlChar(char32_t c) { return (charPropertyMask(c) & kIsControlFlag) != 0; }
 
-bool isWhitespaceChar(char c);
-bool isWhitespaceChar(char16_t c);
-bool isWhitespaceChar(char32_t c);
+inline bool isWhitespaceChar(char c) { return (charPropertyMask(c) & kIsWhiteSpaceFlag) != 0; }
+inline bool isWhitespaceChar(char16_t c) { return (charPropertyMask(c) & kIsWhiteSpaceFlag) != 0; }
+inline bool isWhitespaceChar(char32_t c) { return (charPropertyMask(c) & kIsWhiteSpaceFlag) != 0; }
 
 //=========================================================================
 // A utility function to check if a character is allowed within Unicode
@@ -240,17 +275,14 @@ inline RangeTypeFlags getRangeFlag(char16_t firstChar)
 
 //=========================================================================
 // A template to generate an encoding mask (isAssigned? isPrivate? isControl?
-// isWhitespace?) for any character
+// isWhitespace?) for any character, in one table lookup
 
 template<typename C>
 uint32_t charToEncodingTypeMask(C c)
 {
     static_assert(std::is_integral<C>::value, "charToEncodingTypeMask needs an integral type.");
 
-    return (isUnicodeAssigned(c) ? kIsAssignedFlag : 0) |
-           (isUnicodePrivate(c) ? kIsPrivateFlag : 0) |
-           (isControlChar(c) ? kIsControlFlag : 0) |
-           (isWhitespaceChar(c) ? kIsWhiteSpaceFlag : 0);
+    return charPropertyMask(c);
 }
 
 //=========================================================================
@@ -445,13 +477,179 @@ void rawEncodeUtf16
 }
 
 //=========================================================================
-// toLower of one character, from a Turkic and non-Turkic point of view.
+// Utility functions to encode a single UCS-4 character, already known to
+// fit, straight into a buffer with room for it: up to 6 bytes of UTF-8, 2
+// elements of UTF-16 or 1 of UCS-4.
+//
+// Returns the number of elements written.
+
+inline size_t encodeUnits
+(
+    char32_t                c,          // I - A UCS-4 character, below 0x80000000
+    char*                   out         // O - where to write its UTF-8 bytes
+)
+{
+    if (c < 0x80)
+    {
+        out[0] = static_cast<char>(c);
+        return 1;
+    }
+    size_t n = c < 0x800 ? 2 : c < 0x10000 ? 3 : c < 0x200000 ? 4 : c < 0x4000000 ? 5 : 6;
+    static const unsigned char leads[] = { 0, 0, 0xc0, 0xe0, 0xf0, 0xf8, 0xfc };
+    for (auto i = n - 1; i > 0; --i)
+    {
+        out[i] = static_cast<char>((c & 0x3f) | 0x80);
+        c >>= 6;
+    }
+    out[0] = static_cast<char>(c | leads[n]);
+    return n;
+}
+
+inline size_t encodeUnits
+(
+    char32_t                c,          // I - A UCS-4 character, up to 0x10ffff
+    char16_t*               out         // O - where to write its UTF-16 elements
+)
+{
+    if (c < 0x10000)
+    {
+        out[0] = static_cast<char16_t>(c);
+        return 1;
+    }
+    c -= 0x10000;
+    out[0] = static_cast<char16_t>(0xd800 + ((c >> 10) & 0x3ff));
+    out[1] = static_cast<char16_t>(0xdc00 + (c & 0x3ff));
+    return 2;
+}
+
+inline size_t encodeUnits
+(
+    char32_t                c,          // I - A UCS-4 character
+    char32_t*               out         // O - where to write it
+)
+{
+    out[0] = c;
+    return 1;
+}
+
+//=========================================================================
+// How many elements of C encodeUnits writes for a character
+
+template <typename C> size_t encodedLength(char32_t c);
+
+template <> inline size_t encodedLength<char>(char32_t c)
+{
+    return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : c < 0x200000 ? 4 : c < 0x4000000 ? 5 : 6;
+}
+
+template <> inline size_t encodedLength<char16_t>(char32_t c)
+{
+    return c < 0x10000 ? 1 : 2;
+}
+
+template <> inline size_t encodedLength<char32_t>(char32_t )
+{
+    return 1;
+}
+
+//=========================================================================
+// How many units at p one U+FFFD replaces when what's there can't be
+// converted. For UTF-8, the "maximal subpart": the longest prefix of a
+// well-formed sequence (in the strict RFC 3629 sense -- no 5- or 6-byte
+// forms, no surrogates, nothing past U+10FFFF) starting at p, or the
+// single byte at p if no such sequence starts there. Other encodings give
+// up a unit at a time.
+//
+// Returns at least 1, at most end - p.
+
+inline size_t maximalSubpart
+(
+    const char*             p,          // I - the first byte not converted
+    const char*             end         // I - end of the source
+)
+{
+    auto lead = static_cast<unsigned char>(*p);
+    unsigned char low = 0x80;
+    unsigned char high = 0xbf;
+    size_t length;
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        length = 2;
+    }
+    else if (lead >= 0xe0 && lead <= 0xef)
+    {
+        length = 3;
+        low = lead == 0xe0 ? 0xa0 : 0x80;
+        high = lead == 0xed ? 0x9f : 0xbf;
+    }
+    else if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        length = 4;
+        low = lead == 0xf0 ? 0x90 : 0x80;
+        high = lead == 0xf4 ? 0x8f : 0xbf;
+    }
+    else
+    {
+        return 1;
+    }
+
+    // only the first continuation byte is narrowed
+    size_t n = 1;
+    for (; n < length && p + n < end; ++n)
+    {
+        auto b = static_cast<unsigned char>(p[n]);
+        if (b < low || b > high)
+        {
+            break;
+        }
+        low = 0x80;
+        high = 0xbf;
+    }
+    return n;
+}
+
+inline size_t maximalSubpart(const char16_t*, const char16_t*) { return 1; }
+inline size_t maximalSubpart(const char32_t*, const char32_t*) { return 1; }
+
+//=========================================================================
+// toLower of one character, from a Turkic and non-Turkic point of view,
+// using UnicodeData.txt's simple lower-case mapping. Like the properties,
+// the generated tables hold a block index per block of code points, and
+// each block a byte per code point naming one of the few distinct
+// (lower case - code point) distances in kLowerCaseDeltas.
 //
 // Returns the value of the lower case form, if any, of the input parameter;
 // returns the same character otherwise.
 
-char32_t turkicToLower(char32_t c);
-char32_t toLower(char32_t c);
+inline char32_t toLower(char32_t c)
+{
+    const uint32_t kLowBits = (1u << kCharTableBlockBits) - 1;
+    if (c > 0x10ffff)
+    {
+        return c;
+    }
+    uint32_t block = kLowerCaseIndex[c >> kCharTableBlockBits];
+    auto delta = kLowerCaseDeltas[kLowerCaseBlocks[(block << kCharTableBlockBits) | (c & kLowBits)]];
+    return static_cast<char32_t>(static_cast<int32_t>(c) + delta);
+}
+
+inline char32_t turkicToLower(char32_t c)
+{
+    // U+0130 (dotted I) already lower-cases to i for everyone
+    return c == 0x49 ? 0x131 : toLower(c);
+}
+
+//=========================================================================
+// isUtf8Parallel and isUtf16Parallel, cutting the source into pieces of
+// about pieceLength units rather than kParallelPieceLength (so that tests
+// can cut short sources into many pieces)
+
+const size_t kParallelPieceLength = 4 * 1024 * 1024;
+
+bool isUtf8InPieces(const char* test, size_t testLength, RangeType targetRange,
+                    const EncodingCheckPredicate& pred, unsigned int threadCount, size_t pieceLength);
+bool isUtf16InPieces(const char16_t* test, size_t testLength, RangeType targetRange,
+                     const EncodingCheckPredicate& pred, unsigned int threadCount, size_t pieceLength);
 
 }
 
@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_parallel.cxx -- validate very large UTF-8 and UTF-16 sources on
+//                        several threads at once, a piece at a time.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string.hxx"
+#include "string_internal.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ansak::internal;
+
+namespace ansak {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Move a cut in a source forward to where a piece may end: not inside a
+// character (past any continuation bytes, no more than any character has)
+// and not between the halves of a CESU-8 or UTF-16 pair (past the unit
+// after a first half). Ill-formed text may leave the cut anywhere at all;
+// the pieces either side of it then fail as the whole source would.
+//
+// Returns the adjusted cut, perhaps testLength.
+
+size_t pieceBoundary
+(
+    const char*     test,           // I - the source
+    size_t          testLength,     // I - its length in bytes
+    size_t          at              // I - where to cut it, give or take
+)
+{
+    auto skipContinuations = [&]()
+    {
+        for (size_t i = 0; i < 6 && at < testLength && (test[at] & 0xc0) == 0x80; ++i)
+        {
+            ++at;
+        }
+    };
+
+    skipContinuations();
+    if (at >= 3 && at < testLength && test[at - 3] == static_cast<char>(0xed) &&
+        (test[at - 2] & 0xf0) == 0xa0 && (test[at - 1] & 0xc0) == 0x80)
+    {
+        ++at;
+        skipContinuations();
+    }
+    return at;
+}
+
+size_t pieceBoundary
+(
+    const char16_t* test,           // I - the source
+    size_t          testLength,     // I - its length in units
+    size_t          at              // I - where to cut it, give or take
+)
+{
+    return at < testLength && isFirstHalfUtf16(test[at - 1]) ? at + 1 : at;
+}
+
+//=========================================================================
+// Check a piece of a source. One ending before the source does must end
+// on a character boundary, so a sequence it cuts short fails it; the last
+// piece is checked as isUtf8 and isUtf16 check the whole.
+//
+// Returns true if the piece is valid.
+
+bool pieceIsValid(const char* piece, size_t pieceLength, bool isLast,
+                  RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isLast ? isUtf8(piece, pieceLength, targetRange, pred)
+                  : validateUtf8(piece, pieceLength, targetRange, pred).valid;
+}
+
+bool pieceIsValid(const char16_t* piece, size_t pieceLength, bool isLast,
+                  RangeType targetRange, const EncodingCheckPredicate& pred)
+{
+    return isLast ? isUtf16(piece, pieceLength, targetRange, pred)
+                  : validateUtf16(piece, pieceLength, targetRange, pred).valid;
+}
+
+//=========================================================================
+// Cut a source into pieces of about pieceLength units and check them on up
+// to threadCount threads, the calling one among them. Each thread takes
+// the next piece not yet taken until one fails or none are left. Every
+// thread shares pred, which (being const and stateless) they all may.
+//
+// Returns true if every piece is valid.
+
+template <typename C>
+bool checkInPieces
+(
+    const C*        test,           // I - the source
+    size_t          testLength,     // I - its length in units
+    RangeType       targetRange,    // I - target range
+    const EncodingCheckPredicate&   // I - validity check
+                    pred,
+    unsigned int    threadCount,    // I - threads to use, 0 for all there are
+    size_t          pieceLength     // I - about how long each piece is
+)
+{
+    if (threadCount == 0)
+    {
+        threadCount = max(thread::hardware_concurrency(), 1u);
+    }
+    pieceLength = max(pieceLength, static_cast<size_t>(1));
+
+    // where each piece starts, each ending where the next one starts
+    vector<size_t> starts(1, 0);
+    if (test && threadCount > 1 && targetRange >= kAscii && targetRange <= kUnicode)
+    {
+        for (auto at = pieceLength; at < testLength; at = starts.back() + pieceLength)
+        {
+            auto cut = pieceBoundary(test, testLength, at);
+            if (cut >= testLength)
+            {
+                break;
+            }
+            starts.push_back(cut);
+        }
+    }
+    if (starts.size() == 1)
+    {
+        return pieceIsValid(test, testLength, true, targetRange, pred);
+    }
+
+    atomic<size_t> nextPiece(0);
+    atomic<bool> failed(false);
+    auto checkPieces = [&]()
+    {
+        for (auto i = nextPiece++; i < starts.size() && !failed; i = nextPiece++)
+        {
+            auto isLast = i + 1 == starts.size();
+            auto end = isLast ? testLength : starts[i + 1];
+            if (!pieceIsValid(test + starts[i], end - starts[i], isLast, targetRange, pred))
+            {
+                failed = true;
+            }
+        }
+    };
+
+    vector<thread> helpers;
+    auto helperCount = min(static_cast<size_t>(threadCount), starts.size()) - 1;
+    try
+    {
+        while (helpers.size() < helperCount)
+        {
+            helpers.emplace_back(checkPieces);
+        }
+    }
+    catch (const system_error&)
+    {
+        // go on with the threads there are; this one checks pieces too
+    }
+    checkPieces();
+    for (auto& helper : helpers)
+    {
+        helper.join();
+    }
+    return !failed;
+}
+
+}
+
+namespace internal {
+
+bool isUtf8InPieces(const char* test, size_t testLength, RangeType targetRange,
+                    const EncodingCheckPredicate& pred, unsigned int threadCount, size_t pieceLength)
+{
+    return checkInPieces(test, testLength, targetRange, pred, threadCount, pieceLength);
+}
+
+bool isUtf16InPieces(const char16_t* test, size_t testLength, RangeType targetRange,
+                     const EncodingCheckPredicate& pred, unsigned int threadCount, size_t pieceLength)
+{
+    return checkInPieces(test, testLength, targetRange, pred, threadCount, pieceLength);
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Public Functions
+
+bool isUtf8Parallel(const char* test, size_t testLength, RangeType targetRange,
+                    const EncodingCheckPredicate& pred, unsigned int threadCount)
+{
+    return checkInPieces(test, testLength, targetRange, pred, threadCount, kParallelPieceLength);
+}
+
+bool isUtf16Parallel(const char16_t* test, size_t testLength, RangeType targetRange,
+                     const EncodingCheckPredicate& pred, unsigned int threadCount)
+{
+    return checkInPieces(test, testLength, targetRange, pred, threadCount, kParallelPieceLength);
+}
+
+}
@@ -0,0 +1,620 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_simd.cxx -- run-time selection of the vector kernels, and the
+//                    scalar kernels every other level falls back on.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string_simd.hxx"
+
+#include <string.h>
+
+namespace ansak {
+
+namespace internal {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Scalar kernels -- a word at a time where that helps, otherwise a plain
+// loop for the compiler to do what it can with
+
+size_t scalarAsciiPrefix(const char* p, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        if ((word & 0x8080808080808080ull) != 0)
+        {
+            break;
+        }
+    }
+    while (i < n && static_cast<unsigned char>(p[i]) < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+// a run of ASCII is as much well-formed UTF-8 as a word-at-a-time scan
+// can vouch for
+size_t scalarValidUtf8Prefix(const char* p, size_t n, unsigned char)
+{
+    return scalarAsciiPrefix(p, n);
+}
+
+void scalarWidenAsciiToUtf16(const char* p, size_t n, char16_t* out)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = static_cast<char16_t>(p[i]);
+    }
+}
+
+void scalarWidenAsciiToUcs4(const char* p, size_t n, char32_t* out)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = static_cast<char32_t>(p[i]);
+    }
+}
+
+// only runs of ASCII get past a scalar transcoder with no checking to do
+template<typename C>
+size_t scalarUtf8ToWide(const char* p, size_t n, C* out, size_t* produced)
+{
+    auto ascii = scalarAsciiPrefix(p, n);
+    for (size_t i = 0; i < ascii; ++i)
+    {
+        out[i] = static_cast<C>(p[i]);
+    }
+    *produced = ascii;
+    return ascii;
+}
+
+// ... and only runs of ASCII the other way
+template<typename C>
+size_t scalarToUtf8(const C* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    n = n < room ? n : room;
+    size_t i = 0;
+    for ( ; i < n && p[i] < 0x80; ++i)
+    {
+        out[i] = static_cast<char>(p[i]);
+    }
+    *produced = i;
+    return i;
+}
+
+// between UTF-16 and UCS-4 the checks are no more than the loop itself, so
+// the scalar kernels take as much as the vectors do
+size_t scalarUtf16ToUcs4(const char16_t* p, size_t n, char32_t* out, size_t* produced)
+{
+    *produced = 0;
+    return utf16ToUcs4From(p, 0, n, out, *produced);
+}
+
+size_t scalarUcs4ToUtf16(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced)
+{
+    *produced = 0;
+    return ucs4ToUtf16From(p, 0, n, out, room, *produced, 0x10ffff);
+}
+
+size_t scalarUcs4ToUcs2(const char32_t* p, size_t n, char16_t* out)
+{
+    size_t o = 0;
+    return ucs4ToUtf16From(p, 0, n, out, n, o, 0xffff);
+}
+
+//=========================================================================
+// Lower-case the 7-bit prefix eight bytes at a time: every unit of a word
+// is tested against 'A' and 'Z' at once (units below 0x80 can't carry into
+// their neighbours), and 0x20 is added to those in range.
+
+template<typename C>
+size_t scalarLowerAscii(const C* p, size_t n, C* out)
+{
+    const size_t kPerWord = sizeof(uint64_t) / sizeof(C);
+    const uint64_t kOnes = ~static_cast<uint64_t>(0) /
+                           ((static_cast<uint64_t>(1) << (8 * sizeof(C))) - 1);
+    const uint64_t kHighBits = kOnes * 0x80;
+
+    size_t i = 0;
+    for ( ; i + kPerWord <= n; i += kPerWord)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        if ((word & ~(kOnes * 0x7f)) != 0)
+        {
+            break;
+        }
+        auto atLeastA = word + kOnes * (0x80 - 'A');
+        auto pastZ = word + kOnes * (0x80 - 'Z' - 1);
+        word |= ((atLeastA & ~pastZ) & kHighBits) >> 2;
+        memcpy(out + i, &word, sizeof(word));
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+//=========================================================================
+// Scalar census kernels -- UTF-8 a word at a time, the wider forms a unit
+// at a time
+
+void scalarUtf8Census(const char* p, size_t n, size_t* continuations, size_t* fourByteLeads)
+{
+    const uint64_t highBits = 0x8080808080808080ull;
+    size_t conts = 0;
+    size_t fours = 0;
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        // shifting left moves each byte's bit 6 (5, 4) up under its bit 7
+        conts += popCount(word & ~(word << 1) & highBits);
+        fours += popCount(word & (word << 1) & (word << 2) & (word << 3) & highBits);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = static_cast<unsigned char>(p[i]);
+        conts += (c & 0xc0) == 0x80;
+        fours += c >= 0xf0;
+    }
+    *continuations = conts;
+    *fourByteLeads = fours;
+}
+
+void scalarUtf16Census(const char16_t* p, size_t n, size_t* utf8Extra, size_t* secondHalves)
+{
+    size_t extra = 0;
+    size_t seconds = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto c = p[i];
+        // a surrogate pair is two 3-byte-range units making one 4-byte character
+        extra += (c >= 0x80) + (c >= 0x800) - ((c & 0xf800) == 0xd800);
+        seconds += (c & 0xfc00) == 0xdc00;
+    }
+    *utf8Extra = extra;
+    *secondHalves = seconds;
+}
+
+void scalarUcs4Census(const char32_t* p, size_t n, size_t* utf8Extra, size_t* utf16Extra)
+{
+    size_t extra8 = 0;
+    size_t extra16 = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto c = p[i];
+        extra8 += (c >= 0x80) + (c >= 0x800) + (c >= 0x10000) + (c >= 0x200000) + (c >= 0x4000000);
+        extra16 += c >= 0x10000;
+    }
+    *utf8Extra = extra8;
+    *utf16Extra = extra16;
+}
+
+//=========================================================================
+// Scalar counting and checking kernels for unicodeLength
+
+size_t scalarUtf8Leads(const char* p, size_t n)
+{
+    size_t continuations;
+    size_t fourByteLeads;
+    scalarUtf8Census(p, n, &continuations, &fourByteLeads);
+    return n - continuations;
+}
+
+size_t scalarUtf16Leads(const char16_t* p, size_t n)
+{
+    size_t seconds = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        seconds += (p[i] & 0xfc00) == 0xdc00;
+    }
+    return n - seconds;
+}
+
+size_t scalarValidUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    return validUtf16From(p, 0, n, lowest);
+}
+
+size_t scalarInRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    return inRangeUcs4From(p, 0, n, lowest, last);
+}
+
+//=========================================================================
+// Ask the CPU (and, for the wide registers, the OS) what it supports.
+
+SimdLevel detectSimdLevel()
+{
+#if defined(ANSAK_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+    if (maxLeaf < 1)
+    {
+        return kSimdScalar;
+    }
+    __cpuid(regs, 1);
+    bool hasSse42 = (regs[2] & (1 << 20)) != 0;
+    bool hasOsXsave = (regs[2] & (1 << 27)) != 0;
+    if (!hasSse42)
+    {
+        return kSimdScalar;
+    }
+    if (!hasOsXsave || maxLeaf < 7)
+    {
+        return kSimdSse42;
+    }
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(regs, 7, 0);
+    bool hasAvx2 = (regs[1] & (1 << 5)) != 0 && (xcr0 & 0x06) == 0x06;
+    bool hasAvx512 = (regs[1] & (1 << 16)) != 0 && (regs[1] & (1 << 30)) != 0 &&
+                     (xcr0 & 0xe6) == 0xe6;
+    return hasAvx512 ? kSimdAvx512 : hasAvx2 ? kSimdAvx2 : kSimdSse42;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    {
+        return kSimdAvx512;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        return kSimdAvx2;
+    }
+    else if (__builtin_cpu_supports("sse4.2"))
+    {
+        return kSimdSse42;
+    }
+    return kSimdScalar;
+#endif
+#elif defined(ANSAK_SIMD_NEON)
+    // Advanced SIMD is part of the AArch64 base architecture
+    return kSimdNeon;
+#else
+    return kSimdScalar;
+#endif
+}
+
+//=========================================================================
+// Map a level onto its kernel set
+
+const SimdKernels* kernelsFor(SimdLevel level)
+{
+    switch (level)
+    {
+    default:            return &scalarKernels;
+#if defined(ANSAK_SIMD_X86)
+    case kSimdSse42:    return &sse42Kernels;
+    case kSimdAvx2:     return &avx2Kernels;
+    case kSimdAvx512:   return &avx512Kernels;
+#endif
+#if defined(ANSAK_SIMD_NEON)
+    case kSimdNeon:     return &neonKernels;
+#endif
+    }
+}
+
+//=========================================================================
+// The process-wide selection, made on first use
+
+struct SimdSelection
+{
+    SimdSelection() : detected(detectSimdLevel()), active(detected), kernels(kernelsFor(detected)) {}
+
+    SimdLevel           detected;
+    SimdLevel           active;
+    const SimdKernels*  kernels;
+};
+
+SimdSelection& selection()
+{
+    static SimdSelection theSelection;
+    return theSelection;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+const SimdKernels scalarKernels = {
+    scalarValidUtf8Prefix,
+    scalarAsciiPrefix,
+    scalarWidenAsciiToUtf16,
+    scalarWidenAsciiToUcs4,
+    scalarUtf8ToWide<char16_t>,
+    scalarUtf8ToWide<char32_t>,
+    scalarToUtf8<char16_t>,
+    scalarToUtf8<char32_t>,
+    scalarUtf16ToUcs4,
+    scalarUcs4ToUtf16,
+    scalarUcs4ToUcs2,
+    scalarLowerAscii<char>,
+    scalarLowerAscii<char16_t>,
+    scalarLowerAscii<char32_t>,
+    scalarUtf8Census,
+    scalarUtf16Census,
+    scalarUcs4Census,
+    scalarUtf8Leads,
+    scalarUtf16Leads,
+    scalarValidUtf16Prefix,
+    scalarInRangeUcs4Prefix
+};
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+const uint8_t* packWordsTable()
+{
+    struct Table
+    {
+        Table() : shuffles()
+        {
+            for (unsigned int mask = 0; mask < 256; ++mask)
+            {
+                unsigned int k = 0;
+                for (unsigned int lane = 0; lane < 8; ++lane)
+                {
+                    if ((mask & (1u << lane)) != 0)
+                    {
+                        shuffles[mask][k++] = static_cast<uint8_t>(2 * lane);
+                        shuffles[mask][k++] = static_cast<uint8_t>(2 * lane + 1);
+                    }
+                }
+                // an index with its top bit set zeroes the byte, for pshufb and tbl alike
+                while (k < 16)
+                {
+                    shuffles[mask][k++] = 0x80;
+                }
+            }
+        }
+
+        uint8_t shuffles[256][16];
+    };
+    static const Table theTable;
+    return theTable.shuffles[0];
+}
+
+const uint8_t* packUtf8Table()
+{
+    struct Table
+    {
+        Table() : shuffles()
+        {
+            for (unsigned int index = 0; index < 256; ++index)
+            {
+                unsigned int k = 0;
+                for (unsigned int lane = 0; lane < 4; ++lane)
+                {
+                    unsigned int length = (index & (0x10u << lane)) != 0 ? 3 :
+                                          (index & (0x01u << lane)) != 0 ? 2 : 1;
+                    for (unsigned int b = 0; b < length && k < 16; ++b)
+                    {
+                        shuffles[index][k++] = static_cast<uint8_t>(4 * lane + b);
+                    }
+                }
+                while (k < 16)
+                {
+                    shuffles[index][k++] = 0x80;
+                }
+            }
+        }
+
+        uint8_t shuffles[256][16];
+    };
+    static const Table theTable;
+    return theTable.shuffles[0];
+}
+
+SimdLevel detectedSimdLevel()
+{
+    return selection().detected;
+}
+
+SimdLevel activeSimdLevel()
+{
+    return selection().active;
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    auto& s = selection();
+    bool sameFamily = (level == kSimdNeon) == (s.detected == kSimdNeon);
+    if (level != kSimdScalar && (!sameFamily || level > s.detected))
+    {
+        level = s.detected;
+    }
+    s.active = level;
+    s.kernels = kernelsFor(level);
+}
+
+size_t validUtf8Prefix(const char* p, size_t n, unsigned char highest)
+{
+    return selection().kernels->validUtf8Prefix(p, n, highest);
+}
+
+size_t asciiPrefix(const char* p, size_t n)
+{
+    return selection().kernels->asciiPrefix(p, n);
+}
+
+void widenAscii(const char* p, size_t n, char16_t* out)
+{
+    selection().kernels->widenAsciiToUtf16(p, n, out);
+}
+
+void widenAscii(const char* p, size_t n, char32_t* out)
+{
+    selection().kernels->widenAsciiToUcs4(p, n, out);
+}
+
+size_t utf8ToUtf16Prefix(const char* p, size_t n, char16_t* out, size_t& produced)
+{
+    return selection().kernels->utf8ToUtf16(p, n, out, &produced);
+}
+
+size_t utf8ToUcs4Prefix(const char* p, size_t n, char32_t* out, size_t& produced)
+{
+    return selection().kernels->utf8ToUcs4(p, n, out, &produced);
+}
+
+size_t utf16ToUtf8Prefix(const char16_t* p, size_t n, char* out, size_t room, size_t& produced)
+{
+    return selection().kernels->utf16ToUtf8(p, n, out, room, &produced);
+}
+
+size_t ucs4ToUtf8Prefix(const char32_t* p, size_t n, char* out, size_t room, size_t& produced)
+{
+    return selection().kernels->ucs4ToUtf8(p, n, out, room, &produced);
+}
+
+size_t utf16ToUcs4Prefix(const char16_t* p, size_t n, char32_t* out, size_t& produced)
+{
+    return selection().kernels->utf16ToUcs4(p, n, out, &produced);
+}
+
+size_t ucs4ToUtf16Prefix(const char32_t* p, size_t n, char16_t* out, size_t room, size_t& produced)
+{
+    return selection().kernels->ucs4ToUtf16(p, n, out, room, &produced);
+}
+
+size_t ucs4ToUcs2Prefix(const char32_t* p, size_t n, char16_t* out)
+{
+    return selection().kernels->ucs4ToUcs2(p, n, out);
+}
+
+size_t lowerAsciiPrefix(const char* p, size_t n, char* out)
+{
+    return selection().kernels->lowerAsciiUtf8(p, n, out);
+}
+
+size_t lowerAsciiPrefix(const char16_t* p, size_t n, char16_t* out)
+{
+    return selection().kernels->lowerAsciiUtf16(p, n, out);
+}
+
+size_t lowerAsciiPrefix(const char32_t* p, size_t n, char32_t* out)
+{
+    return selection().kernels->lowerAsciiUcs4(p, n, out);
+}
+
+size_t utf16Length(const char* p, size_t n)
+{
+    size_t continuations;
+    size_t fourByteLeads;
+    selection().kernels->utf8Census(p, n, &continuations, &fourByteLeads);
+    return n - continuations + fourByteLeads;
+}
+
+size_t ucs4Length(const char* p, size_t n)
+{
+    // a CESU-8 pair has two leads but makes one character; its first half
+    // is 0xed 0xa0-0xaf
+    size_t pairs = 0;
+    auto end = p + n;
+    for (auto q = p; (q = static_cast<const char*>(memchr(q, 0xed, end - q))) != nullptr; ++q)
+    {
+        if (end - q > 1 && (static_cast<unsigned char>(q[1]) & 0xf0) == 0xa0)
+        {
+            ++pairs;
+        }
+    }
+    return leadCount(p, n) - pairs;
+}
+
+size_t utf8Length(const char16_t* p, size_t n)
+{
+    size_t utf8Extra;
+    size_t secondHalves;
+    selection().kernels->utf16Census(p, n, &utf8Extra, &secondHalves);
+    return n + utf8Extra;
+}
+
+size_t ucs4Length(const char16_t* p, size_t n)
+{
+    return leadCount(p, n);
+}
+
+size_t utf8Length(const char32_t* p, size_t n)
+{
+    size_t utf8Extra;
+    size_t utf16Extra;
+    selection().kernels->ucs4Census(p, n, &utf8Extra, &utf16Extra);
+    return n + utf8Extra;
+}
+
+size_t utf16Length(const char32_t* p, size_t n)
+{
+    size_t utf8Extra;
+    size_t utf16Extra;
+    selection().kernels->ucs4Census(p, n, &utf8Extra, &utf16Extra);
+    return n + utf16Extra;
+}
+
+size_t leadCount(const char* p, size_t n)
+{
+    return selection().kernels->utf8Leads(p, n);
+}
+
+size_t leadCount(const char16_t* p, size_t n)
+{
+    return selection().kernels->utf16Leads(p, n);
+}
+
+size_t validUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    return selection().kernels->validUtf16Prefix(p, n, lowest);
+}
+
+size_t inRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    return selection().kernels->inRangeUcs4Prefix(p, n, lowest, last);
+}
+
+}
+
+}
@@ -0,0 +1,678 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_simd.hxx -- vector kernels for the hot loops in string.cxx, chosen
+//                    once at run time from what the CPU reports it can do.
+//                    The scalar loops in string.cxx remain the reference
+//                    implementation; kernels only ever vouch for runs of
+//                    input that the scalar loops would also accept.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// The NEON kernels have yet to be built and tested on AArch64, so they are
+// left out (AArch64 runs the scalar paths) unless ANSAK_NEON asks for them.
+#if !defined(ANSAK_NO_SIMD)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ANSAK_SIMD_X86 1
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(ANSAK_NEON)
+#define ANSAK_SIMD_NEON 1
+#endif
+#endif
+
+// GCC and clang need to be told, function by function, which instructions
+// they may use; MSVC will emit any intrinsic it is handed.
+#if defined(__GNUC__) || defined(__clang__)
+#define ANSAK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ANSAK_TARGET(isa)
+#endif
+
+#define ANSAK_TARGET_SSE42  ANSAK_TARGET("sse4.2")
+#define ANSAK_TARGET_AVX2   ANSAK_TARGET("avx2")
+#define ANSAK_TARGET_AVX512 ANSAK_TARGET("avx512f,avx512bw")
+
+namespace ansak {
+
+namespace internal {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Types
+
+//=========================================================================
+// The instruction set families there are kernels for, in order of
+// preference within a CPU architecture
+
+enum SimdLevel : int {
+    kSimdScalar,
+    kSimdSse42,
+    kSimdAvx2,
+    kSimdAvx512,
+    kSimdNeon
+};
+
+//=========================================================================
+// One set of kernels per SimdLevel. Every member is always filled in; a
+// level with nothing better to offer points at the scalar version.
+
+struct SimdKernels
+{
+    size_t (*validUtf8Prefix)(const char* p, size_t n, unsigned char highest);
+    size_t (*asciiPrefix)(const char* p, size_t n);
+    void (*widenAsciiToUtf16)(const char* p, size_t n, char16_t* out);
+    void (*widenAsciiToUcs4)(const char* p, size_t n, char32_t* out);
+
+    // the prefix that transcodes in vectors (see below); returns units read
+    size_t (*utf8ToUtf16)(const char* p, size_t n, char16_t* out, size_t* produced);
+    size_t (*utf8ToUcs4)(const char* p, size_t n, char32_t* out, size_t* produced);
+    size_t (*utf16ToUtf8)(const char16_t* p, size_t n, char* out, size_t room, size_t* produced);
+    size_t (*ucs4ToUtf8)(const char32_t* p, size_t n, char* out, size_t room, size_t* produced);
+    size_t (*utf16ToUcs4)(const char16_t* p, size_t n, char32_t* out, size_t* produced);
+    size_t (*ucs4ToUtf16)(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced);
+    size_t (*ucs4ToUcs2)(const char32_t* p, size_t n, char16_t* out);
+
+    // the 7-bit prefix copied out with 'A' to 'Z' lower-cased
+    size_t (*lowerAsciiUtf8)(const char* p, size_t n, char* out);
+    size_t (*lowerAsciiUtf16)(const char16_t* p, size_t n, char16_t* out);
+    size_t (*lowerAsciiUcs4)(const char32_t* p, size_t n, char32_t* out);
+
+    // tallies that give the exact size of a conversion's output
+    void (*utf8Census)(const char* p, size_t n, size_t* continuations, size_t* fourByteLeads);
+    void (*utf16Census)(const char16_t* p, size_t n, size_t* utf8Extra, size_t* secondHalves);
+    void (*ucs4Census)(const char32_t* p, size_t n, size_t* utf8Extra, size_t* utf16Extra);
+
+    // units that start a character, and the prefixes unicodeLength can trust
+    size_t (*utf8Leads)(const char* p, size_t n);
+    size_t (*utf16Leads)(const char16_t* p, size_t n);
+    size_t (*validUtf16Prefix)(const char16_t* p, size_t n, char16_t lowest);
+    size_t (*inRangeUcs4Prefix)(const char32_t* p, size_t n, char32_t lowest, char32_t last);
+};
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+//=========================================================================
+// Lookup tables for the three-nibble UTF-8 check (after Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte"). Each pair of
+// adjacent bytes looks up the high and low nibbles of the first byte and
+// the high nibble of the second; if the three results share a bit, that
+// pair is in error. Continuations owed to 3- and 4-byte leads two and
+// three bytes back are checked separately.
+
+namespace utf8check {
+
+const uint8_t kTooShort    = 1 << 0;    // 11______ 0_______ or 11______ 11______
+const uint8_t kTooLong     = 1 << 1;    // 0_______ 10______
+const uint8_t kOverlong3   = 1 << 2;    // 11100000 100_____
+const uint8_t kTooLarge    = 1 << 3;    // 11110100 1001____ and up
+const uint8_t kSurrogate   = 1 << 4;    // 11101101 101_____
+const uint8_t kOverlong2   = 1 << 5;    // 1100000_ 10______
+const uint8_t kTooLarge1000 = 1 << 6;   // 11110101 1000____ and up
+const uint8_t kOverlong4   = 1 << 6;    // 11110000 1000____
+const uint8_t kTwoConts    = 1 << 7;    // 10______ 10______
+const uint8_t kCarry       = kTooShort | kTooLong | kTwoConts;
+
+const uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong,
+    kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+};
+
+const uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000
+};
+
+const uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort
+};
+
+// a block ending in one of these last-three-byte patterns owes the next
+// block continuation bytes: ______ 11110___ / 1110____ __ / 110_____ ___
+const uint8_t kIncompleteMax[16] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+};
+
+}
+
+//=========================================================================
+// For each 8-bit mask, the byte shuffle that gathers the 16-bit lanes of a
+// 16-byte register whose bits are set to its front, in order. Lanes left
+// over are zeroed.
+
+const uint8_t* packWordsTable();
+
+//=========================================================================
+// For four 32-bit lanes each holding a character's UTF-8 bytes (first byte
+// lowest), the byte shuffle that packs those bytes together. It is indexed
+// by a nibble of the lanes holding two bytes, plus a nibble of the lanes
+// holding three shifted up by four; lanes in neither hold one byte.
+
+const uint8_t* packUtf8Table();
+
+//=========================================================================
+// Kernel sets for each instruction set family this build knows about
+
+extern const SimdKernels scalarKernels;
+#if defined(ANSAK_SIMD_X86)
+extern const SimdKernels sse42Kernels;
+extern const SimdKernels avx2Kernels;
+extern const SimdKernels avx512Kernels;
+#endif
+#if defined(ANSAK_SIMD_NEON)
+extern const SimdKernels neonKernels;
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// The best level the CPU running this process supports, and the level in
+// use (normally the same). setSimdLevel lets unit tests and benchmarks
+// force a lower level; requests above the detected level are clamped to
+// it. It is not meant to be called while other threads use the library.
+
+SimdLevel detectedSimdLevel();
+SimdLevel activeSimdLevel();
+void setSimdLevel(SimdLevel level);
+
+//=========================================================================
+// Length of the longest prefix of p[0..n) that is entirely well-formed
+// UTF-8 (RFC 3629 -- no surrogates, no overlongs, nothing past U+10FFFF),
+// ends on a character boundary and contains no byte above "highest"
+// (0x7f restricts to ASCII, 0xef to the BMP, 0xff restricts nothing).
+// A short result does not mean p[result] is invalid, only that the
+// caller's own loop must decide from there.
+
+size_t validUtf8Prefix(const char* p, size_t n, unsigned char highest);
+
+//=========================================================================
+// Length of the longest prefix of p[0..n) holding only 7-bit values (a
+// 0x00 counts as one -- callers bound n short of any terminator)
+
+size_t asciiPrefix(const char* p, size_t n);
+
+//=========================================================================
+// Copy n bytes, known to be 7-bit, out to n wider code units
+
+void widenAscii(const char* p, size_t n, char16_t* out);
+void widenAscii(const char* p, size_t n, char32_t* out);
+
+//=========================================================================
+// Transcode the longest prefix of p[0..n) that is well-formed UTF-8 (RFC
+// 3629 -- no surrogates, so no CESU-8 either) into out, which must have
+// room for n units -- the prefix never produces more units than it has
+// bytes. To UTF-16 the prefix holds only whole characters from the BMP,
+// which UCS-2 can take too; to UCS-4 the vectors take those and 4-byte
+// characters are done one at a time. Kernels may stop short of the longest
+// such prefix; the caller's own loop goes on from wherever they stop.
+//
+// Returns the length of the prefix in bytes; produced gets the units
+// written.
+
+size_t utf8ToUtf16Prefix(const char* p, size_t n, char16_t* out, size_t& produced);
+size_t utf8ToUcs4Prefix(const char* p, size_t n, char32_t* out, size_t& produced);
+
+//=========================================================================
+// Transcode the longest prefix of p[0..n) that is well-formed UTF-16 into
+// out, writing no more than room bytes. Surrogate pairs are done a unit
+// at a time; the vectors only take what lies between them. As above,
+// kernels may stop short: at a lone half, and wherever room runs short.
+//
+// Returns the length of the prefix in units; produced gets the bytes
+// written.
+
+size_t utf16ToUtf8Prefix(const char16_t* p, size_t n, char* out, size_t room, size_t& produced);
+
+//=========================================================================
+// Transcode the longest prefix of p[0..n) that UTF-8 can hold -- no
+// surrogates, nothing above 0x7fffffff -- into out, writing no more than
+// room bytes. The vectors take characters from the BMP; the rest are done
+// a character at a time. As above, kernels may stop short.
+//
+// Returns the length of the prefix in characters; produced gets the bytes
+// written.
+
+size_t ucs4ToUtf8Prefix(const char32_t* p, size_t n, char* out, size_t room, size_t& produced);
+
+//=========================================================================
+// Transcode the longest prefix of p[0..n) that is well-formed UTF-16 into
+// out, which must have room for n characters. A pair cut off by n is left
+// out of the prefix, as is a lone half.
+//
+// Returns the length of the prefix in units; produced gets the characters
+// written.
+
+size_t utf16ToUcs4Prefix(const char16_t* p, size_t n, char32_t* out, size_t& produced);
+
+//=========================================================================
+// Transcode the longest prefix of p[0..n) that UTF-16 can hold -- no
+// surrogates, nothing above U+10FFFF -- into out, writing no more than room
+// units. Kernels may stop short where room runs short.
+//
+// Returns the length of the prefix in characters; produced gets the units
+// written.
+
+size_t ucs4ToUtf16Prefix(const char32_t* p, size_t n, char16_t* out, size_t room, size_t& produced);
+
+//=========================================================================
+// Narrow the longest prefix of p[0..n) that UCS-2 can hold -- no surrogates,
+// nothing above U+FFFF -- into out, which must have room for n units, and
+// return its length. Units of out past the prefix (but short of n) may
+// have been written too.
+
+size_t ucs4ToUcs2Prefix(const char32_t* p, size_t n, char16_t* out);
+
+//=========================================================================
+// Copy the longest 7-bit prefix of p[0..n) to out, lower-casing 'A' to 'Z'
+// on the way, and return its length. Units of out past the prefix (but
+// short of n) may have been written too; callers overwrite them.
+
+size_t lowerAsciiPrefix(const char* p, size_t n, char* out);
+size_t lowerAsciiPrefix(const char16_t* p, size_t n, char16_t* out);
+size_t lowerAsciiPrefix(const char32_t* p, size_t n, char32_t* out);
+
+//=========================================================================
+// Exact length, in units of the target, of converting n well-formed units
+// of the source. Input that isn't well-formed gets a length that may be
+// too long but is never too short for what converts before the problem.
+
+size_t utf16Length(const char* p, size_t n);
+size_t ucs4Length(const char* p, size_t n);
+size_t utf8Length(const char16_t* p, size_t n);
+size_t ucs4Length(const char16_t* p, size_t n);
+size_t utf8Length(const char32_t* p, size_t n);
+size_t utf16Length(const char32_t* p, size_t n);
+
+//=========================================================================
+// Units of p[0..n) that start a character: bytes that aren't continuations,
+// units that aren't second halves. For well-formed UTF-16, and UTF-8 with
+// no CESU-8 pairs, that's the number of code points.
+
+size_t leadCount(const char* p, size_t n);
+size_t leadCount(const char16_t* p, size_t n);
+
+//=========================================================================
+// Length of the longest prefix of p[0..n) that is well-formed UTF-16 with
+// no unit below lowest (1 to stop at a null), a pair cut off by n left out
+
+size_t validUtf16Prefix(const char16_t* p, size_t n, char16_t lowest);
+
+//=========================================================================
+// Length of the longest prefix of p[0..n) with no surrogates and nothing
+// below lowest or above last
+
+size_t inRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last);
+
+//=========================================================================
+// Index of the lowest set bit of a non-zero mask
+
+inline unsigned int lowestSetBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long r;
+#if defined(_M_IX86)
+    if (static_cast<uint32_t>(mask) != 0)
+    {
+        _BitScanForward(&r, static_cast<uint32_t>(mask));
+        return r;
+    }
+    _BitScanForward(&r, static_cast<uint32_t>(mask >> 32));
+    return r + 32;
+#else
+    _BitScanForward64(&r, mask);
+    return r;
+#endif
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(mask));
+#endif
+}
+
+//=========================================================================
+// Number of set bits in a mask
+
+inline unsigned int popCount(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    // __popcnt64 needs a CPU with POPCNT; add up bits within the word instead
+    mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+    mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+    mask = (mask + (mask >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<unsigned int>((mask * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<unsigned int>(__builtin_popcountll(mask));
+#endif
+}
+
+//=========================================================================
+// Finish lowerAsciiPrefix a unit at a time from offset i, for the kernels'
+// tails
+
+template<typename C>
+inline size_t lowerAsciiFrom(const C* p, size_t i, size_t n, C* out)
+{
+    for ( ; i < n; ++i)
+    {
+        auto u = static_cast<uint32_t>(p[i]) & (sizeof(C) == 1 ? 0xff : 0xffffffff);
+        if (u >= 0x80)
+        {
+            break;
+        }
+        out[i] = static_cast<C>(u - 'A' < 26 ? u + 0x20 : u);
+    }
+    return i;
+}
+
+//=========================================================================
+// A four-lane mask spread out over the even bits of an eight-lane one, for
+// the 16-bit pairs of 32-bit lanes in packWordsTable
+
+inline unsigned int spreadLanes(unsigned int lanes)
+{
+    return (lanes & 1) | ((lanes & 2) << 1) | ((lanes & 4) << 2) | ((lanes & 8) << 3);
+}
+
+//=========================================================================
+// A first half shifted up ten bits, plus its second half, comes to the
+// character they make plus this
+
+const uint32_t kUtf16PairOffset = (0xd800u << 10) + 0xdc00u - 0x10000u;
+
+//=========================================================================
+// Where a step of UTF-16 has to stop, given a bit for each first half and
+// each second half in it: before the first lone half (or unit whose bit is
+// set in refused), or short of a first half whose second is past the end
+// of the step. lone says which.
+
+inline size_t pairedStop(uint64_t firsts, uint64_t seconds, size_t step, bool& lone, uint64_t refused = 0)
+{
+    uint64_t unmatched = ((seconds ^ (firsts << 1)) | refused) & (step == 64 ? ~0ull : (1ull << step) - 1);
+    lone = unmatched != 0;
+    size_t stop = lone ? lowestSetBit(unmatched) : step;
+    if (stop > 0 && ((firsts >> (stop - 1)) & 1) != 0)
+    {
+        --stop;
+    }
+    return stop;
+}
+
+//=========================================================================
+// Finish validUtf16Prefix a unit at a time, from i
+
+inline size_t validUtf16From(const char16_t* p, size_t i, size_t n, char16_t lowest)
+{
+    while (i < n)
+    {
+        auto c = p[i];
+        if (c < lowest)
+        {
+            break;
+        }
+        else if ((c & 0xf800) != 0xd800)
+        {
+            ++i;
+        }
+        else if ((c & 0xfc00) == 0xd800 && i + 1 < n && (p[i + 1] & 0xfc00) == 0xdc00)
+        {
+            i += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+//=========================================================================
+// Finish inRangeUcs4Prefix a character at a time, from i
+
+inline size_t inRangeUcs4From(const char32_t* p, size_t i, size_t n, char32_t lowest, char32_t last)
+{
+    for ( ; i < n && p[i] >= lowest && p[i] <= last && (p[i] & 0xfffff800) != 0xd800; ++i)
+    {
+    }
+    return i;
+}
+
+//=========================================================================
+// Finish utf16ToUcs4Prefix a character at a time from offset i, for the
+// kernels' tails; returns where it stopped
+
+inline size_t utf16ToUcs4From(const char16_t* p, size_t i, size_t n, char32_t* out, size_t& o)
+{
+    while (i < n)
+    {
+        char32_t c = p[i];
+        if ((c & 0xf800) == 0xd800)
+        {
+            if (c >= 0xdc00 || i + 1 >= n || (p[i + 1] & 0xfc00) != 0xdc00)
+            {
+                break;
+            }
+            c = 0x10000 + ((c - 0xd800) << 10) + (p[i + 1] - 0xdc00);
+            ++i;
+        }
+        out[o++] = c;
+        ++i;
+    }
+    return i;
+}
+
+//=========================================================================
+// Finish ucs4ToUtf16Prefix (last 0x10ffff) or ucs4ToUcs2Prefix (last 0xffff,
+// room n) a character at a time from offset i; returns where it stopped
+
+inline size_t ucs4ToUtf16From
+(
+    const char32_t*         p,          // I - the source
+    size_t                  i,          // I - where to start
+    size_t                  n,          // I - the length of the source
+    char16_t*               out,        // O - the destination
+    size_t                  room,       // I - the size of the destination
+    size_t&                 o,          // I/O - units written to it so far
+    char32_t                last        // I - the highest character the target holds
+)
+{
+    for ( ; i < n; ++i)
+    {
+        char32_t c = p[i];
+        if ((c & 0xfffff800) == 0xd800 || c > last || o + 1 + (c >= 0x10000) > room)
+        {
+            break;
+        }
+        if (c >= 0x10000)
+        {
+            out[o++] = static_cast<char16_t>(0xd800 + ((c - 0x10000) >> 10));
+            c = 0xdc00 + (c & 0x3ff);
+        }
+        out[o++] = static_cast<char16_t>(c);
+    }
+    return i;
+}
+
+//=========================================================================
+// Decode p[i..stop), already checked to be well-formed UTF-8, a character
+// at a time into out, for the kernels
+
+template<typename C>
+inline void checkedUtf8Through
+(
+    const char*             p,          // I - the source
+    size_t                  i,          // I - where to start
+    size_t                  stop,       // I - where to stop, on a character boundary
+    C*                      out,        // O - the destination
+    size_t&                 o           // I/O - units written to it so far
+)
+{
+    auto u = reinterpret_cast<const unsigned char*>(p);
+    while (i < stop)
+    {
+        char32_t c = u[i];
+        if (c < 0x80)
+        {
+            i += 1;
+        }
+        else if (c < 0xe0)
+        {
+            c = ((c & 0x1f) << 6) | (u[i + 1] & 0x3f);
+            i += 2;
+        }
+        else if (c < 0xf0)
+        {
+            c = ((c & 0x0f) << 12) | ((u[i + 1] & 0x3f) << 6) | (u[i + 2] & 0x3f);
+            i += 3;
+        }
+        else
+        {
+            c = ((c & 0x07) << 18) | ((u[i + 1] & 0x3f) << 12) | ((u[i + 2] & 0x3f) << 6) |
+                (u[i + 3] & 0x3f);
+            i += 4;
+        }
+        out[o++] = static_cast<C>(c);
+    }
+}
+
+//=========================================================================
+// Encode p[i..n) as UTF-8 a character at a time, for the kernels, until i
+// reaches stop or goes past a surrogate pair at it.
+//
+// Returns false, leaving i at the character, at a lone half (any half, in
+// UCS-4), past 0x7fffffff or when the next character won't fit in room.
+
+template<typename C>
+inline bool toUtf8Through
+(
+    const C*                p,          // I - the source, UTF-16 or UCS-4
+    size_t&                 i,          // I/O - where to start, then where it stopped
+    size_t                  stop,       // I - where to stop
+    size_t                  n,          // I - the length of the source
+    char*                   out,        // O - the destination
+    size_t                  room,       // I - the size of the destination
+    size_t&                 o           // I/O - bytes written to it so far
+)
+{
+    while (i < stop)
+    {
+        char32_t c = p[i];
+        size_t units = 1;
+        if ((c & 0xfffff800) == 0xd800)
+        {
+            if (sizeof(C) != 2 || c >= 0xdc00 || i + 1 >= n || (p[i + 1] & 0xfc00) != 0xdc00)
+            {
+                return false;
+            }
+            c = 0x10000 + ((c - 0xd800) << 10) + (p[i + 1] - 0xdc00);
+            units = 2;
+        }
+        else if (c >= 0x80000000)
+        {
+            return false;
+        }
+        size_t length = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 :
+                        c < 0x200000 ? 4 : c < 0x4000000 ? 5 : 6;
+        if (o + length > room)
+        {
+            return false;
+        }
+        static const unsigned char kLeads[] = { 0, 0, 0xc0, 0xe0, 0xf0, 0xf8, 0xfc };
+        for (auto k = length - 1; k > 0; --k)
+        {
+            out[o + k] = static_cast<char>(0x80 | (c & 0x3f));
+            c >>= 6;
+        }
+        out[o] = static_cast<char>(kLeads[length] | c);
+        i += units;
+        o += length;
+    }
+    return true;
+}
+
+//=========================================================================
+// Walk an offset in p back to the start of the character straddling it,
+// so that everything before the result is whole characters.
+
+inline size_t backUpToCharacterStart(const char* p, size_t offset)
+{
+    size_t r = offset;
+    while (r > 0 && offset - r < 3 && (static_cast<unsigned char>(p[r - 1]) & 0xc0) == 0x80)
+    {
+        --r;
+    }
+    if (r > 0 && static_cast<unsigned char>(p[r - 1]) >= 0xc0)
+    {
+        --r;
+    }
+    return r;
+}
+
+}
+
+}
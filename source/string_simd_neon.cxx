@@ -0,0 +1,873 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_simd_neon.cxx -- AArch64 Advanced SIMD (NEON) kernels. NEON is
+//                         part of the base architecture, so no run-time
+//                         check or target attribute is needed.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string_simd.hxx"
+
+#if defined(ANSAK_SIMD_NEON)
+
+#include <arm_neon.h>
+
+#include <algorithm>
+
+namespace ansak {
+
+namespace internal {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Returns non-zero lanes wherever input, read after prevInput, breaks the
+// rules of UTF-8 or holds a byte above highest
+
+inline uint8x16_t neonUtf8Errors(uint8x16_t input, uint8x16_t prevInput, uint8x16_t highest)
+{
+    using namespace utf8check;
+
+    uint8x16_t prev1 = vextq_u8(prevInput, input, 15);
+    uint8x16_t prev2 = vextq_u8(prevInput, input, 14);
+    uint8x16_t prev3 = vextq_u8(prevInput, input, 13);
+
+    uint8x16_t byte1High = vqtbl1q_u8(vld1q_u8(kByte1High), vshrq_n_u8(prev1, 4));
+    uint8x16_t byte1Low = vqtbl1q_u8(vld1q_u8(kByte1Low), vandq_u8(prev1, vdupq_n_u8(0x0f)));
+    uint8x16_t byte2High = vqtbl1q_u8(vld1q_u8(kByte2High), vshrq_n_u8(input, 4));
+    uint8x16_t special = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+
+    uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0x60)),
+                                 vqsubq_u8(prev3, vdupq_n_u8(0x70)));
+    uint8x16_t must23As80 = vandq_u8(must23, vdupq_n_u8(0x80));
+
+    return vorrq_u8(veorq_u8(must23As80, special), vqsubq_u8(input, highest));
+}
+
+//=========================================================================
+// four 16-byte registers per step
+
+size_t neonValidUtf8Prefix(const char* p, size_t n, unsigned char highest)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    const uint8x16_t highestV = vdupq_n_u8(highest);
+    const uint8x16_t incompleteMax = vld1q_u8(utf8check::kIncompleteMax);
+    uint8x16_t prevInput = vdupq_n_u8(0);
+    uint8x16_t prevIncomplete = vdupq_n_u8(0);
+
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        uint8x16_t in0 = vld1q_u8(u + i);
+        uint8x16_t in1 = vld1q_u8(u + i + 16);
+        uint8x16_t in2 = vld1q_u8(u + i + 32);
+        uint8x16_t in3 = vld1q_u8(u + i + 48);
+        uint8x16_t errors;
+        if (vmaxvq_u8(vorrq_u8(vorrq_u8(in0, in1), vorrq_u8(in2, in3))) < 0x80)
+        {
+            errors = prevIncomplete;
+            prevIncomplete = vdupq_n_u8(0);
+        }
+        else
+        {
+            errors = vorrq_u8(vorrq_u8(neonUtf8Errors(in0, prevInput, highestV),
+                                       neonUtf8Errors(in1, in0, highestV)),
+                              vorrq_u8(neonUtf8Errors(in2, in1, highestV),
+                                       neonUtf8Errors(in3, in2, highestV)));
+            prevIncomplete = vqsubq_u8(in3, incompleteMax);
+        }
+        if (vmaxvq_u8(errors) != 0)
+        {
+            break;
+        }
+        prevInput = in3;
+    }
+
+    return backUpToCharacterStart(p, i);
+}
+
+//=========================================================================
+// Runs of ASCII, 64 bytes a step; the 16-byte block holding the first
+// non-ASCII byte is finished by hand
+
+size_t neonAsciiPrefix(const char* p, size_t n)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        uint8x16_t any = vorrq_u8(vorrq_u8(vld1q_u8(u + i), vld1q_u8(u + i + 16)),
+                                  vorrq_u8(vld1q_u8(u + i + 32), vld1q_u8(u + i + 48)));
+        if (vmaxvq_u8(any) >= 0x80)
+        {
+            break;
+        }
+    }
+    while (i < n && u[i] < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+void neonWidenAsciiToUtf16(const char* p, size_t n, char16_t* out)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    uint16_t* o = reinterpret_cast<uint16_t*>(out);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        uint8x16_t in = vld1q_u8(u + i);
+        vst1q_u16(o + i, vmovl_u8(vget_low_u8(in)));
+        vst1q_u16(o + i + 8, vmovl_u8(vget_high_u8(in)));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char16_t>(u[i]);
+    }
+}
+
+void neonWidenAsciiToUcs4(const char* p, size_t n, char32_t* out)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    uint32_t* o = reinterpret_cast<uint32_t*>(out);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        uint8x16_t in = vld1q_u8(u + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(in));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(in));
+        vst1q_u32(o + i, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(o + i + 4, vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32(o + i + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(o + i + 12, vmovl_u16(vget_high_u16(hi)));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char32_t>(u[i]);
+    }
+}
+
+//=========================================================================
+// Transcoding UTF-8 to UTF-16 or UCS-4 a 16-byte step at a time, as the x86
+// kernels do: check the step, decode every byte as though it led a
+// character, then pack the lanes that really do lead one through a table
+// lookup
+
+// a bit for each lane of a comparison's result
+inline uint32_t neonLaneBits(uint8x16_t lanes)
+{
+    static const uint8_t kBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t bits = vandq_u8(lanes, vld1q_u8(kBits));
+    return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+
+// eight 16-bit lanes stored as units of either width
+inline void neonStoreWords(uint16x8_t words, char16_t* out)
+{
+    vst1q_u16(reinterpret_cast<uint16_t*>(out), words);
+}
+
+inline void neonStoreWords(uint16x8_t words, char32_t* out)
+{
+    vst1q_u32(reinterpret_cast<uint32_t*>(out), vmovl_u16(vget_low_u16(words)));
+    vst1q_u32(reinterpret_cast<uint32_t*>(out + 4), vmovl_u16(vget_high_u16(words)));
+}
+
+template<typename C>
+inline size_t neonPackLeads
+(
+    uint16x8_t              b0,         // I - eight bytes, widened
+    uint16x8_t              b1,         // I - the bytes one on from them
+    uint16x8_t              b2,         // I - and two on from them
+    uint32_t                leads,      // I - which of the eight lead characters
+    const uint8_t*          pack,       // I - packWordsTable()
+    C*                      out         // O - where to put those characters
+)
+{
+    const uint16x8_t low6 = vdupq_n_u16(0x3f);
+    uint16x8_t two = vorrq_u16(vshlq_n_u16(vandq_u16(b0, vdupq_n_u16(0x1f)), 6), vandq_u16(b1, low6));
+    uint16x8_t three = vorrq_u16(vorrq_u16(vshlq_n_u16(b0, 12), vshlq_n_u16(vandq_u16(b1, low6), 6)),
+                                 vandq_u16(b2, low6));
+    uint16x8_t v = vbslq_u16(vcltq_u16(b0, vdupq_n_u16(0x80)), b0, two);
+    v = vbslq_u16(vcgtq_u16(b0, vdupq_n_u16(0xdf)), three, v);
+    uint8x16_t packed = vqtbl1q_u8(vreinterpretq_u8_u16(v), vld1q_u8(pack + 16 * leads));
+    neonStoreWords(vreinterpretq_u16_u8(packed), out);
+    return popCount(leads);
+}
+
+template<typename C>
+size_t neonUtf8ToWide(const char* p, size_t n, C* out, size_t* produced)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    const uint8_t* pack = packWordsTable();
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t highest = vdupq_n_u8(sizeof(C) == 2 ? 0xef : 0xff);
+    const uint8x16_t incompleteMax = vld1q_u8(utf8check::kIncompleteMax);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n)
+    {
+        uint8x16_t in = vld1q_u8(u + i);
+        if (vmaxvq_u8(in) < 0x80)
+        {
+            neonStoreWords(vmovl_u8(vget_low_u8(in)), out + o);
+            neonStoreWords(vmovl_u8(vget_high_u8(in)), out + o + 8);
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        // every step starts on a character, so nothing is owed from before it
+        uint8x16_t errors = neonUtf8Errors(in, zero, highest);
+        uint32_t bad = neonLaneBits(vtstq_u8(errors, errors));
+        size_t stop = 16;
+        if (bad != 0)
+        {
+            stop = backUpToCharacterStart(p + i, lowestSetBit(bad));
+        }
+        else if (vmaxvq_u8(vqsubq_u8(in, incompleteMax)) != 0)
+        {
+            stop = backUpToCharacterStart(p + i, 16);
+        }
+        uint32_t fours = neonLaneBits(vcgeq_u8(in, vdupq_n_u8(0xf0))) & ((1u << stop) - 1);
+        size_t vectorStop = fours == 0 ? stop : lowestSetBit(fours);
+        uint32_t leads = neonLaneBits(vmvnq_u8(vceqq_u8(vandq_u8(in, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80)))) &
+                         ((1u << vectorStop) - 1);
+
+        uint8x16_t b1 = vextq_u8(in, zero, 1);
+        uint8x16_t b2 = vextq_u8(in, zero, 2);
+        o += neonPackLeads(vmovl_u8(vget_low_u8(in)), vmovl_u8(vget_low_u8(b1)), vmovl_u8(vget_low_u8(b2)),
+                           leads & 0xff, pack, out + o);
+        o += neonPackLeads(vmovl_u8(vget_high_u8(in)), vmovl_u8(vget_high_u8(b1)), vmovl_u8(vget_high_u8(b2)),
+                           leads >> 8, pack, out + o);
+        checkedUtf8Through(p, i + vectorStop, i + stop, out, o);
+        i += stop;
+        if (bad != 0)
+        {
+            break;
+        }
+    }
+
+    for ( ; i < n && u[i] < 0x80; ++i)
+    {
+        out[o++] = static_cast<C>(u[i]);
+    }
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// Transcoding UTF-16 or UCS-4 to UTF-8 four characters at a time, as the
+// x86 kernels do
+
+inline size_t neonPackUtf8
+(
+    uint32x4_t              c,          // I - four characters, one to a 32-bit lane
+    const uint8_t*          table,      // I - packUtf8Table()
+    char*                   out         // O - where to put their UTF-8
+)
+{
+    static const uint32_t kLaneBits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t low6 = vdupq_n_u32(0x3f);
+    uint32x4_t twoOrMore = vcgtq_u32(c, vdupq_n_u32(0x7f));
+    uint32x4_t three = vcgtq_u32(c, vdupq_n_u32(0x7ff));
+    uint32x4_t asTwo = vorrq_u32(vorrq_u32(vshrq_n_u32(c, 6), vshlq_n_u32(vandq_u32(c, low6), 8)),
+                                 vdupq_n_u32(0x80c0));
+    uint32x4_t asThree = vorrq_u32(vorrq_u32(vshrq_n_u32(c, 12),
+                                             vshlq_n_u32(vandq_u32(vshrq_n_u32(c, 6), low6), 8)),
+                                   vorrq_u32(vshlq_n_u32(vandq_u32(c, low6), 16), vdupq_n_u32(0x8080e0)));
+    uint32x4_t bytes = vbslq_u32(three, asThree, vbslq_u32(twoOrMore, asTwo, c));
+
+    uint32x4_t laneBits = vld1q_u32(kLaneBits);
+    uint32_t twos = vaddvq_u32(vandq_u32(twoOrMore, laneBits));
+    uint32_t threes = vaddvq_u32(vandq_u32(three, laneBits));
+    uint8x16_t shuffle = vld1q_u8(table + 16 * ((twos & ~threes) | (threes << 4)));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vqtbl1q_u8(vreinterpretq_u8_u32(bytes), shuffle));
+    return 4 + popCount(twos) + popCount(threes);
+}
+
+size_t neonUtf16ToUtf8(const char16_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    const uint8_t* table = packUtf8Table();
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n && o + 16 <= room)
+    {
+        uint16x8_t u0 = vld1q_u16(u + i);
+        uint16x8_t u1 = vld1q_u16(u + i + 8);
+        if (vmaxvq_u16(vorrq_u16(u0, u1)) < 0x80)
+        {
+            vst1q_u8(reinterpret_cast<uint8_t*>(out + o), vcombine_u8(vmovn_u16(u0), vmovn_u16(u1)));
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        // each group of four makes up to twelve bytes, and stores sixteen
+        if (o + 3 * 16 + 4 > room)
+        {
+            break;
+        }
+        size_t groups = 0;
+        for ( ; groups < 4; ++groups)
+        {
+            uint16x4_t units = vld1_u16(u + i + 4 * groups);
+            if (vmaxv_u16(vceq_u16(vand_u16(units, vdup_n_u16(0xf800)), vdup_n_u16(0xd800))) != 0)
+            {
+                break;
+            }
+            o += neonPackUtf8(vmovl_u16(units), table, out + o);
+        }
+        i += 4 * groups;
+        // a group holding a surrogate goes a character at a time
+        if (groups < 4 && !toUtf8Through(p, i, i + 4, n, out, room, o))
+        {
+            break;
+        }
+    }
+
+    for ( ; i < n && o < room && u[i] < 0x80; ++i)
+    {
+        out[o++] = static_cast<char>(u[i]);
+    }
+    *produced = o;
+    return i;
+}
+
+size_t neonUcs4ToUtf8(const char32_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    const uint8_t* table = packUtf8Table();
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n && o + 16 <= room)
+    {
+        uint32x4_t c[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            c[k] = vld1q_u32(u + i + 4 * k);
+        }
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(c[0], c[1]), vorrq_u32(c[2], c[3]))) < 0x80)
+        {
+            uint16x8_t lo = vcombine_u16(vmovn_u32(c[0]), vmovn_u32(c[1]));
+            uint16x8_t hi = vcombine_u16(vmovn_u32(c[2]), vmovn_u32(c[3]));
+            vst1q_u8(reinterpret_cast<uint8_t*>(out + o), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        if (o + 3 * 16 + 4 > room)
+        {
+            break;
+        }
+        size_t groups = 0;
+        for ( ; groups < 4; ++groups)
+        {
+            uint32x4_t half = vceqq_u32(vandq_u32(c[groups], vdupq_n_u32(0xfffff800)), vdupq_n_u32(0xd800));
+            if (vmaxvq_u32(c[groups]) > 0xffff || vmaxvq_u32(half) != 0)
+            {
+                break;
+            }
+            o += neonPackUtf8(c[groups], table, out + o);
+        }
+        i += 4 * groups;
+        // a group beyond the BMP or holding a half goes a character at a time
+        if (groups < 4 && !toUtf8Through(p, i, i + 4, n, out, room, o))
+        {
+            break;
+        }
+    }
+
+    for ( ; i < n && o < room && u[i] < 0x80; ++i)
+    {
+        out[o++] = static_cast<char>(u[i]);
+    }
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// Transcoding between UTF-16 and UCS-4 eight units at a time, as the x86
+// kernels do: pairs put together (or split) in 32-bit lanes, and the lanes
+// packed through packWordsTable
+
+// a bit for each lane of a 16-bit comparison's result
+inline uint32_t neonUnitBits(uint16x8_t lanes)
+{
+    static const uint16_t kBits[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    return vaddvq_u16(vandq_u16(lanes, vld1q_u16(kBits)));
+}
+
+// a bit for each lane of a 32-bit comparison's result
+inline uint32_t neonQuadBits(uint32x4_t lanes)
+{
+    static const uint32_t kBits[4] = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(lanes, vld1q_u32(kBits)));
+}
+
+// a 16-bit comparison's result for four lanes, widened to 32 bits
+inline uint32x4_t neonWidenMask(uint16x4_t lanes)
+{
+    return vreinterpretq_u32_s32(vmovl_s16(vreinterpret_s16_u16(lanes)));
+}
+
+size_t neonUtf16ToUcs4(const char16_t* p, size_t n, char32_t* out, size_t* produced)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    uint8_t* o8 = reinterpret_cast<uint8_t*>(out);
+    const uint8_t* pack = packWordsTable();
+    const uint32x4_t pairOffset = vdupq_n_u32(kUtf16PairOffset);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 8 <= n)
+    {
+        uint16x8_t in = vld1q_u16(u + i);
+        uint32x4_t w0 = vmovl_u16(vget_low_u16(in));
+        uint32x4_t w1 = vmovl_u16(vget_high_u16(in));
+        uint16x8_t sides = vandq_u16(in, vdupq_n_u16(0xfc00));
+        uint16x8_t firstLanes = vceqq_u16(sides, vdupq_n_u16(0xd800));
+        uint16x8_t secondLanes = vceqq_u16(sides, vdupq_n_u16(0xdc00));
+        if (vmaxvq_u16(vorrq_u16(firstLanes, secondLanes)) == 0)
+        {
+            vst1q_u32(reinterpret_cast<uint32_t*>(out + o), w0);
+            vst1q_u32(reinterpret_cast<uint32_t*>(out + o + 4), w1);
+            i += 8;
+            o += 8;
+            continue;
+        }
+
+        auto seconds = neonUnitBits(secondLanes);
+        bool lone = false;
+        auto stop = pairedStop(neonUnitBits(firstLanes), seconds, 8, lone);
+
+        uint16x8_t next = vextq_u16(in, vdupq_n_u16(0), 1);
+        uint32x4_t pair0 = vsubq_u32(vaddq_u32(vshlq_n_u32(w0, 10), vmovl_u16(vget_low_u16(next))), pairOffset);
+        uint32x4_t pair1 = vsubq_u32(vaddq_u32(vshlq_n_u32(w1, 10), vmovl_u16(vget_high_u16(next))), pairOffset);
+        w0 = vbslq_u32(neonWidenMask(vget_low_u16(firstLanes)), pair0, w0);
+        w1 = vbslq_u32(neonWidenMask(vget_high_u16(firstLanes)), pair1, w1);
+        auto keep = ~seconds & ((1u << stop) - 1);
+        vst1q_u8(o8 + 4 * o, vqtbl1q_u8(vreinterpretq_u8_u32(w0),
+                                        vld1q_u8(pack + 16 * (3 * spreadLanes(keep & 0x0f)))));
+        o += popCount(keep & 0x0f);
+        vst1q_u8(o8 + 4 * o, vqtbl1q_u8(vreinterpretq_u8_u32(w1),
+                                        vld1q_u8(pack + 16 * (3 * spreadLanes(keep >> 4)))));
+        o += popCount(keep >> 4);
+        i += stop;
+        if (lone)
+        {
+            break;
+        }
+    }
+
+    i = utf16ToUcs4From(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+// a bit for each of four characters UTF-16 (last 0x10ffff) or UCS-2 (last
+// 0xffff) can't hold
+inline uint32_t neonRefused(uint32x4_t c, uint32_t last)
+{
+    uint32x4_t half = vceqq_u32(vandq_u32(c, vdupq_n_u32(0xfffff800)), vdupq_n_u32(0xd800));
+    return neonQuadBits(vorrq_u32(vcgtq_u32(c, vdupq_n_u32(last)), half));
+}
+
+// the first live of four characters out as UTF-16
+inline size_t neonPackPairs(uint32x4_t c, uint32_t live, const uint8_t* pack, char16_t* out)
+{
+    uint32x4_t beyond = vcgtq_u32(c, vdupq_n_u32(0xffff));
+    uint32x4_t first = vaddq_u32(vshrq_n_u32(vsubq_u32(c, vdupq_n_u32(0x10000)), 10), vdupq_n_u32(0xd800));
+    uint32x4_t second = vorrq_u32(vandq_u32(c, vdupq_n_u32(0x3ff)), vdupq_n_u32(0xdc00));
+    uint32x4_t units = vbslq_u32(beyond, vorrq_u32(first, vshlq_n_u32(second, 16)), c);
+
+    auto pairs = neonQuadBits(beyond) & live;
+    auto keep = spreadLanes(live) | (spreadLanes(pairs) << 1);
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vqtbl1q_u8(vreinterpretq_u8_u32(units), vld1q_u8(pack + 16 * keep)));
+    return popCount(live) + popCount(pairs);
+}
+
+size_t neonUcs4ToUtf16(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    const uint8_t* pack = packWordsTable();
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 8 <= n && o + 16 <= room)
+    {
+        uint32x4_t c0 = vld1q_u32(u + i);
+        uint32x4_t c1 = vld1q_u32(u + i + 4);
+        auto refused = neonRefused(c0, 0x10ffff) | (neonRefused(c1, 0x10ffff) << 4);
+        if (refused == 0 && vmaxvq_u32(vmaxq_u32(c0, c1)) <= 0xffff)
+        {
+            vst1q_u16(reinterpret_cast<uint16_t*>(out + o), vcombine_u16(vmovn_u32(c0), vmovn_u32(c1)));
+            i += 8;
+            o += 8;
+            continue;
+        }
+
+        auto stop = refused == 0 ? 8 : lowestSetBit(refused);
+        auto live = (1u << stop) - 1;
+        o += neonPackPairs(c0, live & 0x0f, pack, out + o);
+        o += neonPackPairs(c1, live >> 4, pack, out + o);
+        i += stop;
+        if (refused != 0)
+        {
+            break;
+        }
+    }
+
+    i = ucs4ToUtf16From(p, i, n, out, room, o, 0x10ffff);
+    *produced = o;
+    return i;
+}
+
+size_t neonUcs4ToUcs2(const char32_t* p, size_t n, char16_t* out)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        uint32x4_t c0 = vld1q_u32(u + i);
+        uint32x4_t c1 = vld1q_u32(u + i + 4);
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i), vcombine_u16(vmovn_u32(c0), vmovn_u32(c1)));
+        auto refused = neonRefused(c0, 0xffff) | (neonRefused(c1, 0xffff) << 4);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    size_t o = i;
+    return ucs4ToUtf16From(p, i, n, out, n, o, 0xffff);
+}
+
+//=========================================================================
+// Lower-casing the 7-bit prefix, a register at a time; the register holding
+// the first unit that isn't 7-bit is finished by hand
+
+size_t neonLowerAsciiUtf8(const char* p, size_t n, char* out)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    uint8_t* o = reinterpret_cast<uint8_t*>(out);
+    const uint8x16_t letterA = vdupq_n_u8('A');
+    const uint8x16_t letters = vdupq_n_u8(26);
+    const uint8x16_t caseBit = vdupq_n_u8(0x20);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        uint8x16_t in = vld1q_u8(u + i);
+        if (vmaxvq_u8(in) >= 0x80)
+        {
+            break;
+        }
+        uint8x16_t upper = vcltq_u8(vsubq_u8(in, letterA), letters);
+        vst1q_u8(o + i, vaddq_u8(in, vandq_u8(upper, caseBit)));
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+size_t neonLowerAsciiUtf16(const char16_t* p, size_t n, char16_t* out)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    uint16_t* o = reinterpret_cast<uint16_t*>(out);
+    const uint16x8_t letterA = vdupq_n_u16('A');
+    const uint16x8_t letters = vdupq_n_u16(26);
+    const uint16x8_t caseBit = vdupq_n_u16(0x20);
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        uint16x8_t in = vld1q_u16(u + i);
+        if (vmaxvq_u16(in) >= 0x80)
+        {
+            break;
+        }
+        uint16x8_t upper = vcltq_u16(vsubq_u16(in, letterA), letters);
+        vst1q_u16(o + i, vaddq_u16(in, vandq_u16(upper, caseBit)));
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+size_t neonLowerAsciiUcs4(const char32_t* p, size_t n, char32_t* out)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    uint32_t* o = reinterpret_cast<uint32_t*>(out);
+    const uint32x4_t letterA = vdupq_n_u32('A');
+    const uint32x4_t letters = vdupq_n_u32(26);
+    const uint32x4_t caseBit = vdupq_n_u32(0x20);
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        uint32x4_t in = vld1q_u32(u + i);
+        if (vmaxvq_u32(in) >= 0x80)
+        {
+            break;
+        }
+        uint32x4_t upper = vcltq_u32(vsubq_u32(in, letterA), letters);
+        vst1q_u32(o + i, vaddq_u32(in, vandq_u32(upper, caseBit)));
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+//=========================================================================
+// Census kernels. Per-lane counters are emptied into size_t totals before
+// they can wrap.
+
+void neonUtf8Census(const char* p, size_t n, size_t* continuations, size_t* fourByteLeads)
+{
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+    size_t conts = 0;
+    size_t fours = 0;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        auto stop = std::min(n, i + 16 * 255);
+        uint8x16_t contCounts = vdupq_n_u8(0);
+        uint8x16_t fourCounts = vdupq_n_u8(0);
+        for ( ; i + 16 <= stop; i += 16)
+        {
+            uint8x16_t in = vld1q_u8(u + i);
+            contCounts = vsubq_u8(contCounts,
+                                  vceqq_u8(vandq_u8(in, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80)));
+            fourCounts = vsubq_u8(fourCounts, vcgeq_u8(in, vdupq_n_u8(0xf0)));
+        }
+        conts += vaddlvq_u8(contCounts);
+        fours += vaddlvq_u8(fourCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        conts += (u[i] & 0xc0) == 0x80;
+        fours += u[i] >= 0xf0;
+    }
+    *continuations = conts;
+    *fourByteLeads = fours;
+}
+
+void neonUtf16Census(const char16_t* p, size_t n, size_t* utf8Extra, size_t* secondHalves)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    size_t extra = 0;
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        // at most two extra a step
+        auto stop = std::min(n, i + 8 * 16384);
+        uint16x8_t extraCounts = vdupq_n_u16(0);
+        uint16x8_t secondCounts = vdupq_n_u16(0);
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            uint16x8_t in = vld1q_u16(u + i);
+            extraCounts = vsubq_u16(extraCounts, vcgeq_u16(in, vdupq_n_u16(0x80)));
+            extraCounts = vsubq_u16(extraCounts, vcgeq_u16(in, vdupq_n_u16(0x800)));
+            extraCounts = vaddq_u16(extraCounts, vceqq_u16(vandq_u16(in, vdupq_n_u16(0xf800)),
+                                                           vdupq_n_u16(0xd800)));
+            secondCounts = vsubq_u16(secondCounts, vceqq_u16(vandq_u16(in, vdupq_n_u16(0xfc00)),
+                                                             vdupq_n_u16(0xdc00)));
+        }
+        extra += vaddlvq_u16(extraCounts);
+        seconds += vaddlvq_u16(secondCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = u[i];
+        extra += (c >= 0x80) + (c >= 0x800) - ((c & 0xf800) == 0xd800);
+        seconds += (c & 0xfc00) == 0xdc00;
+    }
+    *utf8Extra = extra;
+    *secondHalves = seconds;
+}
+
+void neonUcs4Census(const char32_t* p, size_t n, size_t* utf8Extra, size_t* utf16Extra)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    size_t extra8 = 0;
+    size_t extra16 = 0;
+    size_t i = 0;
+    while (i + 4 <= n)
+    {
+        auto stop = std::min(n, i + 4 * (1u << 24));
+        uint32x4_t counts8 = vdupq_n_u32(0);
+        uint32x4_t counts16 = vdupq_n_u32(0);
+        for ( ; i + 4 <= stop; i += 4)
+        {
+            uint32x4_t in = vld1q_u32(u + i);
+            uint32x4_t supplementary = vcgeq_u32(in, vdupq_n_u32(0x10000));
+            counts8 = vsubq_u32(counts8, vcgeq_u32(in, vdupq_n_u32(0x80)));
+            counts8 = vsubq_u32(counts8, vcgeq_u32(in, vdupq_n_u32(0x800)));
+            counts8 = vsubq_u32(counts8, supplementary);
+            counts8 = vsubq_u32(counts8, vcgeq_u32(in, vdupq_n_u32(0x200000)));
+            counts8 = vsubq_u32(counts8, vcgeq_u32(in, vdupq_n_u32(0x4000000)));
+            counts16 = vsubq_u32(counts16, supplementary);
+        }
+        extra8 += vaddlvq_u32(counts8);
+        extra16 += vaddlvq_u32(counts16);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = u[i];
+        extra8 += (c >= 0x80) + (c >= 0x800) + (c >= 0x10000) + (c >= 0x200000) + (c >= 0x4000000);
+        extra16 += c >= 0x10000;
+    }
+    *utf8Extra = extra8;
+    *utf16Extra = extra16;
+}
+
+//=========================================================================
+// Counting and checking for unicodeLength, as the x86 kernels do
+
+size_t neonUtf8Leads(const char* p, size_t n)
+{
+    size_t continuations;
+    size_t fourByteLeads;
+    neonUtf8Census(p, n, &continuations, &fourByteLeads);
+    return n - continuations;
+}
+
+size_t neonUtf16Leads(const char16_t* p, size_t n)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        auto stop = std::min(n, i + 8 * 0xffff);
+        uint16x8_t secondCounts = vdupq_n_u16(0);
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            uint16x8_t in = vld1q_u16(u + i);
+            secondCounts = vsubq_u16(secondCounts,
+                                     vceqq_u16(vandq_u16(in, vdupq_n_u16(0xfc00)), vdupq_n_u16(0xdc00)));
+        }
+        seconds += vaddlvq_u16(secondCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        seconds += (u[i] & 0xfc00) == 0xdc00;
+    }
+    return n - seconds;
+}
+
+size_t neonValidUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    const uint16_t* u = reinterpret_cast<const uint16_t*>(p);
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        uint16x8_t in = vld1q_u16(u + i);
+        uint16x8_t sides = vandq_u16(in, vdupq_n_u16(0xfc00));
+        uint16x8_t firstLanes = vceqq_u16(sides, vdupq_n_u16(0xd800));
+        uint16x8_t secondLanes = vceqq_u16(sides, vdupq_n_u16(0xdc00));
+        uint16x8_t below = vcltq_u16(in, vdupq_n_u16(lowest));
+        if (vmaxvq_u16(vorrq_u16(vorrq_u16(firstLanes, secondLanes), below)) == 0)
+        {
+            i += 8;
+            continue;
+        }
+        bool lone = false;
+        i += pairedStop(neonUnitBits(firstLanes), neonUnitBits(secondLanes), 8, lone, neonUnitBits(below));
+        if (lone)
+        {
+            break;
+        }
+    }
+    return validUtf16From(p, i, n, lowest);
+}
+
+size_t neonInRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    const uint32_t* u = reinterpret_cast<const uint32_t*>(p);
+    const uint32x4_t low = vdupq_n_u32(lowest);
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        uint32x4_t c0 = vld1q_u32(u + i);
+        uint32x4_t c1 = vld1q_u32(u + i + 4);
+        auto refused = neonRefused(c0, last) | neonQuadBits(vcltq_u32(c0, low)) |
+                       ((neonRefused(c1, last) | neonQuadBits(vcltq_u32(c1, low))) << 4);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    return inRangeUcs4From(p, i, n, lowest, last);
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+const SimdKernels neonKernels = {
+    neonValidUtf8Prefix,
+    neonAsciiPrefix,
+    neonWidenAsciiToUtf16,
+    neonWidenAsciiToUcs4,
+    neonUtf8ToWide<char16_t>,
+    neonUtf8ToWide<char32_t>,
+    neonUtf16ToUtf8,
+    neonUcs4ToUtf8,
+    neonUtf16ToUcs4,
+    neonUcs4ToUtf16,
+    neonUcs4ToUcs2,
+    neonLowerAsciiUtf8,
+    neonLowerAsciiUtf16,
+    neonLowerAsciiUcs4,
+    neonUtf8Census,
+    neonUtf16Census,
+    neonUcs4Census,
+    neonUtf8Leads,
+    neonUtf16Leads,
+    neonValidUtf16Prefix,
+    neonInRangeUcs4Prefix
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,2717 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_simd_x86.cxx -- SSE4.2, AVX2 and AVX-512 kernels. Each function
+//                        carries its own target attribute so that this file
+//                        builds with the compiler's default flags; nothing
+//                        here is called unless the CPU reports support.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "string_simd.hxx"
+
+#if defined(ANSAK_SIMD_X86)
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's own AVX-512 headers trip over their _mm512_undefined_* placeholders
+// once inlined into optimized code
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace ansak {
+
+namespace internal {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// SSE4.2 -- two 16-byte registers per step
+
+ANSAK_TARGET_SSE42
+inline __m128i sseLoad(const void* p)
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+//=========================================================================
+// Returns non-zero lanes wherever input, read after prevInput, breaks the
+// rules of UTF-8 or holds a byte above highest
+
+ANSAK_TARGET_SSE42
+inline __m128i sseUtf8Errors(__m128i input, __m128i prevInput, __m128i highest)
+{
+    using namespace utf8check;
+
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prevInput, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prevInput, 13);
+
+    __m128i byte1High = _mm_shuffle_epi8(sseLoad(kByte1High),
+                                         _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i byte1Low = _mm_shuffle_epi8(sseLoad(kByte1Low), _mm_and_si128(prev1, nibble));
+    __m128i byte2High = _mm_shuffle_epi8(sseLoad(kByte2High),
+                                         _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // only 111_____ two back or 1111____ three back survive as >= 0x80
+    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0x60)),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8(0x70)));
+    __m128i must23As80 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm_or_si128(_mm_xor_si128(must23As80, special), _mm_subs_epu8(input, highest));
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42ValidUtf8Prefix(const char* p, size_t n, unsigned char highest)
+{
+    const __m128i highestV = _mm_set1_epi8(static_cast<char>(highest));
+    const __m128i incompleteMax = sseLoad(utf8check::kIncompleteMax);
+    __m128i prevInput = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m128i in0 = sseLoad(p + i);
+        __m128i in1 = sseLoad(p + i + 16);
+        __m128i errors;
+        if (_mm_movemask_epi8(_mm_or_si128(in0, in1)) == 0)
+        {
+            // all ASCII: only a sequence left open by the last step can fail
+            errors = prevIncomplete;
+            prevIncomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            errors = _mm_or_si128(sseUtf8Errors(in0, prevInput, highestV),
+                                  sseUtf8Errors(in1, in0, highestV));
+            prevIncomplete = _mm_subs_epu8(in1, incompleteMax);
+        }
+        if (!_mm_testz_si128(errors, errors))
+        {
+            break;
+        }
+        prevInput = in1;
+    }
+
+    return backUpToCharacterStart(p, i);
+}
+
+//=========================================================================
+// Runs of ASCII, 32 bytes a step
+
+ANSAK_TARGET_SSE42
+size_t sse42AsciiPrefix(const char* p, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(sseLoad(p + i))) |
+                        (static_cast<uint32_t>(_mm_movemask_epi8(sseLoad(p + i + 16))) << 16);
+        if (mask != 0)
+        {
+            return i + lowestSetBit(mask);
+        }
+    }
+    while (i < n && static_cast<unsigned char>(p[i]) < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+ANSAK_TARGET_SSE42
+void sse42WidenAsciiToUtf16(const char* p, size_t n, char16_t* out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m128i in = sseLoad(p + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(in, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(in, zero));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char16_t>(p[i]);
+    }
+}
+
+ANSAK_TARGET_SSE42
+void sse42WidenAsciiToUcs4(const char* p, size_t n, char32_t* out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m128i in = sseLoad(p + i);
+        __m128i lo = _mm_unpacklo_epi8(in, zero);
+        __m128i hi = _mm_unpackhi_epi8(in, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char32_t>(p[i]);
+    }
+}
+
+//=========================================================================
+// Transcoding UTF-8 to UTF-16 or UCS-4 (after Lemire and Keiser). A step's
+// bytes are checked as the validators check them, with nothing owed from
+// before it since every step starts on a character. Every byte is then
+// decoded in a 16-bit lane as though it led a 1-, 2- or 3-byte character,
+// and the lanes that really do lead one are packed together through a
+// shuffle per eight lanes, then widened again for UCS-4. Steps stop short
+// at a CESU-8 half or anything invalid, at a character cut off by the end
+// of the step and, to UTF-16, at a 4-byte lead; to UCS-4, from a 4-byte
+// lead to the end of its step goes a character at a time.
+
+// eight 16-bit lanes stored as units of either width
+ANSAK_TARGET_SSE42
+inline void sseStoreWords(__m128i words, char16_t* out)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), words);
+}
+
+ANSAK_TARGET_SSE42
+inline void sseStoreWords(__m128i words, char32_t* out)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu16_epi32(words));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu16_epi32(_mm_srli_si128(words, 8)));
+}
+
+template<typename C>
+ANSAK_TARGET_SSE42
+inline size_t ssePackLeads
+(
+    __m128i                 b0,         // I - eight bytes, widened
+    __m128i                 b1,         // I - the bytes one on from them
+    __m128i                 b2,         // I - and two on from them
+    unsigned int            leads,      // I - which of the eight lead characters
+    const uint8_t*          pack,       // I - packWordsTable()
+    C*                      out         // O - where to put those characters
+)
+{
+    const __m128i low6 = _mm_set1_epi16(0x3f);
+    __m128i two = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6),
+                               _mm_and_si128(b1, low6));
+    __m128i three = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b0, 12),
+                                              _mm_slli_epi16(_mm_and_si128(b1, low6), 6)),
+                                 _mm_and_si128(b2, low6));
+    __m128i v = _mm_blendv_epi8(two, b0, _mm_cmplt_epi16(b0, _mm_set1_epi16(0x80)));
+    v = _mm_blendv_epi8(v, three, _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xdf)));
+    sseStoreWords(_mm_shuffle_epi8(v, sseLoad(pack + 16 * leads)), out);
+    return popCount(leads);
+}
+
+//=========================================================================
+// Where a step's conversion has to stop: short of the character holding
+// the first error, or of one the step cuts off
+
+inline size_t stepStop
+(
+    const char*             p,          // I - the step
+    size_t                  step,       // I - its length
+    uint64_t                errors,     // I - a bit for each byte in error
+    bool                    cutOff      // I - does its last character go on?
+)
+{
+    if (errors != 0)
+    {
+        return backUpToCharacterStart(p, lowestSetBit(errors));
+    }
+    return cutOff ? backUpToCharacterStart(p, step) : step;
+}
+
+// a run of ASCII too short for a step
+template<typename C>
+inline size_t widenAsciiTail(const char* p, size_t i, size_t n, C* out, size_t& o)
+{
+    for ( ; i < n && static_cast<unsigned char>(p[i]) < 0x80; ++i)
+    {
+        out[o++] = static_cast<C>(p[i]);
+    }
+    return i;
+}
+
+template<typename C>
+ANSAK_TARGET_SSE42
+size_t sse42Utf8ToWide(const char* p, size_t n, C* out, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i highest = _mm_set1_epi8(static_cast<char>(sizeof(C) == 2 ? 0xef : 0xff));
+    const __m128i incompleteMax = sseLoad(utf8check::kIncompleteMax);
+    const __m128i topTwo = _mm_set1_epi8(static_cast<char>(0xc0));
+    const __m128i continuation = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i fourByteLead = _mm_set1_epi8(static_cast<char>(0xf0));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n)
+    {
+        __m128i in = sseLoad(p + i);
+        if (_mm_movemask_epi8(in) == 0)
+        {
+            sseStoreWords(_mm_unpacklo_epi8(in, zero), out + o);
+            sseStoreWords(_mm_unpackhi_epi8(in, zero), out + o + 8);
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        __m128i errors = sseUtf8Errors(in, zero, highest);
+        auto bad = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero))) ^ 0xffff;
+        __m128i cutOff = _mm_subs_epu8(in, incompleteMax);
+        auto stop = stepStop(p + i, 16, bad, !_mm_testz_si128(cutOff, cutOff));
+        auto fours = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(in, fourByteLead), in))) &
+                     ((1u << stop) - 1);
+        auto vectorStop = fours == 0 ? stop : lowestSetBit(fours);
+        auto leads = (static_cast<uint32_t>(_mm_movemask_epi8(
+                          _mm_cmpeq_epi8(_mm_and_si128(in, topTwo), continuation))) ^ 0xffff) &
+                     ((1u << vectorStop) - 1);
+
+        __m128i b1 = _mm_srli_si128(in, 1);
+        __m128i b2 = _mm_srli_si128(in, 2);
+        o += ssePackLeads(_mm_unpacklo_epi8(in, zero), _mm_unpacklo_epi8(b1, zero),
+                          _mm_unpacklo_epi8(b2, zero), leads & 0xff, pack, out + o);
+        o += ssePackLeads(_mm_unpackhi_epi8(in, zero), _mm_unpackhi_epi8(b1, zero),
+                          _mm_unpackhi_epi8(b2, zero), leads >> 8, pack, out + o);
+        checkedUtf8Through(p, i + vectorStop, i + stop, out, o);
+        i += stop;
+        if (bad != 0)
+        {
+            break;
+        }
+    }
+
+    i = widenAsciiTail(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// Transcoding UTF-16 or UCS-4 to UTF-8, four characters at a time in 32-bit
+// lanes: each is encoded as one, two and three bytes at once, the right
+// encoding kept, and the bytes packed together by a shuffle from
+// packUtf8Table. From a surrogate (or, in UCS-4, a character beyond the
+// BMP) to the end of its step goes a character at a time. Lone halves,
+// characters past 0x7fffffff and a destination that might not hold a step
+// end the run.
+
+ANSAK_TARGET_SSE42
+inline size_t ssePackUtf8
+(
+    __m128i                 c,          // I - four characters, one to a 32-bit lane
+    const uint8_t*          table,      // I - packUtf8Table()
+    char*                   out         // O - where to put their UTF-8
+)
+{
+    const __m128i low6 = _mm_set1_epi32(0x3f);
+    __m128i twoOrMore = _mm_cmpgt_epi32(c, _mm_set1_epi32(0x7f));
+    __m128i three = _mm_cmpgt_epi32(c, _mm_set1_epi32(0x7ff));
+    __m128i asTwo = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(c, 6),
+                                              _mm_slli_epi32(_mm_and_si128(c, low6), 8)),
+                                 _mm_set1_epi32(0x80c0));
+    __m128i asThree = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(c, 12),
+                                                _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(c, 6), low6), 8)),
+                                   _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, low6), 16),
+                                                _mm_set1_epi32(0x8080e0)));
+    __m128i bytes = _mm_blendv_epi8(_mm_blendv_epi8(c, asTwo, twoOrMore), asThree, three);
+
+    auto twos = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(twoOrMore)));
+    auto threes = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(three)));
+    __m128i shuffle = sseLoad(table + 16 * ((twos & ~threes) | (threes << 4)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(bytes, shuffle));
+    return 4 + popCount(twos) + popCount(threes);
+}
+
+// the groups of four units at p before a surrogate
+ANSAK_TARGET_SSE42
+inline size_t sseGroupsToUtf8(const char16_t* p, size_t groups, const uint8_t* table, char* out)
+{
+    size_t o = 0;
+    for (size_t g = 0; g < groups; ++g)
+    {
+        __m128i units = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 4 * g));
+        o += ssePackUtf8(_mm_cvtepu16_epi32(units), table, out + o);
+    }
+    return o;
+}
+
+// the groups of four characters at p before one beyond the BMP or a half
+ANSAK_TARGET_SSE42
+inline size_t sseGroupsToUtf8(const char32_t* p, size_t groups, const uint8_t* table, char* out)
+{
+    size_t o = 0;
+    for (size_t g = 0; g < groups; ++g)
+    {
+        o += ssePackUtf8(sseLoad(p + 4 * g), table, out + o);
+    }
+    return o;
+}
+
+// a bit for each of four characters beyond the BMP, or a surrogate
+ANSAK_TARGET_SSE42
+inline unsigned int sseNotThreeBytes(__m128i c)
+{
+    __m128i bmp = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(static_cast<int>(0xffff0000u))),
+                                  _mm_setzero_si128());
+    __m128i half = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(static_cast<int>(0xfffff800u))),
+                                   _mm_set1_epi32(0xd800));
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(half, bmp)))) ^ 0x0f;
+}
+
+// a run of ASCII too short for a step, or for the room left
+template<typename C>
+inline size_t narrowAsciiTail(const C* p, size_t i, size_t n, char* out, size_t room, size_t& o)
+{
+    for ( ; i < n && o < room && p[i] < 0x80; ++i)
+    {
+        out[o++] = static_cast<char>(p[i]);
+    }
+    return i;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Utf16ToUtf8(const char16_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m128i notAscii = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i surrogateBits = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n && o + 16 <= room)
+    {
+        __m128i u0 = sseLoad(p + i);
+        __m128i u1 = sseLoad(p + i + 8);
+        if (_mm_testz_si128(_mm_or_si128(u0, u1), notAscii))
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_packus_epi16(u0, u1));
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        // each group of four makes up to twelve bytes, and stores sixteen
+        if (o + 3 * 16 + 4 > room)
+        {
+            break;
+        }
+        auto halves = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(
+                          _mm_cmpeq_epi16(_mm_and_si128(u0, surrogateBits), surrogate),
+                          _mm_cmpeq_epi16(_mm_and_si128(u1, surrogateBits), surrogate))));
+        if (halves == 0)
+        {
+            o += sseGroupsToUtf8(p + i, 4, table, out + o);
+            i += 16;
+            continue;
+        }
+        // the rest of a step holding a surrogate goes a character at a time
+        size_t half = i + lowestSetBit(halves);
+        size_t stepEnd = i + 16;
+        o += sseGroupsToUtf8(p + i, (half - i) / 4, table, out + o);
+        i += (half - i) & ~static_cast<size_t>(3);
+        if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+        {
+            break;
+        }
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Ucs4ToUtf8(const char32_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m128i notAscii = _mm_set1_epi32(static_cast<int>(0xffffff80u));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n && o + 16 <= room)
+    {
+        __m128i c0 = sseLoad(p + i);
+        __m128i c1 = sseLoad(p + i + 4);
+        __m128i c2 = sseLoad(p + i + 8);
+        __m128i c3 = sseLoad(p + i + 12);
+        if (_mm_testz_si128(_mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3)), notAscii))
+        {
+            __m128i bytes = _mm_packus_epi16(_mm_packus_epi32(c0, c1), _mm_packus_epi32(c2, c3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), bytes);
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        if (o + 3 * 16 + 4 > room)
+        {
+            break;
+        }
+        auto others = sseNotThreeBytes(c0) | (sseNotThreeBytes(c1) << 4) |
+                      (sseNotThreeBytes(c2) << 8) | (sseNotThreeBytes(c3) << 12);
+        if (others == 0)
+        {
+            o += sseGroupsToUtf8(p + i, 4, table, out + o);
+            i += 16;
+            continue;
+        }
+        // the rest of a step holding such a character goes one at a time
+        size_t other = i + lowestSetBit(others);
+        size_t stepEnd = i + 16;
+        o += sseGroupsToUtf8(p + i, (other - i) / 4, table, out + o);
+        i += (other - i) & ~static_cast<size_t>(3);
+        if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+        {
+            break;
+        }
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// Transcoding between UTF-16 and UCS-4, eight units a step. Each unit is
+// widened to a 32-bit lane, and the lane of a first half is blended with
+// the character it makes with the unit after it; the lanes of second
+// halves are then dropped by a shuffle from packWordsTable. The other way,
+// a character beyond the BMP is split into both halves within its own
+// lane, and the upper 16 bits of the other lanes dropped the same way. A
+// lone half, or a character the target can't hold, ends the run.
+
+// a bit for each of eight 16-bit lanes set in a comparison's result
+ANSAK_TARGET_SSE42
+inline unsigned int sseUnitBits(__m128i lanes)
+{
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_packs_epi16(lanes, _mm_setzero_si128())));
+}
+
+// the lanes of four whose bits are set in keep, in order
+ANSAK_TARGET_SSE42
+inline size_t ssePackLanes(__m128i lanes, unsigned int keep, const uint8_t* pack, char32_t* out)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_shuffle_epi8(lanes, sseLoad(pack + 16 * (3 * spreadLanes(keep)))));
+    return popCount(keep);
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Utf16ToUcs4(const char16_t* p, size_t n, char32_t* out, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m128i halfBits = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i sideBits = _mm_set1_epi16(static_cast<short>(0xfc00));
+    const __m128i firstHalf = _mm_set1_epi16(static_cast<short>(0xd800));
+    const __m128i secondHalf = _mm_set1_epi16(static_cast<short>(0xdc00));
+    const __m128i pairOffset = _mm_set1_epi32(static_cast<int>(kUtf16PairOffset));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 8 <= n)
+    {
+        __m128i u = sseLoad(p + i);
+        __m128i w0 = _mm_cvtepu16_epi32(u);
+        __m128i w1 = _mm_cvtepu16_epi32(_mm_srli_si128(u, 8));
+        __m128i halves = _mm_cmpeq_epi16(_mm_and_si128(u, halfBits), firstHalf);
+        if (_mm_testz_si128(halves, halves))
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), w0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o + 4), w1);
+            i += 8;
+            o += 8;
+            continue;
+        }
+
+        __m128i sides = _mm_and_si128(u, sideBits);
+        __m128i firstLanes = _mm_cmpeq_epi16(sides, firstHalf);
+        auto seconds = sseUnitBits(_mm_cmpeq_epi16(sides, secondHalf));
+        bool lone = false;
+        auto stop = pairedStop(sseUnitBits(firstLanes), seconds, 8, lone);
+
+        __m128i next = _mm_srli_si128(u, 2);
+        __m128i pair0 = _mm_sub_epi32(_mm_add_epi32(_mm_slli_epi32(w0, 10), _mm_cvtepu16_epi32(next)), pairOffset);
+        __m128i pair1 = _mm_sub_epi32(_mm_add_epi32(_mm_slli_epi32(w1, 10),
+                                                    _mm_cvtepu16_epi32(_mm_srli_si128(next, 8))), pairOffset);
+        w0 = _mm_blendv_epi8(w0, pair0, _mm_cvtepi16_epi32(firstLanes));
+        w1 = _mm_blendv_epi8(w1, pair1, _mm_cvtepi16_epi32(_mm_srli_si128(firstLanes, 8)));
+        auto keep = ~seconds & ((1u << stop) - 1);
+        o += ssePackLanes(w0, keep & 0x0f, pack, out + o);
+        o += ssePackLanes(w1, keep >> 4, pack, out + o);
+        i += stop;
+        if (lone)
+        {
+            break;
+        }
+    }
+
+    i = utf16ToUcs4From(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+// a bit for each of four characters UTF-16 (last 0x10ffff) or UCS-2 (last
+// 0xffff) can't hold
+ANSAK_TARGET_SSE42
+inline unsigned int sseRefused(__m128i c, __m128i last)
+{
+    __m128i inRange = _mm_cmpeq_epi32(_mm_min_epu32(c, last), c);
+    __m128i half = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(static_cast<int>(0xfffff800u))),
+                                   _mm_set1_epi32(0xd800));
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(half, inRange)))) ^ 0x0f;
+}
+
+// each lane of four beyond the BMP split into its halves, low then high
+ANSAK_TARGET_SSE42
+inline __m128i sseSplitPairs(__m128i c)
+{
+    __m128i first = _mm_add_epi32(_mm_srli_epi32(_mm_sub_epi32(c, _mm_set1_epi32(0x10000)), 10),
+                                  _mm_set1_epi32(0xd800));
+    __m128i second = _mm_or_si128(_mm_and_si128(c, _mm_set1_epi32(0x3ff)), _mm_set1_epi32(0xdc00));
+    __m128i beyond = _mm_cmpgt_epi32(c, _mm_set1_epi32(0xffff));
+    return _mm_blendv_epi8(c, _mm_or_si128(first, _mm_slli_epi32(second, 16)), beyond);
+}
+
+// the first live of four characters out as UTF-16
+ANSAK_TARGET_SSE42
+inline size_t ssePackPairs(__m128i c, unsigned int live, unsigned int pairs, const uint8_t* pack, char16_t* out)
+{
+    pairs &= live;
+    auto keep = spreadLanes(live) | (spreadLanes(pairs) << 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_shuffle_epi8(sseSplitPairs(c), sseLoad(pack + 16 * keep)));
+    return popCount(live) + popCount(pairs);
+}
+
+// a bit for each of four characters beyond the BMP
+ANSAK_TARGET_SSE42
+inline unsigned int sseBeyondBmp(__m128i c)
+{
+    __m128i bmp = _mm_cmpeq_epi32(_mm_and_si128(c, _mm_set1_epi32(static_cast<int>(0xffff0000u))),
+                                  _mm_setzero_si128());
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(bmp))) ^ 0x0f;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Ucs4ToUtf16(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m128i last = _mm_set1_epi32(0x10ffff);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 8 <= n && o + 16 <= room)
+    {
+        __m128i c0 = sseLoad(p + i);
+        __m128i c1 = sseLoad(p + i + 4);
+        auto refused = sseRefused(c0, last) | (sseRefused(c1, last) << 4);
+        auto pairs = sseBeyondBmp(c0) | (sseBeyondBmp(c1) << 4);
+        if ((refused | pairs) == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_packus_epi32(c0, c1));
+            i += 8;
+            o += 8;
+            continue;
+        }
+
+        auto stop = refused == 0 ? 8 : lowestSetBit(refused);
+        auto live = (1u << stop) - 1;
+        o += ssePackPairs(c0, live & 0x0f, pairs & 0x0f, pack, out + o);
+        o += ssePackPairs(c1, live >> 4, pairs >> 4, pack, out + o);
+        i += stop;
+        if (refused != 0)
+        {
+            break;
+        }
+    }
+
+    i = ucs4ToUtf16From(p, i, n, out, room, o, 0x10ffff);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Ucs4ToUcs2(const char32_t* p, size_t n, char16_t* out)
+{
+    const __m128i last = _mm_set1_epi32(0xffff);
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        __m128i c0 = sseLoad(p + i);
+        __m128i c1 = sseLoad(p + i + 4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi32(c0, c1));
+        auto refused = sseRefused(c0, last) | (sseRefused(c1, last) << 4);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    size_t o = i;
+    return ucs4ToUtf16From(p, i, n, out, n, o, 0xffff);
+}
+
+//=========================================================================
+// Lower-casing the 7-bit prefix, a register at a time. SSE and AVX2 only
+// compare signed, so 'A'..'Z' are biased down to the bottom of the signed
+// range and compared against its 26th value.
+
+ANSAK_TARGET_SSE42
+size_t sse42LowerAsciiUtf8(const char* p, size_t n, char* out)
+{
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - 'A'));
+    const __m128i pastZ = _mm_set1_epi8(static_cast<char>(0x80 + 26));
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m128i in = sseLoad(p + i);
+        __m128i upper = _mm_cmpgt_epi8(pastZ, _mm_add_epi8(in, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_add_epi8(in, _mm_and_si128(upper, caseBit)));
+        uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(in));
+        if (high != 0)
+        {
+            return i + lowestSetBit(high);
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42LowerAsciiUtf16(const char16_t* p, size_t n, char16_t* out)
+{
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000 - 'A'));
+    const __m128i pastZ = _mm_set1_epi16(static_cast<short>(0x8000 + 26));
+    const __m128i caseBit = _mm_set1_epi16(0x20);
+    const __m128i notAscii = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        __m128i in = sseLoad(p + i);
+        __m128i upper = _mm_cmpgt_epi16(pastZ, _mm_add_epi16(in, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_add_epi16(in, _mm_and_si128(upper, caseBit)));
+        uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(
+                            _mm_cmpeq_epi16(_mm_and_si128(in, notAscii), zero))) ^ 0xffff;
+        if (high != 0)
+        {
+            return i + lowestSetBit(high) / 2;
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42LowerAsciiUcs4(const char32_t* p, size_t n, char32_t* out)
+{
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u - 'A'));
+    const __m128i pastZ = _mm_set1_epi32(static_cast<int>(0x80000000u + 26));
+    const __m128i caseBit = _mm_set1_epi32(0x20);
+    const __m128i notAscii = _mm_set1_epi32(static_cast<int>(0xffffff80u));
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4)
+    {
+        __m128i in = sseLoad(p + i);
+        __m128i upper = _mm_cmpgt_epi32(pastZ, _mm_add_epi32(in, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_add_epi32(in, _mm_and_si128(upper, caseBit)));
+        uint32_t high = static_cast<uint32_t>(_mm_movemask_epi8(
+                            _mm_cmpeq_epi32(_mm_and_si128(in, notAscii), zero))) ^ 0xffff;
+        if (high != 0)
+        {
+            return i + lowestSetBit(high) / 4;
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+//=========================================================================
+// Census kernels. Per-lane counters are emptied into size_t totals before
+// they can wrap.
+
+ANSAK_TARGET_SSE42
+inline size_t sseSumBytes(__m128i v)
+{
+    __m128i sums = _mm_sad_epu8(v, _mm_setzero_si128());
+    return static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+}
+
+ANSAK_TARGET_SSE42
+inline size_t sseSumWords(__m128i v)
+{
+    __m128i sums = _mm_madd_epi16(v, _mm_set1_epi16(1));
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 8));
+    sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 4));
+    return static_cast<size_t>(_mm_cvtsi128_si32(sums));
+}
+
+ANSAK_TARGET_SSE42
+inline size_t sseSumDwords(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+ANSAK_TARGET_SSE42
+void sse42Utf8Census(const char* p, size_t n, size_t* continuations, size_t* fourByteLeads)
+{
+    // as signed bytes, continuations (0x80-0xbf) are all below 0xc0
+    const __m128i firstLead = _mm_set1_epi8(static_cast<char>(0xc0));
+    const __m128i firstFourByteLead = _mm_set1_epi8(static_cast<char>(0xf0));
+    size_t conts = 0;
+    size_t fours = 0;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        auto stop = std::min(n, i + 16 * 255);
+        __m128i contCounts = _mm_setzero_si128();
+        __m128i fourCounts = _mm_setzero_si128();
+        for ( ; i + 16 <= stop; i += 16)
+        {
+            __m128i in = sseLoad(p + i);
+            contCounts = _mm_sub_epi8(contCounts, _mm_cmpgt_epi8(firstLead, in));
+            fourCounts = _mm_sub_epi8(fourCounts,
+                                      _mm_cmpeq_epi8(_mm_max_epu8(in, firstFourByteLead), in));
+        }
+        conts += sseSumBytes(contCounts);
+        fours += sseSumBytes(fourCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = static_cast<unsigned char>(p[i]);
+        conts += (c & 0xc0) == 0x80;
+        fours += c >= 0xf0;
+    }
+    *continuations = conts;
+    *fourByteLeads = fours;
+}
+
+ANSAK_TARGET_SSE42
+void sse42Utf16Census(const char16_t* p, size_t n, size_t* utf8Extra, size_t* secondHalves)
+{
+    const __m128i x80 = _mm_set1_epi16(0x80);
+    const __m128i x800 = _mm_set1_epi16(0x800);
+    const __m128i surrogateMask = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+    const __m128i halfMask = _mm_set1_epi16(static_cast<short>(0xfc00));
+    const __m128i secondHalf = _mm_set1_epi16(static_cast<short>(0xdc00));
+    size_t extra = 0;
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        // at most two extra a step; keep the lanes below 0x8000 for madd
+        auto stop = std::min(n, i + 8 * 8192);
+        __m128i extraCounts = _mm_setzero_si128();
+        __m128i secondCounts = _mm_setzero_si128();
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            __m128i in = sseLoad(p + i);
+            extraCounts = _mm_sub_epi16(extraCounts, _mm_cmpeq_epi16(_mm_max_epu16(in, x80), in));
+            extraCounts = _mm_sub_epi16(extraCounts, _mm_cmpeq_epi16(_mm_max_epu16(in, x800), in));
+            extraCounts = _mm_add_epi16(extraCounts,
+                                        _mm_cmpeq_epi16(_mm_and_si128(in, surrogateMask), surrogate));
+            secondCounts = _mm_sub_epi16(secondCounts,
+                                         _mm_cmpeq_epi16(_mm_and_si128(in, halfMask), secondHalf));
+        }
+        extra += sseSumWords(extraCounts);
+        seconds += sseSumWords(secondCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = p[i];
+        extra += (c >= 0x80) + (c >= 0x800) - ((c & 0xf800) == 0xd800);
+        seconds += (c & 0xfc00) == 0xdc00;
+    }
+    *utf8Extra = extra;
+    *secondHalves = seconds;
+}
+
+ANSAK_TARGET_SSE42
+void sse42Ucs4Census(const char32_t* p, size_t n, size_t* utf8Extra, size_t* utf16Extra)
+{
+    const __m128i x80 = _mm_set1_epi32(0x80);
+    const __m128i x800 = _mm_set1_epi32(0x800);
+    const __m128i x10000 = _mm_set1_epi32(0x10000);
+    const __m128i x200000 = _mm_set1_epi32(0x200000);
+    const __m128i x4000000 = _mm_set1_epi32(0x4000000);
+    size_t extra8 = 0;
+    size_t extra16 = 0;
+    size_t i = 0;
+    while (i + 4 <= n)
+    {
+        auto stop = std::min(n, i + 4 * (1u << 24));
+        __m128i counts8 = _mm_setzero_si128();
+        __m128i counts16 = _mm_setzero_si128();
+        for ( ; i + 4 <= stop; i += 4)
+        {
+            __m128i in = sseLoad(p + i);
+            __m128i supplementary = _mm_cmpeq_epi32(_mm_max_epu32(in, x10000), in);
+            counts8 = _mm_sub_epi32(counts8, _mm_cmpeq_epi32(_mm_max_epu32(in, x80), in));
+            counts8 = _mm_sub_epi32(counts8, _mm_cmpeq_epi32(_mm_max_epu32(in, x800), in));
+            counts8 = _mm_sub_epi32(counts8, supplementary);
+            counts8 = _mm_sub_epi32(counts8, _mm_cmpeq_epi32(_mm_max_epu32(in, x200000), in));
+            counts8 = _mm_sub_epi32(counts8, _mm_cmpeq_epi32(_mm_max_epu32(in, x4000000), in));
+            counts16 = _mm_sub_epi32(counts16, supplementary);
+        }
+        extra8 += sseSumDwords(counts8);
+        extra16 += sseSumDwords(counts16);
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = p[i];
+        extra8 += (c >= 0x80) + (c >= 0x800) + (c >= 0x10000) + (c >= 0x200000) + (c >= 0x4000000);
+        extra16 += c >= 0x10000;
+    }
+    *utf8Extra = extra8;
+    *utf16Extra = extra16;
+}
+
+//=========================================================================
+// Counting and checking for unicodeLength: leads are counted as the census
+// counts continuations, and the checks stop at the first step that holds
+// anything a vector can't vouch for
+
+ANSAK_TARGET_SSE42
+size_t sse42Utf8Leads(const char* p, size_t n)
+{
+    size_t continuations;
+    size_t fourByteLeads;
+    sse42Utf8Census(p, n, &continuations, &fourByteLeads);
+    return n - continuations;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42Utf16Leads(const char16_t* p, size_t n)
+{
+    const __m128i halfMask = _mm_set1_epi16(static_cast<short>(0xfc00));
+    const __m128i secondHalf = _mm_set1_epi16(static_cast<short>(0xdc00));
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        // keep the lanes below 0x8000 for madd
+        auto stop = std::min(n, i + 8 * 0x7fff);
+        __m128i secondCounts = _mm_setzero_si128();
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            __m128i in = sseLoad(p + i);
+            secondCounts = _mm_sub_epi16(secondCounts,
+                                         _mm_cmpeq_epi16(_mm_and_si128(in, halfMask), secondHalf));
+        }
+        seconds += sseSumWords(secondCounts);
+    }
+    for ( ; i < n; ++i)
+    {
+        seconds += (p[i] & 0xfc00) == 0xdc00;
+    }
+    return n - seconds;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42ValidUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    const __m128i halfBits = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i sideBits = _mm_set1_epi16(static_cast<short>(0xfc00));
+    const __m128i firstHalf = _mm_set1_epi16(static_cast<short>(0xd800));
+    const __m128i secondHalf = _mm_set1_epi16(static_cast<short>(0xdc00));
+    const __m128i low = _mm_set1_epi16(static_cast<short>(lowest));
+    const __m128i ones = _mm_set1_epi8(-1);
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        __m128i u = sseLoad(p + i);
+        __m128i below = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_max_epu16(u, low), u), ones);
+        __m128i stops = _mm_or_si128(_mm_cmpeq_epi16(_mm_and_si128(u, halfBits), firstHalf), below);
+        if (_mm_testz_si128(stops, stops))
+        {
+            i += 8;
+            continue;
+        }
+        __m128i sides = _mm_and_si128(u, sideBits);
+        bool lone = false;
+        i += pairedStop(sseUnitBits(_mm_cmpeq_epi16(sides, firstHalf)),
+                        sseUnitBits(_mm_cmpeq_epi16(sides, secondHalf)), 8, lone, sseUnitBits(below));
+        if (lone)
+        {
+            break;
+        }
+    }
+    return validUtf16From(p, i, n, lowest);
+}
+
+// a bit for each of four characters below lowest
+ANSAK_TARGET_SSE42
+inline unsigned int sseBelow(__m128i c, __m128i lowest)
+{
+    __m128i atLeast = _mm_cmpeq_epi32(_mm_max_epu32(c, lowest), c);
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(atLeast))) ^ 0x0f;
+}
+
+ANSAK_TARGET_SSE42
+size_t sse42InRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    const __m128i low = _mm_set1_epi32(static_cast<int>(lowest));
+    const __m128i top = _mm_set1_epi32(static_cast<int>(last));
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        __m128i c0 = sseLoad(p + i);
+        __m128i c1 = sseLoad(p + i + 4);
+        auto refused = sseRefused(c0, top) | sseBelow(c0, low) | ((sseRefused(c1, top) | sseBelow(c1, low)) << 4);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    return inRangeUcs4From(p, i, n, lowest, last);
+}
+
+//=========================================================================
+// AVX2 -- two 32-byte registers per step
+
+ANSAK_TARGET_AVX2
+inline __m256i avx2Load(const void* p)
+{
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+ANSAK_TARGET_AVX2
+inline __m256i avx2Table(const uint8_t* table)
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+ANSAK_TARGET_AVX2
+inline __m256i avx2Utf8Errors(__m256i input, __m256i prevInput, __m256i highest)
+{
+    using namespace utf8check;
+
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    // the 16 bytes before each lane: last lane of prevInput, first of input
+    __m256i before = _mm256_permute2x128_si256(prevInput, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, before, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, before, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, before, 13);
+
+    __m256i byte1High = _mm256_shuffle_epi8(avx2Table(kByte1High),
+                                            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte1Low = _mm256_shuffle_epi8(avx2Table(kByte1Low), _mm256_and_si256(prev1, nibble));
+    __m256i byte2High = _mm256_shuffle_epi8(avx2Table(kByte2High),
+                                            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60)),
+                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70)));
+    __m256i must23As80 = _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm256_or_si256(_mm256_xor_si256(must23As80, special), _mm256_subs_epu8(input, highest));
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2ValidUtf8Prefix(const char* p, size_t n, unsigned char highest)
+{
+    const __m256i highestV = _mm256_set1_epi8(static_cast<char>(highest));
+    const __m256i incompleteMax = _mm256_inserti128_si256(_mm256_set1_epi8(-1),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                          utf8check::kIncompleteMax)), 1);
+    __m256i prevInput = _mm256_setzero_si256();
+    __m256i prevIncomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        __m256i in0 = avx2Load(p + i);
+        __m256i in1 = avx2Load(p + i + 32);
+        __m256i errors;
+        if (_mm256_movemask_epi8(_mm256_or_si256(in0, in1)) == 0)
+        {
+            errors = prevIncomplete;
+            prevIncomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            errors = _mm256_or_si256(avx2Utf8Errors(in0, prevInput, highestV),
+                                     avx2Utf8Errors(in1, in0, highestV));
+            prevIncomplete = _mm256_subs_epu8(in1, incompleteMax);
+        }
+        if (!_mm256_testz_si256(errors, errors))
+        {
+            break;
+        }
+        prevInput = in1;
+    }
+
+    return backUpToCharacterStart(p, i);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2AsciiPrefix(const char* p, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(avx2Load(p + i))) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(
+                            _mm256_movemask_epi8(avx2Load(p + i + 32)))) << 32);
+        if (mask != 0)
+        {
+            return i + lowestSetBit(mask);
+        }
+    }
+    while (i < n && static_cast<unsigned char>(p[i]) < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+ANSAK_TARGET_AVX2
+void avx2WidenAsciiToUtf16(const char* p, size_t n, char16_t* out)
+{
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m256i lo = _mm256_cvtepu8_epi16(sseLoad(p + i));
+        __m256i hi = _mm256_cvtepu8_epi16(sseLoad(p + i + 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 16), hi);
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char16_t>(p[i]);
+    }
+}
+
+ANSAK_TARGET_AVX2
+void avx2WidenAsciiToUcs4(const char* p, size_t n, char32_t* out)
+{
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m128i in = sseLoad(p + i);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu8_epi32(in));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8),
+                            _mm256_cvtepu8_epi32(_mm_srli_si128(in, 8)));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char32_t>(p[i]);
+    }
+}
+
+//=========================================================================
+// UTF-8 to UTF-16 or UCS-4, a 32-byte step decoded sixteen lanes at a time
+
+// sixteen 16-bit lanes stored as units of either width
+ANSAK_TARGET_AVX2
+inline void avx2StoreWords(__m256i words, char16_t* out)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), words);
+}
+
+ANSAK_TARGET_AVX2
+inline void avx2StoreWords(__m256i words, char32_t* out)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(words)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8),
+                        _mm256_cvtepu16_epi32(_mm256_extracti128_si256(words, 1)));
+}
+
+template<typename C>
+ANSAK_TARGET_AVX2
+inline size_t avx2PackLeads
+(
+    __m128i                 b0,         // I - sixteen bytes
+    __m128i                 b1,         // I - the bytes one on from them
+    __m128i                 b2,         // I - and two on from them
+    unsigned int            leads,      // I - which of the sixteen lead characters
+    const uint8_t*          pack,       // I - packWordsTable()
+    C*                      out         // O - where to put those characters
+)
+{
+    const __m256i low6 = _mm256_set1_epi16(0x3f);
+    __m256i w0 = _mm256_cvtepu8_epi16(b0);
+    __m256i w1 = _mm256_cvtepu8_epi16(b1);
+    __m256i w2 = _mm256_cvtepu8_epi16(b2);
+    __m256i two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(w0, _mm256_set1_epi16(0x1f)), 6),
+                                  _mm256_and_si256(w1, low6));
+    __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(w0, 12),
+                                                    _mm256_slli_epi16(_mm256_and_si256(w1, low6), 6)),
+                                    _mm256_and_si256(w2, low6));
+    __m256i v = _mm256_blendv_epi8(two, w0, _mm256_cmpgt_epi16(_mm256_set1_epi16(0x80), w0));
+    v = _mm256_blendv_epi8(v, three, _mm256_cmpgt_epi16(w0, _mm256_set1_epi16(0xdf)));
+
+    auto low = leads & 0xff;
+    sseStoreWords(_mm_shuffle_epi8(_mm256_castsi256_si128(v), sseLoad(pack + 16 * low)), out);
+    auto n = popCount(low);
+    sseStoreWords(_mm_shuffle_epi8(_mm256_extracti128_si256(v, 1), sseLoad(pack + 16 * (leads >> 8))),
+                  out + n);
+    return n + popCount(leads >> 8);
+}
+
+template<typename C>
+ANSAK_TARGET_AVX2
+size_t avx2Utf8ToWide(const char* p, size_t n, C* out, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i highest = _mm256_set1_epi8(static_cast<char>(sizeof(C) == 2 ? 0xef : 0xff));
+    const __m256i incompleteMax = _mm256_inserti128_si256(_mm256_set1_epi8(-1),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                          utf8check::kIncompleteMax)), 1);
+    const __m256i topTwo = _mm256_set1_epi8(static_cast<char>(0xc0));
+    const __m256i continuation = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i fourByteLead = _mm256_set1_epi8(static_cast<char>(0xf0));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n)
+    {
+        __m256i in = avx2Load(p + i);
+        __m128i lo = _mm256_castsi256_si128(in);
+        __m128i hi = _mm256_extracti128_si256(in, 1);
+        if (_mm256_movemask_epi8(in) == 0)
+        {
+            avx2StoreWords(_mm256_cvtepu8_epi16(lo), out + o);
+            avx2StoreWords(_mm256_cvtepu8_epi16(hi), out + o + 16);
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        __m256i errors = avx2Utf8Errors(in, zero, highest);
+        auto bad = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(errors, zero)));
+        __m256i cutOff = _mm256_subs_epu8(in, incompleteMax);
+        auto stop = stepStop(p + i, 32, bad, !_mm256_testz_si256(cutOff, cutOff));
+        auto fours = static_cast<uint32_t>(_mm256_movemask_epi8(
+                         _mm256_cmpeq_epi8(_mm256_max_epu8(in, fourByteLead), in))) &
+                     static_cast<uint32_t>((1ull << stop) - 1);
+        auto vectorStop = fours == 0 ? stop : lowestSetBit(fours);
+        auto leads = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+                         _mm256_cmpeq_epi8(_mm256_and_si256(in, topTwo), continuation))) &
+                     static_cast<uint32_t>((1ull << vectorStop) - 1);
+
+        o += avx2PackLeads(lo, _mm_alignr_epi8(hi, lo, 1), _mm_alignr_epi8(hi, lo, 2),
+                           leads & 0xffff, pack, out + o);
+        o += avx2PackLeads(hi, _mm_srli_si128(hi, 1), _mm_srli_si128(hi, 2),
+                           leads >> 16, pack, out + o);
+        checkedUtf8Through(p, i + vectorStop, i + stop, out, o);
+        i += stop;
+        if (bad != 0)
+        {
+            break;
+        }
+    }
+
+    i = widenAsciiTail(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// UTF-16 or UCS-4 to UTF-8, eight characters to a register
+
+ANSAK_TARGET_AVX2
+inline size_t avx2PackUtf8
+(
+    __m256i                 c,          // I - eight characters, one to a 32-bit lane
+    const uint8_t*          table,      // I - packUtf8Table()
+    char*                   out         // O - where to put their UTF-8
+)
+{
+    const __m256i low6 = _mm256_set1_epi32(0x3f);
+    __m256i twoOrMore = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7f));
+    __m256i three = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7ff));
+    __m256i asTwo = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(c, 6),
+                                                    _mm256_slli_epi32(_mm256_and_si256(c, low6), 8)),
+                                    _mm256_set1_epi32(0x80c0));
+    __m256i asThree = _mm256_or_si256(
+                          _mm256_or_si256(_mm256_srli_epi32(c, 12),
+                                          _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(c, 6), low6), 8)),
+                          _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, low6), 16),
+                                          _mm256_set1_epi32(0x8080e0)));
+    __m256i bytes = _mm256_blendv_epi8(_mm256_blendv_epi8(c, asTwo, twoOrMore), asThree, three);
+
+    auto twos = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(twoOrMore)));
+    auto threes = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(three)));
+    auto lowIndex = ((twos & ~threes) & 0x0f) | ((threes & 0x0f) << 4);
+    auto highIndex = ((twos & ~threes) >> 4) | (threes & 0xf0);
+    __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(sseLoad(table + 16 * lowIndex)),
+                                              sseLoad(table + 16 * highIndex), 1);
+    __m256i packed = _mm256_shuffle_epi8(bytes, shuffle);
+
+    auto n = 4 + popCount(twos & 0x0f) + popCount(threes & 0x0f);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), _mm256_extracti128_si256(packed, 1));
+    return n + 4 + popCount(twos >> 4) + popCount(threes >> 4);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Utf16ToUtf8(const char16_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m256i notAscii = _mm256_set1_epi16(static_cast<short>(0xff80));
+    const __m256i surrogateBits = _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xd800));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n && o + 32 <= room)
+    {
+        __m256i u0 = avx2Load(p + i);
+        __m256i u1 = avx2Load(p + i + 16);
+        if (_mm256_testz_si256(_mm256_or_si256(u0, u1), notAscii))
+        {
+            // packing works within 128-bit lanes; put the quarters back in order
+            __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(u0, u1), 0xd8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), bytes);
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        if (o + 3 * 32 + 4 > room)
+        {
+            break;
+        }
+        __m256i halves = _mm256_permute4x64_epi64(_mm256_packs_epi16(
+                             _mm256_cmpeq_epi16(_mm256_and_si256(u0, surrogateBits), surrogate),
+                             _mm256_cmpeq_epi16(_mm256_and_si256(u1, surrogateBits), surrogate)), 0xd8);
+        auto halfBits = static_cast<uint32_t>(_mm256_movemask_epi8(halves));
+        if (halfBits != 0)
+        {
+            // the rest of a step holding a surrogate goes a character at a time
+            size_t half = i + lowestSetBit(halfBits);
+            size_t stepEnd = i + 32;
+            o += sseGroupsToUtf8(p + i, (half - i) / 4, table, out + o);
+            i += (half - i) & ~static_cast<size_t>(3);
+            if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+            {
+                break;
+            }
+            continue;
+        }
+        for (size_t k = 0; k < 32; k += 8)
+        {
+            o += avx2PackUtf8(_mm256_cvtepu16_epi32(sseLoad(p + i + k)), table, out + o);
+        }
+        i += 32;
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Ucs4ToUtf8(const char32_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m256i notAscii = _mm256_set1_epi32(static_cast<int>(0xffffff80u));
+    const __m256i wideBits = _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+    const __m256i surrogateBits = _mm256_set1_epi32(static_cast<int>(0xfffff800u));
+    const __m256i surrogate = _mm256_set1_epi32(0xd800);
+    const __m256i zero = _mm256_setzero_si256();
+    // packing works within 128-bit lanes; this puts the quarters back in order
+    const __m256i byteOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n && o + 32 <= room)
+    {
+        __m256i c[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            c[k] = avx2Load(p + i + 8 * k);
+        }
+        if (_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(c[0], c[1]), _mm256_or_si256(c[2], c[3])),
+                               notAscii))
+        {
+            __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(c[0], c[1]), _mm256_packus_epi32(c[2], c[3]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), _mm256_permutevar8x32_epi32(bytes, byteOrder));
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        if (o + 3 * 32 + 4 > room)
+        {
+            break;
+        }
+        uint32_t others = 0;
+        for (int k = 0; k < 4; ++k)
+        {
+            __m256i bmp = _mm256_cmpeq_epi32(_mm256_and_si256(c[k], wideBits), zero);
+            __m256i half = _mm256_cmpeq_epi32(_mm256_and_si256(c[k], surrogateBits), surrogate);
+            others |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(
+                          _mm256_andnot_si256(half, bmp))) ^ 0xff) << (8 * k);
+        }
+        if (others != 0)
+        {
+            // the rest of a step holding a character beyond the BMP or a
+            // half goes one at a time
+            size_t other = i + lowestSetBit(others);
+            size_t stepEnd = i + 32;
+            o += sseGroupsToUtf8(p + i, (other - i) / 4, table, out + o);
+            i += (other - i) & ~static_cast<size_t>(3);
+            if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+            {
+                break;
+            }
+            continue;
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+            o += avx2PackUtf8(c[k], table, out + o);
+        }
+        i += 32;
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// UTF-16 to UCS-4 and back, sixteen units a step, each 128-bit lane packed
+// by its own shuffle
+
+// a bit for each of sixteen 16-bit lanes set in a comparison's result
+ANSAK_TARGET_AVX2
+inline unsigned int avx2UnitBits(__m256i lanes)
+{
+    auto bits = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_packs_epi16(lanes, _mm256_setzero_si256())));
+    return (bits & 0xff) | ((bits >> 8) & 0xff00);
+}
+
+// the lanes of eight whose bits are set in keep, in order
+ANSAK_TARGET_AVX2
+inline size_t avx2PackLanes(__m256i lanes, unsigned int keep, const uint8_t* pack, char32_t* out)
+{
+    auto low = keep & 0x0f;
+    auto high = keep >> 4;
+    __m256i shuffle = _mm256_inserti128_si256(
+                          _mm256_castsi128_si256(sseLoad(pack + 16 * (3 * spreadLanes(low)))),
+                          sseLoad(pack + 16 * (3 * spreadLanes(high))), 1);
+    __m256i packed = _mm256_shuffle_epi8(lanes, shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+    auto n = popCount(low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), _mm256_extracti128_si256(packed, 1));
+    return n + popCount(high);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Utf16ToUcs4(const char16_t* p, size_t n, char32_t* out, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m256i halfBits = _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i sideBits = _mm256_set1_epi16(static_cast<short>(0xfc00));
+    const __m256i firstHalf = _mm256_set1_epi16(static_cast<short>(0xd800));
+    const __m256i secondHalf = _mm256_set1_epi16(static_cast<short>(0xdc00));
+    const __m256i pairOffset = _mm256_set1_epi32(static_cast<int>(kUtf16PairOffset));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n)
+    {
+        __m256i u = avx2Load(p + i);
+        __m256i w0 = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(u));
+        __m256i w1 = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(u, 1));
+        __m256i halves = _mm256_cmpeq_epi16(_mm256_and_si256(u, halfBits), firstHalf);
+        if (_mm256_testz_si256(halves, halves))
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), w0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o + 8), w1);
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        __m256i sides = _mm256_and_si256(u, sideBits);
+        __m256i firstLanes = _mm256_cmpeq_epi16(sides, firstHalf);
+        auto seconds = avx2UnitBits(_mm256_cmpeq_epi16(sides, secondHalf));
+        bool lone = false;
+        auto stop = pairedStop(avx2UnitBits(firstLanes), seconds, 16, lone);
+
+        // the unit after each, across the middle of the register
+        __m256i next = _mm256_alignr_epi8(_mm256_permute2x128_si256(u, u, 0x81), u, 2);
+        __m256i pair0 = _mm256_sub_epi32(_mm256_add_epi32(_mm256_slli_epi32(w0, 10),
+                                                          _mm256_cvtepu16_epi32(_mm256_castsi256_si128(next))),
+                                         pairOffset);
+        __m256i pair1 = _mm256_sub_epi32(_mm256_add_epi32(_mm256_slli_epi32(w1, 10),
+                                                          _mm256_cvtepu16_epi32(_mm256_extracti128_si256(next, 1))),
+                                         pairOffset);
+        w0 = _mm256_blendv_epi8(w0, pair0, _mm256_cvtepi16_epi32(_mm256_castsi256_si128(firstLanes)));
+        w1 = _mm256_blendv_epi8(w1, pair1, _mm256_cvtepi16_epi32(_mm256_extracti128_si256(firstLanes, 1)));
+        auto keep = ~seconds & ((1u << stop) - 1);
+        o += avx2PackLanes(w0, keep & 0xff, pack, out + o);
+        o += avx2PackLanes(w1, keep >> 8, pack, out + o);
+        i += stop;
+        if (lone)
+        {
+            break;
+        }
+    }
+
+    i = utf16ToUcs4From(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+// a bit for each of eight characters UTF-16 or UCS-2 can't hold
+ANSAK_TARGET_AVX2
+inline unsigned int avx2Refused(__m256i c, __m256i last)
+{
+    __m256i inRange = _mm256_cmpeq_epi32(_mm256_min_epu32(c, last), c);
+    __m256i half = _mm256_cmpeq_epi32(_mm256_and_si256(c, _mm256_set1_epi32(static_cast<int>(0xfffff800u))),
+                                      _mm256_set1_epi32(0xd800));
+    return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(half, inRange)))) ^
+           0xff;
+}
+
+// the first live of eight characters out as UTF-16
+ANSAK_TARGET_AVX2
+inline size_t avx2PackPairs(__m256i c, unsigned int live, const uint8_t* pack, char16_t* out)
+{
+    __m256i first = _mm256_add_epi32(_mm256_srli_epi32(_mm256_sub_epi32(c, _mm256_set1_epi32(0x10000)), 10),
+                                     _mm256_set1_epi32(0xd800));
+    __m256i second = _mm256_or_si256(_mm256_and_si256(c, _mm256_set1_epi32(0x3ff)), _mm256_set1_epi32(0xdc00));
+    __m256i beyond = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0xffff));
+    __m256i units = _mm256_blendv_epi8(c, _mm256_or_si256(first, _mm256_slli_epi32(second, 16)), beyond);
+
+    auto pairs = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(beyond))) & live;
+    auto lowKeep = spreadLanes(live & 0x0f) | (spreadLanes(pairs & 0x0f) << 1);
+    auto highKeep = spreadLanes(live >> 4) | (spreadLanes(pairs >> 4) << 1);
+    __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(sseLoad(pack + 16 * lowKeep)),
+                                              sseLoad(pack + 16 * highKeep), 1);
+    __m256i packed = _mm256_shuffle_epi8(units, shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+    auto n = popCount(lowKeep);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + n), _mm256_extracti128_si256(packed, 1));
+    return n + popCount(highKeep);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Ucs4ToUtf16(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m256i last = _mm256_set1_epi32(0x10ffff);
+    const __m256i bmpLast = _mm256_set1_epi32(0xffff);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 16 <= n && o + 32 <= room)
+    {
+        __m256i c0 = avx2Load(p + i);
+        __m256i c1 = avx2Load(p + i + 8);
+        auto refused = avx2Refused(c0, last) | (avx2Refused(c1, last) << 8);
+        if (refused == 0 && avx2Refused(c0, bmpLast) == 0 && avx2Refused(c1, bmpLast) == 0)
+        {
+            // packing works within 128-bit lanes; put the quarters back in order
+            __m256i units = _mm256_permute4x64_epi64(_mm256_packus_epi32(c0, c1), 0xd8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), units);
+            i += 16;
+            o += 16;
+            continue;
+        }
+
+        auto stop = refused == 0 ? 16 : lowestSetBit(refused);
+        auto live = (1u << stop) - 1;
+        o += avx2PackPairs(c0, live & 0xff, pack, out + o);
+        o += avx2PackPairs(c1, live >> 8, pack, out + o);
+        i += stop;
+        if (refused != 0)
+        {
+            break;
+        }
+    }
+
+    i = ucs4ToUtf16From(p, i, n, out, room, o, 0x10ffff);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Ucs4ToUcs2(const char32_t* p, size_t n, char16_t* out)
+{
+    const __m256i last = _mm256_set1_epi32(0xffff);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m256i c0 = avx2Load(p + i);
+        __m256i c1 = avx2Load(p + i + 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi32(c0, c1), 0xd8));
+        auto refused = avx2Refused(c0, last) | (avx2Refused(c1, last) << 8);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    size_t o = i;
+    return ucs4ToUtf16From(p, i, n, out, n, o, 0xffff);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2LowerAsciiUtf8(const char* p, size_t n, char* out)
+{
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80 - 'A'));
+    const __m256i pastZ = _mm256_set1_epi8(static_cast<char>(0x80 + 26));
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m256i in = avx2Load(p + i);
+        __m256i upper = _mm256_cmpgt_epi8(pastZ, _mm256_add_epi8(in, bias));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_add_epi8(in, _mm256_and_si256(upper, caseBit)));
+        uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(in));
+        if (high != 0)
+        {
+            return i + lowestSetBit(high);
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2LowerAsciiUtf16(const char16_t* p, size_t n, char16_t* out)
+{
+    const __m256i bias = _mm256_set1_epi16(static_cast<short>(0x8000 - 'A'));
+    const __m256i pastZ = _mm256_set1_epi16(static_cast<short>(0x8000 + 26));
+    const __m256i caseBit = _mm256_set1_epi16(0x20);
+    const __m256i notAscii = _mm256_set1_epi16(static_cast<short>(0xff80));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m256i in = avx2Load(p + i);
+        __m256i upper = _mm256_cmpgt_epi16(pastZ, _mm256_add_epi16(in, bias));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_add_epi16(in, _mm256_and_si256(upper, caseBit)));
+        uint32_t high = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi16(_mm256_and_si256(in, notAscii), zero)));
+        if (high != 0)
+        {
+            return i + lowestSetBit(high) / 2;
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2LowerAsciiUcs4(const char32_t* p, size_t n, char32_t* out)
+{
+    const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u - 'A'));
+    const __m256i pastZ = _mm256_set1_epi32(static_cast<int>(0x80000000u + 26));
+    const __m256i caseBit = _mm256_set1_epi32(0x20);
+    const __m256i notAscii = _mm256_set1_epi32(static_cast<int>(0xffffff80u));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8)
+    {
+        __m256i in = avx2Load(p + i);
+        __m256i upper = _mm256_cmpgt_epi32(pastZ, _mm256_add_epi32(in, bias));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_add_epi32(in, _mm256_and_si256(upper, caseBit)));
+        uint32_t high = ~static_cast<uint32_t>(_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi32(_mm256_and_si256(in, notAscii), zero)));
+        if (high != 0)
+        {
+            return i + lowestSetBit(high) / 4;
+        }
+    }
+    return lowerAsciiFrom(p, i, n, out);
+}
+
+//=========================================================================
+// Census kernels, folding the two halves together to total them
+
+ANSAK_TARGET_AVX2
+void avx2Utf8Census(const char* p, size_t n, size_t* continuations, size_t* fourByteLeads)
+{
+    const __m256i firstLead = _mm256_set1_epi8(static_cast<char>(0xc0));
+    const __m256i firstFourByteLead = _mm256_set1_epi8(static_cast<char>(0xf0));
+    size_t conts = 0;
+    size_t fours = 0;
+    size_t i = 0;
+    while (i + 32 <= n)
+    {
+        auto stop = std::min(n, i + 32 * 255);
+        __m256i contCounts = _mm256_setzero_si256();
+        __m256i fourCounts = _mm256_setzero_si256();
+        for ( ; i + 32 <= stop; i += 32)
+        {
+            __m256i in = avx2Load(p + i);
+            contCounts = _mm256_sub_epi8(contCounts, _mm256_cmpgt_epi8(firstLead, in));
+            fourCounts = _mm256_sub_epi8(fourCounts,
+                                         _mm256_cmpeq_epi8(_mm256_max_epu8(in, firstFourByteLead), in));
+        }
+        // byte counts can't be added before summing; each half might be 255
+        conts += sseSumBytes(_mm256_castsi256_si128(contCounts)) +
+                 sseSumBytes(_mm256_extracti128_si256(contCounts, 1));
+        fours += sseSumBytes(_mm256_castsi256_si128(fourCounts)) +
+                 sseSumBytes(_mm256_extracti128_si256(fourCounts, 1));
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = static_cast<unsigned char>(p[i]);
+        conts += (c & 0xc0) == 0x80;
+        fours += c >= 0xf0;
+    }
+    *continuations = conts;
+    *fourByteLeads = fours;
+}
+
+ANSAK_TARGET_AVX2
+void avx2Utf16Census(const char16_t* p, size_t n, size_t* utf8Extra, size_t* secondHalves)
+{
+    const __m256i x80 = _mm256_set1_epi16(0x80);
+    const __m256i x800 = _mm256_set1_epi16(0x800);
+    const __m256i surrogateMask = _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xd800));
+    const __m256i halfMask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+    const __m256i secondHalf = _mm256_set1_epi16(static_cast<short>(0xdc00));
+    size_t extra = 0;
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        // at most two extra a step; keep the lanes below 0x8000 for madd
+        auto stop = std::min(n, i + 16 * 8192);
+        __m256i extraCounts = _mm256_setzero_si256();
+        __m256i secondCounts = _mm256_setzero_si256();
+        for ( ; i + 16 <= stop; i += 16)
+        {
+            __m256i in = avx2Load(p + i);
+            extraCounts = _mm256_sub_epi16(extraCounts,
+                                           _mm256_cmpeq_epi16(_mm256_max_epu16(in, x80), in));
+            extraCounts = _mm256_sub_epi16(extraCounts,
+                                           _mm256_cmpeq_epi16(_mm256_max_epu16(in, x800), in));
+            extraCounts = _mm256_add_epi16(extraCounts,
+                              _mm256_cmpeq_epi16(_mm256_and_si256(in, surrogateMask), surrogate));
+            secondCounts = _mm256_sub_epi16(secondCounts,
+                               _mm256_cmpeq_epi16(_mm256_and_si256(in, halfMask), secondHalf));
+        }
+        extra += sseSumWords(_mm256_castsi256_si128(extraCounts)) +
+                 sseSumWords(_mm256_extracti128_si256(extraCounts, 1));
+        seconds += sseSumWords(_mm256_castsi256_si128(secondCounts)) +
+                   sseSumWords(_mm256_extracti128_si256(secondCounts, 1));
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = p[i];
+        extra += (c >= 0x80) + (c >= 0x800) - ((c & 0xf800) == 0xd800);
+        seconds += (c & 0xfc00) == 0xdc00;
+    }
+    *utf8Extra = extra;
+    *secondHalves = seconds;
+}
+
+ANSAK_TARGET_AVX2
+void avx2Ucs4Census(const char32_t* p, size_t n, size_t* utf8Extra, size_t* utf16Extra)
+{
+    const __m256i x80 = _mm256_set1_epi32(0x80);
+    const __m256i x800 = _mm256_set1_epi32(0x800);
+    const __m256i x10000 = _mm256_set1_epi32(0x10000);
+    const __m256i x200000 = _mm256_set1_epi32(0x200000);
+    const __m256i x4000000 = _mm256_set1_epi32(0x4000000);
+    size_t extra8 = 0;
+    size_t extra16 = 0;
+    size_t i = 0;
+    while (i + 8 <= n)
+    {
+        auto stop = std::min(n, i + 8 * (1u << 24));
+        __m256i counts8 = _mm256_setzero_si256();
+        __m256i counts16 = _mm256_setzero_si256();
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            __m256i in = avx2Load(p + i);
+            __m256i supplementary = _mm256_cmpeq_epi32(_mm256_max_epu32(in, x10000), in);
+            counts8 = _mm256_sub_epi32(counts8, _mm256_cmpeq_epi32(_mm256_max_epu32(in, x80), in));
+            counts8 = _mm256_sub_epi32(counts8, _mm256_cmpeq_epi32(_mm256_max_epu32(in, x800), in));
+            counts8 = _mm256_sub_epi32(counts8, supplementary);
+            counts8 = _mm256_sub_epi32(counts8, _mm256_cmpeq_epi32(_mm256_max_epu32(in, x200000), in));
+            counts8 = _mm256_sub_epi32(counts8, _mm256_cmpeq_epi32(_mm256_max_epu32(in, x4000000), in));
+            counts16 = _mm256_sub_epi32(counts16, supplementary);
+        }
+        extra8 += sseSumDwords(_mm256_castsi256_si128(counts8)) +
+                  sseSumDwords(_mm256_extracti128_si256(counts8, 1));
+        extra16 += sseSumDwords(_mm256_castsi256_si128(counts16)) +
+                   sseSumDwords(_mm256_extracti128_si256(counts16, 1));
+    }
+    for ( ; i < n; ++i)
+    {
+        auto c = p[i];
+        extra8 += (c >= 0x80) + (c >= 0x800) + (c >= 0x10000) + (c >= 0x200000) + (c >= 0x4000000);
+        extra16 += c >= 0x10000;
+    }
+    *utf8Extra = extra8;
+    *utf16Extra = extra16;
+}
+
+//=========================================================================
+// Counting and checking for unicodeLength
+
+ANSAK_TARGET_AVX2
+size_t avx2Utf8Leads(const char* p, size_t n)
+{
+    size_t continuations;
+    size_t fourByteLeads;
+    avx2Utf8Census(p, n, &continuations, &fourByteLeads);
+    return n - continuations;
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2Utf16Leads(const char16_t* p, size_t n)
+{
+    const __m256i halfMask = _mm256_set1_epi16(static_cast<short>(0xfc00));
+    const __m256i secondHalf = _mm256_set1_epi16(static_cast<short>(0xdc00));
+    size_t seconds = 0;
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        // keep the lanes below 0x8000 for madd
+        auto stop = std::min(n, i + 16 * 0x7fff);
+        __m256i secondCounts = _mm256_setzero_si256();
+        for ( ; i + 16 <= stop; i += 16)
+        {
+            __m256i in = avx2Load(p + i);
+            secondCounts = _mm256_sub_epi16(secondCounts,
+                               _mm256_cmpeq_epi16(_mm256_and_si256(in, halfMask), secondHalf));
+        }
+        seconds += sseSumWords(_mm256_castsi256_si128(secondCounts)) +
+                   sseSumWords(_mm256_extracti128_si256(secondCounts, 1));
+    }
+    for ( ; i < n; ++i)
+    {
+        seconds += (p[i] & 0xfc00) == 0xdc00;
+    }
+    return n - seconds;
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2ValidUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    const __m256i halfBits = _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i sideBits = _mm256_set1_epi16(static_cast<short>(0xfc00));
+    const __m256i firstHalf = _mm256_set1_epi16(static_cast<short>(0xd800));
+    const __m256i secondHalf = _mm256_set1_epi16(static_cast<short>(0xdc00));
+    const __m256i low = _mm256_set1_epi16(static_cast<short>(lowest));
+    const __m256i ones = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        __m256i u = avx2Load(p + i);
+        __m256i below = _mm256_andnot_si256(_mm256_cmpeq_epi16(_mm256_max_epu16(u, low), u), ones);
+        __m256i stops = _mm256_or_si256(_mm256_cmpeq_epi16(_mm256_and_si256(u, halfBits), firstHalf), below);
+        if (_mm256_testz_si256(stops, stops))
+        {
+            i += 16;
+            continue;
+        }
+        __m256i sides = _mm256_and_si256(u, sideBits);
+        bool lone = false;
+        i += pairedStop(avx2UnitBits(_mm256_cmpeq_epi16(sides, firstHalf)),
+                        avx2UnitBits(_mm256_cmpeq_epi16(sides, secondHalf)), 16, lone, avx2UnitBits(below));
+        if (lone)
+        {
+            break;
+        }
+    }
+    return validUtf16From(p, i, n, lowest);
+}
+
+// a bit for each of eight characters below lowest
+ANSAK_TARGET_AVX2
+inline unsigned int avx2Below(__m256i c, __m256i lowest)
+{
+    __m256i atLeast = _mm256_cmpeq_epi32(_mm256_max_epu32(c, lowest), c);
+    return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(atLeast))) ^ 0xff;
+}
+
+ANSAK_TARGET_AVX2
+size_t avx2InRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    const __m256i low = _mm256_set1_epi32(static_cast<int>(lowest));
+    const __m256i top = _mm256_set1_epi32(static_cast<int>(last));
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m256i c0 = avx2Load(p + i);
+        __m256i c1 = avx2Load(p + i + 8);
+        auto refused = avx2Refused(c0, top) | avx2Below(c0, low) |
+                       ((avx2Refused(c1, top) | avx2Below(c1, low)) << 8);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    return inRangeUcs4From(p, i, n, lowest, last);
+}
+
+//=========================================================================
+// AVX-512 (F + BW) -- one 64-byte register per step
+
+ANSAK_TARGET_AVX512
+inline __m512i avx512Table(const uint8_t* table)
+{
+    return _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+ANSAK_TARGET_AVX512
+inline __m512i avx512Utf8Errors(__m512i input, __m512i prevInput, __m512i highest)
+{
+    using namespace utf8check;
+
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    // the 16 bytes before each lane: last lane of prevInput, first three of input
+    __m512i before = _mm512_alignr_epi64(input, prevInput, 6);
+    __m512i prev1 = _mm512_alignr_epi8(input, before, 15);
+    __m512i prev2 = _mm512_alignr_epi8(input, before, 14);
+    __m512i prev3 = _mm512_alignr_epi8(input, before, 13);
+
+    __m512i byte1High = _mm512_shuffle_epi8(avx512Table(kByte1High),
+                                            _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble));
+    __m512i byte1Low = _mm512_shuffle_epi8(avx512Table(kByte1Low), _mm512_and_si512(prev1, nibble));
+    __m512i byte2High = _mm512_shuffle_epi8(avx512Table(kByte2High),
+                                            _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble));
+    __m512i special = _mm512_and_si512(_mm512_and_si512(byte1High, byte1Low), byte2High);
+
+    __m512i must23 = _mm512_or_si512(_mm512_subs_epu8(prev2, _mm512_set1_epi8(0x60)),
+                                     _mm512_subs_epu8(prev3, _mm512_set1_epi8(0x70)));
+    __m512i must23As80 = _mm512_and_si512(must23, _mm512_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm512_or_si512(_mm512_xor_si512(must23As80, special), _mm512_subs_epu8(input, highest));
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512ValidUtf8Prefix(const char* p, size_t n, unsigned char highest)
+{
+    const __m512i highestV = _mm512_set1_epi8(static_cast<char>(highest));
+    const __m512i incompleteMax = _mm512_inserti32x4(_mm512_set1_epi8(-1),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                          utf8check::kIncompleteMax)), 3);
+    __m512i prevInput = _mm512_setzero_si512();
+    __m512i prevIncomplete = _mm512_setzero_si512();
+
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        __m512i input = _mm512_loadu_si512(p + i);
+        __m512i errors;
+        if (_mm512_movepi8_mask(input) == 0)
+        {
+            errors = prevIncomplete;
+            prevIncomplete = _mm512_setzero_si512();
+        }
+        else
+        {
+            errors = avx512Utf8Errors(input, prevInput, highestV);
+            prevIncomplete = _mm512_subs_epu8(input, incompleteMax);
+        }
+        if (_mm512_test_epi8_mask(errors, errors) != 0)
+        {
+            break;
+        }
+        prevInput = input;
+    }
+
+    return backUpToCharacterStart(p, i);
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512AsciiPrefix(const char* p, size_t n)
+{
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        uint64_t mask = _mm512_movepi8_mask(_mm512_loadu_si512(p + i));
+        if (mask != 0)
+        {
+            return i + lowestSetBit(mask);
+        }
+    }
+    if (i < n)
+    {
+        // the tail, under a load mask
+        __mmask64 live = (1ull << (n - i)) - 1;
+        uint64_t mask = _mm512_movepi8_mask(_mm512_maskz_loadu_epi8(live, p + i)) | ~live;
+        i += lowestSetBit(mask);
+    }
+    return i;
+}
+
+ANSAK_TARGET_AVX512
+void avx512WidenAsciiToUtf16(const char* p, size_t n, char16_t* out)
+{
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m512i wide = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        _mm512_storeu_si512(out + i, wide);
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char16_t>(p[i]);
+    }
+}
+
+ANSAK_TARGET_AVX512
+void avx512WidenAsciiToUcs4(const char* p, size_t n, char32_t* out)
+{
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        _mm512_storeu_si512(out + i, _mm512_cvtepu8_epi32(sseLoad(p + i)));
+    }
+    for ( ; i < n; ++i)
+    {
+        out[i] = static_cast<char32_t>(p[i]);
+    }
+}
+
+//=========================================================================
+// UTF-8 to UTF-16 or UCS-4, a 64-byte step decoded in 32-bit lanes a
+// quarter at a time, whose leads are packed together with a compress
+
+// sixteen 32-bit lanes stored as units of either width
+ANSAK_TARGET_AVX512
+inline void avx512StoreLanes(__m512i lanes, char16_t* out)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm512_cvtepi32_epi16(lanes));
+}
+
+ANSAK_TARGET_AVX512
+inline void avx512StoreLanes(__m512i lanes, char32_t* out)
+{
+    _mm512_storeu_si512(out, lanes);
+}
+
+// a step of ASCII
+ANSAK_TARGET_AVX512
+inline void avx512WidenAscii(__m512i in, char16_t* out)
+{
+    _mm512_storeu_si512(out, _mm512_cvtepu8_epi16(_mm512_castsi512_si256(in)));
+    _mm512_storeu_si512(out + 32, _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(in, 1)));
+}
+
+ANSAK_TARGET_AVX512
+inline void avx512WidenAscii(__m512i in, char32_t* out)
+{
+    _mm512_storeu_si512(out, _mm512_cvtepu8_epi32(_mm512_castsi512_si128(in)));
+    _mm512_storeu_si512(out + 16, _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(in, 1)));
+    _mm512_storeu_si512(out + 32, _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(in, 2)));
+    _mm512_storeu_si512(out + 48, _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(in, 3)));
+}
+
+template<typename C>
+ANSAK_TARGET_AVX512
+inline size_t avx512PackLeads
+(
+    __m128i                 b0,         // I - sixteen bytes
+    __m128i                 b1,         // I - the bytes one on from them
+    __m128i                 b2,         // I - and two on from them
+    __mmask16               leads,      // I - which of the sixteen lead characters
+    C*                      out         // O - where to put those characters
+)
+{
+    const __m512i low6 = _mm512_set1_epi32(0x3f);
+    __m512i w0 = _mm512_cvtepu8_epi32(b0);
+    __m512i w1 = _mm512_cvtepu8_epi32(b1);
+    __m512i w2 = _mm512_cvtepu8_epi32(b2);
+    __m512i two = _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(w0, _mm512_set1_epi32(0x1f)), 6),
+                                  _mm512_and_si512(w1, low6));
+    __m512i three = _mm512_or_si512(
+                        _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(w0, _mm512_set1_epi32(0x0f)), 12),
+                                        _mm512_slli_epi32(_mm512_and_si512(w1, low6), 6)),
+                        _mm512_and_si512(w2, low6));
+    __m512i v = _mm512_mask_blend_epi32(_mm512_cmplt_epu32_mask(w0, _mm512_set1_epi32(0x80)), two, w0);
+    v = _mm512_mask_blend_epi32(_mm512_cmpgt_epu32_mask(w0, _mm512_set1_epi32(0xdf)), v, three);
+    avx512StoreLanes(_mm512_maskz_compress_epi32(leads, v), out);
+    return popCount(leads);
+}
+
+template<typename C>
+ANSAK_TARGET_AVX512
+size_t avx512Utf8ToWide(const char* p, size_t n, C* out, size_t* produced)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i highest = _mm512_set1_epi8(static_cast<char>(sizeof(C) == 2 ? 0xef : 0xff));
+    const __m512i incompleteMax = _mm512_inserti32x4(_mm512_set1_epi8(-1),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                                          utf8check::kIncompleteMax)), 3);
+    const __m512i topTwo = _mm512_set1_epi8(static_cast<char>(0xc0));
+    const __m512i continuation = _mm512_set1_epi8(static_cast<char>(0x80));
+    const __m512i fourByteLead = _mm512_set1_epi8(static_cast<char>(0xf0));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 64 <= n)
+    {
+        __m512i in = _mm512_loadu_si512(p + i);
+        if (_mm512_movepi8_mask(in) == 0)
+        {
+            avx512WidenAscii(in, out + o);
+            i += 64;
+            o += 64;
+            continue;
+        }
+
+        __m512i errors = avx512Utf8Errors(in, zero, highest);
+        uint64_t bad = _mm512_test_epi8_mask(errors, errors);
+        __m512i cutOff = _mm512_subs_epu8(in, incompleteMax);
+        auto stop = stepStop(p + i, 64, bad, _mm512_test_epi8_mask(cutOff, cutOff) != 0);
+        uint64_t fours = _mm512_cmpge_epu8_mask(in, fourByteLead) & (stop == 64 ? ~0ull : (1ull << stop) - 1);
+        size_t vectorStop = fours == 0 ? stop : lowestSetBit(fours);
+        uint64_t leads = ~static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(_mm512_and_si512(in, topTwo),
+                                                                       continuation)) &
+                         (vectorStop == 64 ? ~0ull : (1ull << vectorStop) - 1);
+
+        // each quarter followed by the next, for the bytes one and two on
+        __m512i next = _mm512_alignr_epi64(zero, in, 2);
+        __m512i b1 = _mm512_alignr_epi8(next, in, 1);
+        __m512i b2 = _mm512_alignr_epi8(next, in, 2);
+        o += avx512PackLeads(_mm512_castsi512_si128(in), _mm512_castsi512_si128(b1),
+                             _mm512_castsi512_si128(b2), static_cast<__mmask16>(leads), out + o);
+        o += avx512PackLeads(_mm512_extracti32x4_epi32(in, 1), _mm512_extracti32x4_epi32(b1, 1),
+                             _mm512_extracti32x4_epi32(b2, 1), static_cast<__mmask16>(leads >> 16), out + o);
+        o += avx512PackLeads(_mm512_extracti32x4_epi32(in, 2), _mm512_extracti32x4_epi32(b1, 2),
+                             _mm512_extracti32x4_epi32(b2, 2), static_cast<__mmask16>(leads >> 32), out + o);
+        o += avx512PackLeads(_mm512_extracti32x4_epi32(in, 3), _mm512_extracti32x4_epi32(b1, 3),
+                             _mm512_extracti32x4_epi32(b2, 3), static_cast<__mmask16>(leads >> 48), out + o);
+        checkedUtf8Through(p, i + vectorStop, i + stop, out, o);
+        i += stop;
+        if (bad != 0)
+        {
+            break;
+        }
+    }
+
+    i = widenAsciiTail(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// UTF-16 or UCS-4 to UTF-8, sixteen characters to a register, each 128-bit
+// lane packed by its own shuffle
+
+ANSAK_TARGET_AVX512
+inline size_t avx512PackUtf8
+(
+    __m512i                 c,          // I - sixteen characters, one to a 32-bit lane
+    const uint8_t*          table,      // I - packUtf8Table()
+    char*                   out         // O - where to put their UTF-8
+)
+{
+    const __m512i low6 = _mm512_set1_epi32(0x3f);
+    __mmask16 twoOrMore = _mm512_cmpgt_epu32_mask(c, _mm512_set1_epi32(0x7f));
+    __mmask16 three = _mm512_cmpgt_epu32_mask(c, _mm512_set1_epi32(0x7ff));
+    __m512i asTwo = _mm512_or_si512(_mm512_or_si512(_mm512_srli_epi32(c, 6),
+                                                    _mm512_slli_epi32(_mm512_and_si512(c, low6), 8)),
+                                    _mm512_set1_epi32(0x80c0));
+    __m512i asThree = _mm512_or_si512(
+                          _mm512_or_si512(_mm512_srli_epi32(c, 12),
+                                          _mm512_slli_epi32(_mm512_and_si512(_mm512_srli_epi32(c, 6), low6), 8)),
+                          _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(c, low6), 16),
+                                          _mm512_set1_epi32(0x8080e0)));
+    __m512i bytes = _mm512_mask_blend_epi32(three, _mm512_mask_blend_epi32(twoOrMore, c, asTwo), asThree);
+
+    unsigned int twos = twoOrMore & ~three;
+    unsigned int threes = three;
+    unsigned int index[4];
+    size_t lengths[4];
+    for (int q = 0; q < 4; ++q)
+    {
+        index[q] = ((twos >> (4 * q)) & 0x0f) | (((threes >> (4 * q)) & 0x0f) << 4);
+        lengths[q] = 4 + popCount((twoOrMore >> (4 * q)) & 0x0f) + popCount((threes >> (4 * q)) & 0x0f);
+    }
+    __m512i shuffle = _mm512_castsi128_si512(sseLoad(table + 16 * index[0]));
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(table + 16 * index[1]), 1);
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(table + 16 * index[2]), 2);
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(table + 16 * index[3]), 3);
+    __m512i packed = _mm512_shuffle_epi8(bytes, shuffle);
+
+    size_t o = 0;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm512_castsi512_si128(packed));
+    o += lengths[0];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 1));
+    o += lengths[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 2));
+    o += lengths[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 3));
+    return o + lengths[3];
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512Utf16ToUtf8(const char16_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m512i notAscii = _mm512_set1_epi16(static_cast<short>(0xff80));
+    const __m512i surrogateBits = _mm512_set1_epi16(static_cast<short>(0xf800));
+    const __m512i surrogate = _mm512_set1_epi16(static_cast<short>(0xd800));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n && o + 32 <= room)
+    {
+        __m512i u = _mm512_loadu_si512(p + i);
+        if (_mm512_test_epi16_mask(u, notAscii) == 0)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), _mm512_cvtepi16_epi8(u));
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        if (o + 3 * 32 + 4 > room)
+        {
+            break;
+        }
+        uint32_t halves = _mm512_cmpeq_epi16_mask(_mm512_and_si512(u, surrogateBits), surrogate);
+        if (halves != 0)
+        {
+            // the rest of a step holding a surrogate goes a character at a time
+            size_t half = i + lowestSetBit(halves);
+            size_t stepEnd = i + 32;
+            o += sseGroupsToUtf8(p + i, (half - i) / 4, table, out + o);
+            i += (half - i) & ~static_cast<size_t>(3);
+            if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+            {
+                break;
+            }
+            continue;
+        }
+        o += avx512PackUtf8(_mm512_cvtepu16_epi32(_mm512_castsi512_si256(u)), table, out + o);
+        o += avx512PackUtf8(_mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(u, 1)), table, out + o);
+        i += 32;
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512Ucs4ToUtf8(const char32_t* p, size_t n, char* out, size_t room, size_t* produced)
+{
+    const uint8_t* table = packUtf8Table();
+    const __m512i notAscii = _mm512_set1_epi32(static_cast<int>(0xffffff80u));
+    const __m512i beyondBmp = _mm512_set1_epi32(0xffff);
+    const __m512i surrogateBits = _mm512_set1_epi32(static_cast<int>(0xfffff800u));
+    const __m512i surrogate = _mm512_set1_epi32(0xd800);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n && o + 32 <= room)
+    {
+        __m512i c0 = _mm512_loadu_si512(p + i);
+        __m512i c1 = _mm512_loadu_si512(p + i + 16);
+        if (_mm512_test_epi32_mask(_mm512_or_si512(c0, c1), notAscii) == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_cvtepi32_epi8(c0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o + 16), _mm512_cvtepi32_epi8(c1));
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        if (o + 3 * 32 + 4 > room)
+        {
+            break;
+        }
+        uint32_t others = static_cast<uint32_t>(
+                              _mm512_cmpgt_epu32_mask(c0, beyondBmp) |
+                              _mm512_cmpeq_epi32_mask(_mm512_and_si512(c0, surrogateBits), surrogate)) |
+                          (static_cast<uint32_t>(
+                              _mm512_cmpgt_epu32_mask(c1, beyondBmp) |
+                              _mm512_cmpeq_epi32_mask(_mm512_and_si512(c1, surrogateBits), surrogate)) << 16);
+        if (others != 0)
+        {
+            // the rest of a step holding a character beyond the BMP or a
+            // half goes one at a time
+            size_t other = i + lowestSetBit(others);
+            size_t stepEnd = i + 32;
+            o += sseGroupsToUtf8(p + i, (other - i) / 4, table, out + o);
+            i += (other - i) & ~static_cast<size_t>(3);
+            if (!toUtf8Through(p, i, stepEnd, n, out, room, o))
+            {
+                break;
+            }
+            continue;
+        }
+        o += avx512PackUtf8(c0, table, out + o);
+        o += avx512PackUtf8(c1, table, out + o);
+        i += 32;
+    }
+
+    i = narrowAsciiTail(p, i, n, out, room, o);
+    *produced = o;
+    return i;
+}
+
+//=========================================================================
+// UTF-16 to UCS-4 with a compress per sixteen lanes, and back with a
+// shuffle per 128-bit lane
+
+ANSAK_TARGET_AVX512
+size_t avx512Utf16ToUcs4(const char16_t* p, size_t n, char32_t* out, size_t* produced)
+{
+    const __m512i halfBits = _mm512_set1_epi16(static_cast<short>(0xf800));
+    const __m512i sideBits = _mm512_set1_epi16(static_cast<short>(0xfc00));
+    const __m512i firstHalf = _mm512_set1_epi16(static_cast<short>(0xd800));
+    const __m512i secondHalf = _mm512_set1_epi16(static_cast<short>(0xdc00));
+    const __m512i pairOffset = _mm512_set1_epi32(static_cast<int>(kUtf16PairOffset));
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n)
+    {
+        __m512i u = _mm512_loadu_si512(p + i);
+        __m512i w0 = _mm512_cvtepu16_epi32(_mm512_castsi512_si256(u));
+        __m512i w1 = _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(u, 1));
+        if (_mm512_cmpeq_epi16_mask(_mm512_and_si512(u, halfBits), firstHalf) == 0)
+        {
+            _mm512_storeu_si512(out + o, w0);
+            _mm512_storeu_si512(out + o + 16, w1);
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        __m512i sides = _mm512_and_si512(u, sideBits);
+        uint32_t firsts = _mm512_cmpeq_epi16_mask(sides, firstHalf);
+        uint32_t seconds = _mm512_cmpeq_epi16_mask(sides, secondHalf);
+        bool lone = false;
+        auto stop = pairedStop(firsts, seconds, 32, lone);
+
+        // the unit after each, with none after the last
+        __m512i next = _mm512_maskz_loadu_epi16(0x7fffffff, p + i + 1);
+        __m512i pair0 = _mm512_sub_epi32(_mm512_add_epi32(_mm512_slli_epi32(w0, 10),
+                                                          _mm512_cvtepu16_epi32(_mm512_castsi512_si256(next))),
+                                         pairOffset);
+        __m512i pair1 = _mm512_sub_epi32(_mm512_add_epi32(_mm512_slli_epi32(w1, 10),
+                                                          _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(next, 1))),
+                                         pairOffset);
+        w0 = _mm512_mask_blend_epi32(static_cast<__mmask16>(firsts), w0, pair0);
+        w1 = _mm512_mask_blend_epi32(static_cast<__mmask16>(firsts >> 16), w1, pair1);
+        uint32_t keep = ~seconds & static_cast<uint32_t>((1ull << stop) - 1);
+        _mm512_storeu_si512(out + o, _mm512_maskz_compress_epi32(static_cast<__mmask16>(keep), w0));
+        o += popCount(keep & 0xffff);
+        _mm512_storeu_si512(out + o, _mm512_maskz_compress_epi32(static_cast<__mmask16>(keep >> 16), w1));
+        o += popCount(keep >> 16);
+        i += stop;
+        if (lone)
+        {
+            break;
+        }
+    }
+
+    i = utf16ToUcs4From(p, i, n, out, o);
+    *produced = o;
+    return i;
+}
+
+// a bit for each of sixteen characters UTF-16 or UCS-2 can't hold
+ANSAK_TARGET_AVX512
+inline uint32_t avx512Refused(__m512i c, __m512i last)
+{
+    __mmask16 half = _mm512_cmpeq_epi32_mask(_mm512_and_si512(c, _mm512_set1_epi32(static_cast<int>(0xfffff800u))),
+                                             _mm512_set1_epi32(0xd800));
+    return static_cast<uint32_t>(_mm512_cmpgt_epu32_mask(c, last) | half);
+}
+
+// the first live of sixteen characters out as UTF-16
+ANSAK_TARGET_AVX512
+inline size_t avx512PackPairs(__m512i c, unsigned int live, const uint8_t* pack, char16_t* out)
+{
+    // every lane masked in: GCC's unmasked form starts from an undefined
+    // vector, which -Wuninitialized catches at -O1 here
+    __m512i offset = _mm512_sub_epi32(c, _mm512_set1_epi32(0x10000));
+    __m512i first = _mm512_add_epi32(_mm512_maskz_srli_epi32(0xffff, offset, 10), _mm512_set1_epi32(0xd800));
+    __m512i second = _mm512_or_si512(_mm512_and_si512(c, _mm512_set1_epi32(0x3ff)), _mm512_set1_epi32(0xdc00));
+    __mmask16 beyond = _mm512_cmpgt_epu32_mask(c, _mm512_set1_epi32(0xffff));
+    __m512i units = _mm512_mask_blend_epi32(beyond, c, _mm512_or_si512(first, _mm512_slli_epi32(second, 16)));
+
+    unsigned int pairs = beyond & live;
+    unsigned int keep[4];
+    for (int q = 0; q < 4; ++q)
+    {
+        keep[q] = spreadLanes((live >> (4 * q)) & 0x0f) | (spreadLanes((pairs >> (4 * q)) & 0x0f) << 1);
+    }
+    __m512i shuffle = _mm512_castsi128_si512(sseLoad(pack + 16 * keep[0]));
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(pack + 16 * keep[1]), 1);
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(pack + 16 * keep[2]), 2);
+    shuffle = _mm512_inserti32x4(shuffle, sseLoad(pack + 16 * keep[3]), 3);
+    __m512i packed = _mm512_shuffle_epi8(units, shuffle);
+
+    size_t o = 0;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm512_castsi512_si128(packed));
+    o += popCount(keep[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 1));
+    o += popCount(keep[1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 2));
+    o += popCount(keep[2]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm512_extracti32x4_epi32(packed, 3));
+    return o + popCount(keep[3]);
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512Ucs4ToUtf16(const char32_t* p, size_t n, char16_t* out, size_t room, size_t* produced)
+{
+    const uint8_t* pack = packWordsTable();
+    const __m512i last = _mm512_set1_epi32(0x10ffff);
+    const __m512i bmpLast = _mm512_set1_epi32(0xffff);
+
+    size_t i = 0;
+    size_t o = 0;
+    while (i + 32 <= n && o + 64 <= room)
+    {
+        __m512i c0 = _mm512_loadu_si512(p + i);
+        __m512i c1 = _mm512_loadu_si512(p + i + 16);
+        uint32_t refused = avx512Refused(c0, last) | (avx512Refused(c1, last) << 16);
+        if (_mm512_cmpgt_epu32_mask(_mm512_max_epu32(c0, c1), bmpLast) == 0 && refused == 0)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), _mm512_cvtepi32_epi16(c0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o + 16), _mm512_cvtepi32_epi16(c1));
+            i += 32;
+            o += 32;
+            continue;
+        }
+
+        auto stop = refused == 0 ? 32 : lowestSetBit(refused);
+        auto live = static_cast<uint32_t>((1ull << stop) - 1);
+        o += avx512PackPairs(c0, live & 0xffff, pack, out + o);
+        o += avx512PackPairs(c1, live >> 16, pack, out + o);
+        i += stop;
+        if (refused != 0)
+        {
+            break;
+        }
+    }
+
+    i = ucs4ToUtf16From(p, i, n, out, room, o, 0x10ffff);
+    *produced = o;
+    return i;
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512Ucs4ToUcs2(const char32_t* p, size_t n, char16_t* out)
+{
+    const __m512i last = _mm512_set1_epi32(0xffff);
+    size_t i = 0;
+    for ( ; i + 16 <= n; i += 16)
+    {
+        __m512i c = _mm512_loadu_si512(p + i);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(c));
+        auto refused = avx512Refused(c, last);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    size_t o = i;
+    return ucs4ToUtf16From(p, i, n, out, n, o, 0xffff);
+}
+
+//=========================================================================
+// Counting leads a mask at a time, and checking for unicodeLength
+
+ANSAK_TARGET_AVX512
+size_t avx512Utf8Leads(const char* p, size_t n)
+{
+    // as signed bytes, everything but a continuation is above 0xbf
+    const __m512i lastContinuation = _mm512_set1_epi8(static_cast<char>(0xbf));
+    size_t leads = 0;
+    size_t i = 0;
+    for ( ; i + 64 <= n; i += 64)
+    {
+        leads += popCount(_mm512_cmpgt_epi8_mask(_mm512_loadu_si512(p + i), lastContinuation));
+    }
+    __mmask64 tail = (1ull << (n - i)) - 1;
+    return leads + popCount(_mm512_mask_cmpgt_epi8_mask(tail, _mm512_maskz_loadu_epi8(tail, p + i),
+                                                        lastContinuation));
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512Utf16Leads(const char16_t* p, size_t n)
+{
+    const __m512i sideBits = _mm512_set1_epi16(static_cast<short>(0xfc00));
+    const __m512i secondHalf = _mm512_set1_epi16(static_cast<short>(0xdc00));
+    size_t leads = 0;
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m512i in = _mm512_loadu_si512(p + i);
+        leads += popCount(_mm512_cmpneq_epi16_mask(_mm512_and_si512(in, sideBits), secondHalf));
+    }
+    __mmask32 tail = (1u << (n - i)) - 1;
+    __m512i in = _mm512_maskz_loadu_epi16(tail, p + i);
+    return leads + popCount(_mm512_mask_cmpneq_epi16_mask(tail, _mm512_and_si512(in, sideBits), secondHalf));
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512ValidUtf16Prefix(const char16_t* p, size_t n, char16_t lowest)
+{
+    const __m512i halfBits = _mm512_set1_epi16(static_cast<short>(0xf800));
+    const __m512i sideBits = _mm512_set1_epi16(static_cast<short>(0xfc00));
+    const __m512i firstHalf = _mm512_set1_epi16(static_cast<short>(0xd800));
+    const __m512i secondHalf = _mm512_set1_epi16(static_cast<short>(0xdc00));
+    const __m512i low = _mm512_set1_epi16(static_cast<short>(lowest));
+    size_t i = 0;
+    while (i + 32 <= n)
+    {
+        __m512i u = _mm512_loadu_si512(p + i);
+        uint32_t below = _mm512_cmplt_epu16_mask(u, low);
+        if ((_mm512_cmpeq_epi16_mask(_mm512_and_si512(u, halfBits), firstHalf) | below) == 0)
+        {
+            i += 32;
+            continue;
+        }
+        __m512i sides = _mm512_and_si512(u, sideBits);
+        bool lone = false;
+        i += pairedStop(_mm512_cmpeq_epi16_mask(sides, firstHalf), _mm512_cmpeq_epi16_mask(sides, secondHalf),
+                        32, lone, below);
+        if (lone)
+        {
+            break;
+        }
+    }
+    return validUtf16From(p, i, n, lowest);
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512InRangeUcs4Prefix(const char32_t* p, size_t n, char32_t lowest, char32_t last)
+{
+    const __m512i low = _mm512_set1_epi32(static_cast<int>(lowest));
+    const __m512i top = _mm512_set1_epi32(static_cast<int>(last));
+    size_t i = 0;
+    for ( ; i + 32 <= n; i += 32)
+    {
+        __m512i c0 = _mm512_loadu_si512(p + i);
+        __m512i c1 = _mm512_loadu_si512(p + i + 16);
+        uint32_t refused = (avx512Refused(c0, top) | _mm512_cmplt_epu32_mask(c0, low)) |
+                           ((avx512Refused(c1, top) | _mm512_cmplt_epu32_mask(c1, low)) << 16);
+        if (refused != 0)
+        {
+            return i + lowestSetBit(refused);
+        }
+    }
+    return inRangeUcs4From(p, i, n, lowest, last);
+}
+
+//=========================================================================
+// AVX-512 compares unsigned into a mask register and adds under it; the
+// tail goes through load and store masks
+
+ANSAK_TARGET_AVX512
+size_t avx512LowerAsciiUtf8(const char* p, size_t n, char* out)
+{
+    const __m512i letterA = _mm512_set1_epi8('A');
+    const __m512i letters = _mm512_set1_epi8(26);
+    const __m512i caseBit = _mm512_set1_epi8(0x20);
+    size_t i = 0;
+    while (i < n)
+    {
+        __mmask64 live = n - i >= 64 ? ~0ull : (1ull << (n - i)) - 1;
+        __m512i in = _mm512_maskz_loadu_epi8(live, p + i);
+        __mmask64 upper = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(in, letterA), letters);
+        _mm512_mask_storeu_epi8(out + i, live, _mm512_mask_add_epi8(in, upper, in, caseBit));
+        uint64_t high = _mm512_movepi8_mask(in) | ~live;
+        if (high != 0)
+        {
+            return i + lowestSetBit(high);
+        }
+        i += 64;
+    }
+    return i;
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512LowerAsciiUtf16(const char16_t* p, size_t n, char16_t* out)
+{
+    const __m512i letterA = _mm512_set1_epi16('A');
+    const __m512i letters = _mm512_set1_epi16(26);
+    const __m512i caseBit = _mm512_set1_epi16(0x20);
+    const __m512i notAscii = _mm512_set1_epi16(static_cast<short>(0xff80));
+    size_t i = 0;
+    while (i < n)
+    {
+        __mmask32 live = n - i >= 32 ? ~0u : (1u << (n - i)) - 1;
+        __m512i in = _mm512_maskz_loadu_epi16(live, p + i);
+        __mmask32 upper = _mm512_cmplt_epu16_mask(_mm512_sub_epi16(in, letterA), letters);
+        _mm512_mask_storeu_epi16(out + i, live, _mm512_mask_add_epi16(in, upper, in, caseBit));
+        uint32_t high = _mm512_test_epi16_mask(in, notAscii) | ~live;
+        if (high != 0)
+        {
+            return i + lowestSetBit(high);
+        }
+        i += 32;
+    }
+    return i;
+}
+
+ANSAK_TARGET_AVX512
+size_t avx512LowerAsciiUcs4(const char32_t* p, size_t n, char32_t* out)
+{
+    const __m512i letterA = _mm512_set1_epi32('A');
+    const __m512i letters = _mm512_set1_epi32(26);
+    const __m512i caseBit = _mm512_set1_epi32(0x20);
+    const __m512i notAscii = _mm512_set1_epi32(static_cast<int>(0xffffff80u));
+    size_t i = 0;
+    while (i < n)
+    {
+        __mmask16 live = static_cast<__mmask16>(n - i >= 16 ? 0xffffu : (1u << (n - i)) - 1);
+        __m512i in = _mm512_maskz_loadu_epi32(live, p + i);
+        __mmask16 upper = _mm512_cmplt_epu32_mask(_mm512_sub_epi32(in, letterA), letters);
+        _mm512_mask_storeu_epi32(out + i, live, _mm512_mask_add_epi32(in, upper, in, caseBit));
+        uint32_t high = static_cast<uint32_t>(_mm512_test_epi32_mask(in, notAscii) | ~live) & 0xffff;
+        if (high != 0)
+        {
+            return i + lowestSetBit(high);
+        }
+        i += 16;
+    }
+    return i;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+const SimdKernels sse42Kernels = {
+    sse42ValidUtf8Prefix,
+    sse42AsciiPrefix,
+    sse42WidenAsciiToUtf16,
+    sse42WidenAsciiToUcs4,
+    sse42Utf8ToWide<char16_t>,
+    sse42Utf8ToWide<char32_t>,
+    sse42Utf16ToUtf8,
+    sse42Ucs4ToUtf8,
+    sse42Utf16ToUcs4,
+    sse42Ucs4ToUtf16,
+    sse42Ucs4ToUcs2,
+    sse42LowerAsciiUtf8,
+    sse42LowerAsciiUtf16,
+    sse42LowerAsciiUcs4,
+    sse42Utf8Census,
+    sse42Utf16Census,
+    sse42Ucs4Census,
+    sse42Utf8Leads,
+    sse42Utf16Leads,
+    sse42ValidUtf16Prefix,
+    sse42InRangeUcs4Prefix
+};
+
+const SimdKernels avx2Kernels = {
+    avx2ValidUtf8Prefix,
+    avx2AsciiPrefix,
+    avx2WidenAsciiToUtf16,
+    avx2WidenAsciiToUcs4,
+    avx2Utf8ToWide<char16_t>,
+    avx2Utf8ToWide<char32_t>,
+    avx2Utf16ToUtf8,
+    avx2Ucs4ToUtf8,
+    avx2Utf16ToUcs4,
+    avx2Ucs4ToUtf16,
+    avx2Ucs4ToUcs2,
+    avx2LowerAsciiUtf8,
+    avx2LowerAsciiUtf16,
+    avx2LowerAsciiUcs4,
+    avx2Utf8Census,
+    avx2Utf16Census,
+    avx2Ucs4Census,
+    avx2Utf8Leads,
+    avx2Utf16Leads,
+    avx2ValidUtf16Prefix,
+    avx2InRangeUcs4Prefix
+};
+
+// counting is bound by memory bandwidth well before AVX2 runs out of
+// lanes, so the census kernels are shared; leads, one compare and a
+// popcount a register, are not
+const SimdKernels avx512Kernels = {
+    avx512ValidUtf8Prefix,
+    avx512AsciiPrefix,
+    avx512WidenAsciiToUtf16,
+    avx512WidenAsciiToUcs4,
+    avx512Utf8ToWide<char16_t>,
+    avx512Utf8ToWide<char32_t>,
+    avx512Utf16ToUtf8,
+    avx512Ucs4ToUtf8,
+    avx512Utf16ToUcs4,
+    avx512Ucs4ToUtf16,
+    avx512Ucs4ToUcs2,
+    avx512LowerAsciiUtf8,
+    avx512LowerAsciiUtf16,
+    avx512LowerAsciiUcs4,
+    avx2Utf8Census,
+    avx2Utf16Census,
+    avx2Ucs4Census,
+    avx512Utf8Leads,
+    avx512Utf16Leads,
+    avx512ValidUtf16Prefix,
+    avx512InRangeUcs4Prefix
+};
+
+}
+
+}
+
+#endif
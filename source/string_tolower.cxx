@@ -41,6 +41,11 @@
 
 #include "string.hxx"
 #include "string_internal.hxx"
+#include "string_simd.hxx"
+#include "string_utf8_dfa.hxx"
+
+#include <algorithm>
+#include <string.h>
 
 using namespace std;
 using namespace ansak::internal;
@@ -84,6 +89,235 @@ bool isTurkicLang(const char* lang)
     return false;
 }
 
+//=========================================================================
+// One character lower-cased, Turkic or not, picked at compile time so the
+// table lookup inlines into the loops below
+
+template<bool Turkic>
+char32_t lowerOne(char32_t c)
+{
+    return Turkic ? internal::turkicToLower(c) : internal::toLower(c);
+}
+
+//=========================================================================
+// How far the 7-bit fast path may run from p: to end, except that Turkic
+// lower-casing sends 'I' (to dotless i) down the per-character path. The
+// caller keeps the next 'I' between calls so the string is searched once.
+
+template<bool Turkic, typename C>
+const C* asciiLimit
+(
+    const C*                p,          // I - where the fast path starts
+    const C*                end,        // I - end of the source
+    const C*&               nextI       // I/O - the next 'I' at or after p
+)
+{
+    if (!Turkic)
+    {
+        return end;
+    }
+    if (nextI < p)
+    {
+        nextI = find(p, end, static_cast<C>('I'));
+    }
+    return nextI;
+}
+
+//=========================================================================
+// Make sure a result being written in place has room for what's left of the
+// source (7-bit units map one to one) after the units about to be added.
+
+template<typename C>
+void keepRoom
+(
+    ResultSink<C>&          result,     // I/O - the result so far
+    C*&                     out,        // I/O - where it starts
+    size_t&                 room,       // I/O - its length
+    size_t                  produced,   // I - units of it written
+    size_t                  adding,     // I - units about to be written
+    size_t                  remaining   // I - source units after those
+)
+{
+    auto needed = produced + adding + remaining;
+    if (needed > room)
+    {
+        room = needed + needed / 8;
+        out = result.resize(room);
+    }
+}
+
+template<bool Turkic>
+bool lowerUtf8
+(
+    const char*             src,        // I - the source
+    size_t                  srcLength,  // I - its length in bytes
+    ResultSink<char>&       result      // I/O - what to add the result to
+)
+{
+    auto base = result.size();
+    auto room = base + srcLength;
+    auto out = result.resize(room);
+    auto end = src + srcLength;
+    auto nextI = Turkic ? find(src, end, 'I') : end;
+    size_t produced = base;
+    for (auto p = src; p < end; )
+    {
+        auto limit = asciiLimit<Turkic>(p, end, nextI);
+        auto n = lowerAsciiPrefix(p, static_cast<size_t>(limit - p), out + produced);
+        p += n;
+        produced += n;
+        if (p == end)
+        {
+            break;
+        }
+
+        auto q = p;
+        auto c = utf8dfa::decode(q, end);
+        if (q == nullptr || isFirstHalfUtf16(c) || isSecondHalfUtf16(c))
+        {
+            result.resize(base);
+            return false;
+        }
+        if (q == end)
+        {
+            break;
+        }
+        p = q + 1;
+
+        char units[6];
+        auto k = encodeUnits(lowerOne<Turkic>(c), units);
+        keepRoom(result, out, room, produced, k, static_cast<size_t>(end - p));
+        memcpy(out + produced, units, k);
+        produced += k;
+    }
+    result.resize(produced);
+    return true;
+}
+
+template<bool Turkic>
+bool lowerUtf16
+(
+    const char16_t*         src,        // I - the source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    ResultSink<char16_t>&   result      // I/O - what to add the result to
+)
+{
+    auto base = result.size();
+    auto room = base + srcLength;
+    auto out = result.resize(room);
+    auto end = src + srcLength;
+    auto nextI = Turkic ? find(src, end, 'I') : end;
+    size_t produced = base;
+    for (auto p = src; p < end; )
+    {
+        auto limit = asciiLimit<Turkic>(p, end, nextI);
+        auto n = lowerAsciiPrefix(p, static_cast<size_t>(limit - p), out + produced);
+        p += n;
+        produced += n;
+        if (p == end)
+        {
+            break;
+        }
+
+        char32_t c = *p;
+        if (isFirstHalfUtf16(c))
+        {
+            if (p + 1 == end)
+            {
+                break;
+            }
+            if (!isSecondHalfUtf16(p[1]))
+            {
+                result.resize(base);
+                return false;
+            }
+            c = rawDecodeUtf16(p[0], p[1]);
+            p += 2;
+        }
+        else if (isSecondHalfUtf16(c))
+        {
+            result.resize(base);
+            return false;
+        }
+        else
+        {
+            ++p;
+        }
+
+        char16_t units[2];
+        auto k = encodeUnits(lowerOne<Turkic>(c), units);
+        keepRoom(result, out, room, produced, k, static_cast<size_t>(end - p));
+        copy(units, units + k, out + produced);
+        produced += k;
+    }
+    result.resize(produced);
+    return true;
+}
+
+template<bool Turkic>
+bool lowerUcs4
+(
+    const char32_t*         src,        // I - the source
+    size_t                  srcLength,  // I - its length in characters
+    ResultSink<char32_t>&   result      // I/O - what to add the result to
+)
+{
+    auto base = result.size();
+    auto out = result.resize(base + srcLength);
+    auto end = src + srcLength;
+    auto nextI = Turkic ? find(src, end, 'I') : end;
+    size_t produced = base;
+    for (auto p = src; p < end; )
+    {
+        auto limit = asciiLimit<Turkic>(p, end, nextI);
+        auto n = lowerAsciiPrefix(p, static_cast<size_t>(limit - p), out + produced);
+        p += n;
+        produced += n;
+        if (p < end)
+        {
+            out[produced++] = lowerOne<Turkic>(*p++);
+        }
+    }
+    return true;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Internal Functions
+
+namespace internal {
+
+bool lowerOnto(const char* src, size_t srcLength, const char* lang, ResultSink<char>& result)
+{
+    if (src == nullptr)
+    {
+        return true;
+    }
+    return isTurkicLang(lang) ? lowerUtf8<true>(src, srcLength, result) :
+                                lowerUtf8<false>(src, srcLength, result);
+}
+
+bool lowerOnto(const char16_t* src, size_t srcLength, const char* lang, ResultSink<char16_t>& result)
+{
+    if (src == nullptr)
+    {
+        return true;
+    }
+    return isTurkicLang(lang) ? lowerUtf16<true>(src, srcLength, result) :
+                                lowerUtf16<false>(src, srcLength, result);
+}
+
+bool lowerOnto(const char32_t* src, size_t srcLength, const char* lang, ResultSink<char32_t>& result)
+{
+    if (src == nullptr)
+    {
+        return true;
+    }
+    return isTurkicLang(lang) ? lowerUcs4<true>(src, srcLength, result) :
+                                lowerUcs4<false>(src, srcLength, result);
+}
+
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -99,12 +333,32 @@ utf8String toLower
     const char*             lang        // I - the optional language code, def nullptr
 )
 {
-    ucs4String src4(toUcs4(src));
-    if (src4.empty())
+    return toLower(src.c_str(), lang);
+}
+
+utf8String toLower
+(
+    const char*             src,        // I - the null-terminated source
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    return toLower(src, src ? strlen(src) : 0, lang);
+}
+
+utf8String toLower
+(
+    const char*             src,        // I - the length-delimited source
+    size_t                  srcLength,  // I - its length in bytes
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    utf8String result;
+    if (src != nullptr && srcLength != 0)
     {
-        return utf8String();
+        StringSink<char, allocator<char>> sink(result);
+        lowerOnto(src, srcLength, lang, sink);
     }
-    return toUtf8(toLower(src4, lang));
+    return result;
 }
 
 // From UCS-2/UTF-16 /////////////////////////////////////
@@ -115,12 +369,32 @@ utf16String toLower
     const char*             lang        // I - the optional language code, def nullptr
 )
 {
-    ucs4String src4(toUcs4(src));
-    if (src4.empty())
+    return toLower(src.c_str(), lang);
+}
+
+utf16String toLower
+(
+    const char16_t*         src,        // I - the null-terminated source
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    return toLower(src, src ? char_traits<char16_t>::length(src) : 0, lang);
+}
+
+utf16String toLower
+(
+    const char16_t*         src,        // I - the length-delimited source
+    size_t                  srcLength,  // I - its length in 16-bit units
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    utf16String result;
+    if (src != nullptr && srcLength != 0)
     {
-        return utf16String();
+        StringSink<char16_t, allocator<char16_t>> sink(result);
+        lowerOnto(src, srcLength, lang, sink);
     }
-    return toUtf16(toLower(src4, lang));
+    return result;
 }
 
 // From UCS-4 ////////////////////////////////////////////
@@ -131,16 +405,31 @@ ucs4String toLower
     const char*             lang        // I - the optional language code, def nullptr
 )
 {
-    auto toLowerFunc = isTurkicLang(lang) ? internal::turkicToLower :
-                                            internal::toLower;
-    ucs4String result;
-    CharacterAdder<char32_t> adder(result);
+    return toLower(src.data(), src.size(), lang);
+}
 
-    for (auto c : src)
+ucs4String toLower
+(
+    const char32_t*         src,        // I - the null-terminated source
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    return toLower(src, src ? char_traits<char32_t>::length(src) : 0, lang);
+}
+
+ucs4String toLower
+(
+    const char32_t*         src,        // I - the length-delimited source
+    size_t                  srcLength,  // I - its length in characters
+    const char*             lang        // I - the optional language code, def nullptr
+)
+{
+    ucs4String result;
+    if (src != nullptr && srcLength != 0)
     {
-        adder(toLowerFunc(c));
+        StringSink<char32_t, allocator<char32_t>> sink(result);
+        lowerOnto(src, srcLength, lang, sink);
     }
-
     return result;
 }
 
@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_utf8_dfa.hxx -- the state machine behind decodeUtf8Dfa, inline so
+//                        that the library's own scanning loops can have it
+//                        without a call per character.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+namespace ansak {
+
+namespace internal {
+
+namespace utf8dfa {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Types
+
+//=========================================================================
+// A state machine (after Bjoern Hoehrmann's "Flexible and Economical UTF-8
+// Decoder") accepting exactly what decodeUtf8 accepts: 5- and 6-byte
+// forms, CESU-8 pairs, no overlongs, no lone surrogates, no checking past
+// U+10FFFF.
+//
+// Each byte falls in one of 19 classes. Like decodeUtf8, a sequence found
+// to be overlong (or a lone surrogate, or a pair's second half that isn't
+// one) only fails once all its continuation bytes have been read -- until
+// then it sits in one of the "doomed" states, so that a null arriving
+// first means "ran out", exactly as before.
+
+enum ByteClass : uint8_t {
+    kAscii,         // 00..7f
+    kCont80,        // 80..83
+    kCont84,        // 84..87
+    kCont88,        // 88..8f
+    kCont90,        // 90..9f
+    kContA0,        // a0..af
+    kContB0,        // b0..bf
+    kLeadC0,        // c0..c1, always overlong
+    kLeadC2,        // c2..df
+    kLeadE0,        // e0
+    kLeadE1,        // e1..ec, ee..ef
+    kLeadED,        // ed
+    kLeadF0,        // f0
+    kLeadF1,        // f1..f7
+    kLeadF8,        // f8
+    kLeadF9,        // f9..fb
+    kLeadFC,        // fc
+    kLeadFD,        // fd
+    kNever,         // fe..ff
+    kByteClasses
+};
+
+enum DecodeState : uint8_t {
+    kAccept,        // between characters -- where decoding starts and ends
+    kReject,
+    kNeed1,         // so many continuation bytes still to come
+    kNeed2,
+    kNeed3,
+    kNeed4,
+    kNeed5,
+    kDoomed1,       // so many continuation bytes still to come, then fail
+    kDoomed2,
+    kDoomed3,
+    kDoomed4,
+    kAfterE0,       // a0..bf to continue, 80..9f is overlong
+    kAfterED,       // 80..9f to continue, a0..af is a first half, b0..bf a lone second
+    kAfterF0,       // 90..bf to continue, 80..8f is overlong
+    kAfterF8,       // 88..bf to continue, 80..87 is overlong
+    kAfterFC,       // 84..bf to continue, 80..83 is overlong
+    kFirstHalf,     // one continuation byte left of a first half
+    kPairLead,      // a first half wants a 3-byte lead next; ed may start a second
+    kPairED,        // b0..bf is a second half, 80..af is not
+    kDecodeStates
+};
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+// the ByteClass of each byte
+extern const uint8_t kClassOf[256];
+
+// the bits of a byte in each class that carry part of the character, and
+// how far to shift what came before to make room for them
+extern const uint8_t kPayloadOf[kByteClasses];
+extern const uint8_t kShiftOf[kByteClasses];
+
+// the DecodeState after each state and byte class
+extern const uint8_t kNextState[kDecodeStates][kByteClasses];
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Start the machine on a lead byte.
+
+inline DecodeState start
+(
+    uint8_t             byte,   // I - the first byte
+    uint32_t&           bits    // O - its bits of the character
+)
+{
+    auto cls = kClassOf[byte];
+    bits = byte & kPayloadOf[cls];
+    return static_cast<DecodeState>(kNextState[kAccept][cls]);
+}
+
+//=========================================================================
+// Feed the machine one more byte. Continuation bytes add 6 bits to the
+// character; the lead of a pair's second half adds its 4.
+
+inline DecodeState step
+(
+    DecodeState         state,  // I - where the machine is
+    uint8_t             byte,   // I - the next byte
+    uint32_t&           bits    // I/O - the bits decoded so far
+)
+{
+    auto cls = kClassOf[byte];
+    bits = (bits << kShiftOf[cls]) | (byte & kPayloadOf[cls]);
+    return static_cast<DecodeState>(kNextState[state][cls]);
+}
+
+//=========================================================================
+// The result of a finished machine: the character from the bits of an
+// accepted sequence (a CESU-8 pair leaves both 16-bit halves side by side,
+// the first at d800 and up), or 0 and nullptr for a rejected one.
+
+inline char32_t finish
+(
+    DecodeState         state,  // I - kAccept or kReject
+    uint32_t            bits,   // I - the bits decoded
+    const char*&        p       // O - set to nullptr if rejected
+)
+{
+    if (state != kAccept)
+    {
+        p = nullptr;
+        return 0;
+    }
+    else if (bits >= 0xd8000000u)
+    {
+        return 0x10000 + (((bits >> 16) & 0x3ff) << 10) + (bits & 0x3ff);
+    }
+    return bits;
+}
+
+//=========================================================================
+// decodeUtf8Dfa, for inlining. See internal/string_decode_utf8.hxx. Only
+// one test a byte decides whether to go on: kAccept and kReject are the
+// two lowest states.
+
+inline char32_t decode
+(
+    const char*&        p       // I/O - points to current non-null character
+)
+{
+    // p itself is only written at the end; char reads could alias it
+    auto q = p;
+    uint32_t bits;
+    auto state = start(static_cast<uint8_t>(*q), bits);
+    while (state > kReject)
+    {
+        auto byte = static_cast<uint8_t>(*++q);
+        if (byte == 0)
+        {
+            // out of characters, cutting a sequence short
+            p = q;
+            return 0;
+        }
+        state = step(state, byte, bits);
+    }
+    p = q;
+    return finish(state, bits, p);
+}
+
+inline char32_t decode
+(
+    const char*&        p,      // I/O - points to current character
+    const char*         end     // I - one past the last byte available
+)
+{
+    auto q = p;
+    uint32_t bits;
+    auto state = start(static_cast<uint8_t>(*q), bits);
+    while (state > kReject)
+    {
+        if (++q == end)
+        {
+            p = end;
+            return 0;
+        }
+        // a null part-way is just another invalid continuation
+        state = step(state, static_cast<uint8_t>(*q), bits);
+    }
+    p = q;
+    return finish(state, bits, p);
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// char_tables_bench.cxx -- per-code-point lookups through the generated
+//                          property and lower-case tables; build with
+//                          different -DANSAK_CHAR_TABLE_BLOCK_BITS and
+//                          -DANSAK_CHAR_TABLE_PACKED to compare layouts
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <benchmark/benchmark.h>
+
+#include "string_internal.hxx"
+
+#include <random>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace std;
+
+namespace {
+
+//=========================================================================
+// Code points drawn (with a fixed seed) from one of a few ranges: ASCII,
+// the alphabets below U+0800, CJK ideographs, or anywhere in Unicode
+
+enum CodePointMix { kAsciiMix, kAlphabetMix, kCjkMix, kAnywhereMix };
+
+vector<char32_t> makeCodePoints(CodePointMix mix, size_t count)
+{
+    static const char32_t ranges[][2] = {
+        { 0x0000, 0x007F }, { 0x0000, 0x07FF }, { 0x4E00, 0x9FFF }, { 0x0000, 0x10FFFF }
+    };
+    mt19937 generator(0x616e73);
+    uniform_int_distribution<uint32_t> pick(ranges[mix][0], ranges[mix][1]);
+    vector<char32_t> result(count);
+    for (auto& c : result)
+    {
+        c = pick(generator);
+    }
+    return result;
+}
+
+void mixes(benchmark::internal::Benchmark* b)
+{
+    b->Arg(kAsciiMix)->Arg(kAlphabetMix)->Arg(kCjkMix)->Arg(kAnywhereMix);
+}
+
+const size_t kCodePointCount = 64 << 10;
+
+void BM_CharToEncodingTypeMask(benchmark::State& state)
+{
+    auto src = makeCodePoints(static_cast<CodePointMix>(state.range(0)), kCodePointCount);
+    for (auto _ : state)
+    {
+        uint32_t masks = 0;
+        for (auto c : src)
+        {
+            masks += charToEncodingTypeMask(c);
+        }
+        benchmark::DoNotOptimize(masks);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_CharToEncodingTypeMask)->Apply(mixes);
+
+void BM_CharToLower(benchmark::State& state)
+{
+    auto src = makeCodePoints(static_cast<CodePointMix>(state.range(0)), kCodePointCount);
+    for (auto _ : state)
+    {
+        char32_t lowers = 0;
+        for (auto c : src)
+        {
+            lowers += internal::toLower(c);
+        }
+        benchmark::DoNotOptimize(lowers);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_CharToLower)->Apply(mixes);
+
+}
@@ -0,0 +1,668 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_api_bench.cxx -- every public entry point, over the corpora
+//                         mkBenchCorpora generates (ASCII through CJK,
+//                         emoji and private use), reporting bytes and
+//                         code points per second
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <benchmark/benchmark.h>
+
+#include "string.hxx"
+#include "string_splitjoin.hxx"
+#include "string_trim.hxx"
+#include "bench_corpora.hxx"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace std;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////
+// Local Types
+
+//=========================================================================
+// One corpus in each Unicode form
+
+struct Corpus
+{
+    string          utf8;
+    utf16String     utf16;
+    ucs4String      ucs4;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// Local Data
+
+// French menu prose in CP1252, using the euro sign and curly quotes from
+// its 0x80-0x9f block, and Czech's best-known pangram in CP1250
+const char cp1252Sample[] =
+    "Caf\xe9 cr\xe8me br\xfbl\xe9" "e for \x80" "5, \x93na\xefve\x94 \x96 r\xe9sum\xe9 \xa7" "3. ";
+const char cp1250Sample[] =
+    "P\xf8\xedli\x9a \x9elu\x9dou\xe8k\xfd k\xf9\xf2 \xfap\xecl \xef\xe1" "belsk\xe9 \xf3" "dy. ";
+
+///////////////////////////////////////////////////////////////////////////
+// Local Functions
+
+//=========================================================================
+// Whole copies of sample up to at least length bytes, so that no character
+// is cut in half
+
+string repeatSample(const char* sample, size_t length)
+{
+    string one(sample);
+    string r;
+    r.reserve(length + one.size());
+    while (r.size() < length)
+    {
+        r += one;
+    }
+    return r;
+}
+
+//=========================================================================
+// A generated corpus file's contents, in units of C (the wider forms are
+// stored little-endian); empty if the file can't be read
+
+template<typename C>
+basic_string<C> readCorpusFile(const string& name)
+{
+    ifstream in(name.c_str(), ios::in | ios::binary);
+    ostringstream bytes;
+    bytes << in.rdbuf();
+    auto raw = bytes.str();
+
+    basic_string<C> r(raw.size() / sizeof(C), C(0));
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        uint32_t unit = 0;
+        for (size_t b = 0; b < sizeof(C); ++b)
+        {
+            unit |= static_cast<uint32_t>(static_cast<unsigned char>(raw[i * sizeof(C) + b])) << (8 * b);
+        }
+        r[i] = static_cast<C>(unit);
+    }
+    return r;
+}
+
+//=========================================================================
+// The corpus a benchmark's arguments ask for, read on first use
+
+const Corpus& corpusFor(const benchmark::State& state)
+{
+    static map<pair<int64_t, int64_t>, Corpus> corpora;
+    auto key = make_pair(state.range(0), state.range(1));
+    auto found = corpora.find(key);
+    if (found == corpora.end())
+    {
+        ostringstream baseName;
+        baseName << kBenchCorpusDir << '/' << kBenchCorpusNames[key.first] << '_' << key.second;
+        Corpus c;
+        c.utf8 = readCorpusFile<char>(baseName.str() + ".utf8");
+        c.utf16 = readCorpusFile<char16_t>(baseName.str() + ".utf16");
+        c.ucs4 = readCorpusFile<char32_t>(baseName.str() + ".ucs4");
+        found = corpora.insert(make_pair(key, c)).first;
+    }
+    return found->second;
+}
+
+//=========================================================================
+// Every corpus at every generated size; the validators also run over the
+// one with ill-formed units, to time how soon they find them
+
+void registerCorpora(benchmark::internal::Benchmark* b, bool withInvalid)
+{
+    b->ArgNames({ "corpus", "bytes" });
+    for (int kind = 0; kind < kBenchCorpusCount; ++kind)
+    {
+        if (kind == kBenchCorpusInvalid && !withInvalid)
+        {
+            continue;
+        }
+        for (int size = 0; size < kBenchCorpusSizeCount; ++size)
+        {
+            b->Args({ kind, static_cast<int64_t>(kBenchCorpusSizes[size]) });
+        }
+    }
+}
+
+void corporaAndSizes(benchmark::internal::Benchmark* b)
+{
+    registerCorpora(b, false);
+}
+
+void allCorporaAndSizes(benchmark::internal::Benchmark* b)
+{
+    registerCorpora(b, true);
+}
+
+// every corpus at its largest size, fed in chunks of so many bytes
+void registerChunks(benchmark::internal::Benchmark* b, bool withInvalid)
+{
+    b->ArgNames({ "corpus", "bytes", "chunk" });
+    auto largest = static_cast<int64_t>(kBenchCorpusSizes[kBenchCorpusSizeCount - 1]);
+    for (int kind = 0; kind < kBenchCorpusCount; ++kind)
+    {
+        if (kind == kBenchCorpusInvalid && !withInvalid)
+        {
+            continue;
+        }
+        b->Args({ kind, largest, 64 << 10 });
+        b->Args({ kind, largest, 4093 });
+    }
+}
+
+void corporaAndChunks(benchmark::internal::Benchmark* b)
+{
+    registerChunks(b, false);
+}
+
+void allCorporaAndChunks(benchmark::internal::Benchmark* b)
+{
+    registerChunks(b, true);
+}
+
+//=========================================================================
+// Run f over and over, then report the source's bytes and code points per
+// second
+
+template<typename F>
+void measure(benchmark::State& state, const Corpus& corpus, size_t sourceBytes, F f)
+{
+    if (corpus.utf8.empty())
+    {
+        state.SkipWithError("corpus missing: rebuild to regenerate it");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(f());
+    }
+    state.SetLabel(kBenchCorpusNames[state.range(0)]);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(sourceBytes));
+    state.counters["code_points"] = benchmark::Counter(static_cast<double>(corpus.ucs4.size()),
+                                                       benchmark::Counter::kIsIterationInvariantRate);
+}
+
+size_t bytesOf(const string& s) { return s.size(); }
+size_t bytesOf(const utf16String& s) { return s.size() * sizeof(char16_t); }
+size_t bytesOf(const ucs4String& s) { return s.size() * sizeof(char32_t); }
+
+//=========================================================================
+// Validators
+
+void BM_IsUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return isUtf8(c.utf8); });
+}
+BENCHMARK(BM_IsUtf8)->Apply(allCorporaAndSizes);
+
+void BM_IsUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return isUtf16(c.utf16); });
+}
+BENCHMARK(BM_IsUtf16)->Apply(allCorporaAndSizes);
+
+// (false, once it reaches a surrogate, for corpora reaching past the BMP)
+void BM_IsUcs2(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return isUcs2(c.utf16); });
+}
+BENCHMARK(BM_IsUcs2)->Apply(allCorporaAndSizes);
+
+void BM_IsUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return isUcs4(c.ucs4); });
+}
+BENCHMARK(BM_IsUcs4)->Apply(allCorporaAndSizes);
+
+// the same checks, saying where and why they fail
+void BM_ValidateUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return validateUtf8(c.utf8).offset; });
+}
+BENCHMARK(BM_ValidateUtf8)->Apply(allCorporaAndSizes);
+
+void BM_ValidateUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return validateUtf16(c.utf16).offset; });
+}
+BENCHMARK(BM_ValidateUtf16)->Apply(allCorporaAndSizes);
+
+// as a socket would deliver it: 64 KiB reads, and reads of an odd size that
+// cut characters far more often
+void BM_Utf8Validator(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto chunk = static_cast<size_t>(state.range(2));
+    measure(state, c, bytesOf(c.utf8), [&c, chunk]
+    {
+        Utf8Validator v;
+        for (size_t i = 0; i < c.utf8.size(); i += chunk)
+        {
+            v.feed(c.utf8.data() + i, min(chunk, c.utf8.size() - i));
+        }
+        return v.finish();
+    });
+}
+BENCHMARK(BM_Utf8Validator)->Apply(allCorporaAndChunks);
+
+//=========================================================================
+// Conversions, string-returning and into a caller's buffer
+
+void BM_Utf8ToUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toUtf16(c.utf8); });
+}
+BENCHMARK(BM_Utf8ToUtf16)->Apply(corporaAndSizes);
+
+// the cost of U+FFFD in place of what's malformed, on the invalid corpus too
+void BM_Utf8ToUtf16Replacing(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toUtf16(c.utf8, kConvertReplace); });
+}
+BENCHMARK(BM_Utf8ToUtf16Replacing)->Apply(allCorporaAndSizes);
+
+// (empty, once it reaches a 4-byte character, for corpora reaching past the BMP)
+void BM_Utf8ToUcs2(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toUcs2(c.utf8); });
+}
+BENCHMARK(BM_Utf8ToUcs2)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toUcs4(c.utf8); });
+}
+BENCHMARK(BM_Utf8ToUcs4)->Apply(corporaAndSizes);
+
+void BM_Utf16ToUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return toUtf8(c.utf16); });
+}
+BENCHMARK(BM_Utf16ToUtf8)->Apply(corporaAndSizes);
+
+void BM_Utf16ToUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return toUcs4(c.utf16); });
+}
+BENCHMARK(BM_Utf16ToUcs4)->Apply(corporaAndSizes);
+
+void BM_Ucs4ToUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return toUtf8(c.ucs4); });
+}
+BENCHMARK(BM_Ucs4ToUtf8)->Apply(corporaAndSizes);
+
+void BM_Ucs4ToUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return toUtf16(c.ucs4); });
+}
+BENCHMARK(BM_Ucs4ToUtf16)->Apply(corporaAndSizes);
+
+void BM_Ucs4ToUcs2(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return toUcs2(c.ucs4); });
+}
+BENCHMARK(BM_Ucs4ToUcs2)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUtf16Buffer(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    vector<char16_t> buffer(c.utf16.size() + 1);
+    measure(state, c, bytesOf(c.utf8), [&c, &buffer] {
+        return toUtf16(c.utf8.data(), c.utf8.size(), buffer.data(), buffer.size()).produced; });
+}
+BENCHMARK(BM_Utf8ToUtf16Buffer)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUcs4Buffer(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    vector<char32_t> buffer(c.ucs4.size() + 1);
+    measure(state, c, bytesOf(c.utf8), [&c, &buffer] {
+        return toUcs4(c.utf8.data(), c.utf8.size(), buffer.data(), buffer.size()).produced; });
+}
+BENCHMARK(BM_Utf8ToUcs4Buffer)->Apply(corporaAndSizes);
+
+void BM_Utf16ToUtf8Buffer(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    vector<char> buffer(c.utf8.size() + 1);
+    measure(state, c, bytesOf(c.utf16), [&c, &buffer] {
+        return toUtf8(c.utf16.data(), c.utf16.size(), buffer.data(), buffer.size()).produced; });
+}
+BENCHMARK(BM_Utf16ToUtf8Buffer)->Apply(corporaAndSizes);
+
+void BM_Ucs4ToUtf8Buffer(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    vector<char> buffer(c.utf8.size() + 1);
+    measure(state, c, bytesOf(c.ucs4), [&c, &buffer] {
+        return toUtf8(c.ucs4.data(), c.ucs4.size(), buffer.data(), buffer.size()).produced; });
+}
+BENCHMARK(BM_Ucs4ToUtf8Buffer)->Apply(corporaAndSizes);
+
+// a chunk at a time into a buffer of the same size, flushed as it fills
+void BM_Utf8ToUtf16Stream(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto chunk = static_cast<size_t>(state.range(2));
+    vector<char16_t> buffer(chunk);
+    measure(state, c, bytesOf(c.utf8), [&c, &buffer, chunk]
+    {
+        StreamConverter<char, char16_t> converter(kUtf16);
+        size_t produced = 0;
+        for (size_t i = 0; i < c.utf8.size(); )
+        {
+            auto r = converter.convert(c.utf8.data() + i, min(chunk, c.utf8.size() - i),
+                                       buffer.data(), buffer.size());
+            if (r.status != kConvertOk && r.status != kConvertTargetFull)
+            {
+                break;
+            }
+            i += r.consumed;
+            produced += r.produced;
+        }
+        return produced;
+    });
+}
+BENCHMARK(BM_Utf8ToUtf16Stream)->Apply(corporaAndChunks);
+
+//=========================================================================
+// Counting code points
+
+void BM_UnicodeLengthUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return unicodeLength(c.utf8); });
+}
+BENCHMARK(BM_UnicodeLengthUtf8)->Apply(corporaAndSizes);
+
+void BM_UnicodeLengthUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return unicodeLength(c.utf16); });
+}
+BENCHMARK(BM_UnicodeLengthUtf16)->Apply(corporaAndSizes);
+
+void BM_UnicodeLengthUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return unicodeLength(c.ucs4); });
+}
+BENCHMARK(BM_UnicodeLengthUcs4)->Apply(corporaAndSizes);
+
+//=========================================================================
+// Lower-casing, plain and Turkic
+
+void BM_LowerCaseUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toLower(c.utf8); });
+}
+BENCHMARK(BM_LowerCaseUtf8)->Apply(corporaAndSizes);
+
+void BM_LowerCaseUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return toLower(c.utf16); });
+}
+BENCHMARK(BM_LowerCaseUtf16)->Apply(corporaAndSizes);
+
+void BM_LowerCaseUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return toLower(c.ucs4); });
+}
+BENCHMARK(BM_LowerCaseUcs4)->Apply(corporaAndSizes);
+
+void BM_LowerCaseTurkicUtf8(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return toLower(c.utf8, "tr"); });
+}
+BENCHMARK(BM_LowerCaseTurkicUtf8)->Apply(corporaAndSizes);
+
+void BM_LowerCaseTurkicUtf16(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf16), [&c] { return toLower(c.utf16, "tr"); });
+}
+BENCHMARK(BM_LowerCaseTurkicUtf16)->Apply(corporaAndSizes);
+
+void BM_LowerCaseTurkicUcs4(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.ucs4), [&c] { return toLower(c.ucs4, "tr"); });
+}
+BENCHMARK(BM_LowerCaseTurkicUcs4)->Apply(corporaAndSizes);
+
+//=========================================================================
+// Many short strings: the corpus's words one call at a time, then all of
+// them in one batch
+
+vector<StringSpan<char>> wordSpans(const vector<string>& words)
+{
+    vector<StringSpan<char>> r;
+    for (auto& w : words)
+    {
+        StringSpan<char> span = { w.data(), w.size() };
+        r.push_back(span);
+    }
+    return r;
+}
+
+void BM_Utf8ToUtf16EachWord(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    measure(state, c, bytesOf(c.utf8), [&words] {
+        vector<utf16String> results;
+        results.reserve(words.size());
+        for (auto& w : words)
+        {
+            results.push_back(toUtf16(w.data(), w.size()));
+        }
+        return results.size(); });
+}
+BENCHMARK(BM_Utf8ToUtf16EachWord)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUtf16Batch(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    auto spans = wordSpans(words);
+    utf16String arena;
+    vector<size_t> offsets;
+    measure(state, c, bytesOf(c.utf8), [&spans, &arena, &offsets] {
+        toUtf16Batch(spans.data(), spans.size(), arena, offsets);
+        return arena.size(); });
+}
+BENCHMARK(BM_Utf8ToUtf16Batch)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUtf16ConcatWords(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    utf16String doc;
+    measure(state, c, bytesOf(c.utf8), [&words, &doc] {
+        doc.clear();
+        for (auto& w : words)
+        {
+            doc += toUtf16(w.data(), w.size());
+        }
+        return doc.size(); });
+}
+BENCHMARK(BM_Utf8ToUtf16ConcatWords)->Apply(corporaAndSizes);
+
+void BM_Utf8ToUtf16AppendWords(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    utf16String doc;
+    measure(state, c, bytesOf(c.utf8), [&words, &doc] {
+        doc.clear();
+        for (auto& w : words)
+        {
+            appendUtf16(doc, w.data(), w.size());
+        }
+        return doc.size(); });
+}
+BENCHMARK(BM_Utf8ToUtf16AppendWords)->Apply(corporaAndSizes);
+
+void BM_LowerCaseUtf8EachWord(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    measure(state, c, bytesOf(c.utf8), [&words] {
+        vector<utf8String> results;
+        results.reserve(words.size());
+        for (auto& w : words)
+        {
+            results.push_back(toLower(w.data(), w.size()));
+        }
+        return results.size(); });
+}
+BENCHMARK(BM_LowerCaseUtf8EachWord)->Apply(corporaAndSizes);
+
+void BM_LowerCaseUtf8Batch(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    auto spans = wordSpans(words);
+    utf8String arena;
+    vector<size_t> offsets;
+    measure(state, c, bytesOf(c.utf8), [&spans, &arena, &offsets] {
+        toLowerBatch(spans.data(), spans.size(), arena, offsets);
+        return arena.size(); });
+}
+BENCHMARK(BM_LowerCaseUtf8Batch)->Apply(corporaAndSizes);
+
+//=========================================================================
+// split, join and trim over UTF-8. trim works in place, so each pass pays
+// for a fresh copy to trim too.
+
+void BM_Split(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    measure(state, c, bytesOf(c.utf8), [&c] { return split(c.utf8, ' '); });
+}
+BENCHMARK(BM_Split)->Apply(corporaAndSizes);
+
+void BM_Join(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto words = split(c.utf8, ' ');
+    measure(state, c, bytesOf(c.utf8), [&words] { return join(words, ' '); });
+}
+BENCHMARK(BM_Join)->Apply(corporaAndSizes);
+
+void BM_Trim(benchmark::State& state)
+{
+    auto& c = corpusFor(state);
+    auto padded = string(64, ' ') + c.utf8 + string(64, ' ');
+    measure(state, c, bytesOf(padded), [&padded] {
+        auto victim = padded;
+        trim(victim);
+        return victim; });
+}
+BENCHMARK(BM_Trim)->Apply(corporaAndSizes);
+
+//=========================================================================
+// The Windows code pages, over their own text rather than the corpora
+
+template<SourceEncoding Encoding>
+void codePageToUtf8(benchmark::State& state, const char* sample)
+{
+    auto src = repeatSample(sample, static_cast<size_t>(state.range(0)));
+    auto codePoints = src.size();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUtf8(src.c_str(), Encoding));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+    state.counters["code_points"] = benchmark::Counter(static_cast<double>(codePoints),
+                                                       benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// the same sizes as the corpora
+void codePageSizes(benchmark::internal::Benchmark* b)
+{
+    for (int size = 0; size < kBenchCorpusSizeCount; ++size)
+    {
+        b->Arg(static_cast<int64_t>(kBenchCorpusSizes[size]));
+    }
+}
+
+void BM_Cp1252ToUtf8(benchmark::State& state)
+{
+    codePageToUtf8<kSrcCP1252>(state, cp1252Sample);
+}
+BENCHMARK(BM_Cp1252ToUtf8)->Apply(codePageSizes);
+
+void BM_Cp1250ToUtf8(benchmark::State& state)
+{
+    codePageToUtf8<kSrcCP1250>(state, cp1250Sample);
+}
+BENCHMARK(BM_Cp1250ToUtf8)->Apply(codePageSizes);
+
+}
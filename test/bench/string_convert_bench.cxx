@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_convert_bench.cxx -- conversions into strings sized once from an
+//                             exact length, against the same conversions
+//                             growing their result a unit at a time
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <benchmark/benchmark.h>
+
+#include "string.hxx"
+#include "internal/string_decode_utf8.hxx"
+
+#include <string>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace std;
+
+namespace {
+
+//=========================================================================
+// A mixed-script corpus: mostly ASCII with Latin-1, Cyrillic, CJK and the
+// occasional character from beyond the BMP
+
+string makeCorpus(size_t length)
+{
+    const char sample[] =
+        "The quick brown fox jumps over the lazy dog. "
+        "D\xc3\xa9j\xc3\xa0 vu, na\xc3\xafve caf\xc3\xa9. "
+        "\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 \xd0\xb5\xd1\x89\xd1\x91. "
+        "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x80\x82 "
+        "\xf0\x9f\x98\x80 ";
+    // whole copies of the sample, so no character is cut in half
+    string r;
+    r.reserve(length + sizeof(sample));
+    while (r.size() < length)
+    {
+        r += sample;
+    }
+    return r;
+}
+
+//=========================================================================
+// The same conversions the way they used to be done, appending each unit
+// to a string that grows as it goes
+
+utf16String growingToUtf16(const string& src)
+{
+    utf16String result;
+    auto end = src.data() + src.size();
+    for (auto p = src.data(); p < end; ++p)
+    {
+        auto c = decodeUtf8(p, end);
+        if (p == nullptr)
+        {
+            return utf16String();
+        }
+        if (c >= 0x10000)
+        {
+            c -= 0x10000;
+            result.push_back(static_cast<char16_t>(0xd800 + (c >> 10)));
+            result.push_back(static_cast<char16_t>(0xdc00 + (c & 0x3ff)));
+        }
+        else
+        {
+            result.push_back(static_cast<char16_t>(c));
+        }
+    }
+    return result;
+}
+
+ucs4String growingToUcs4(const string& src)
+{
+    ucs4String result;
+    auto end = src.data() + src.size();
+    for (auto p = src.data(); p < end; ++p)
+    {
+        auto c = decodeUtf8(p, end);
+        if (p == nullptr)
+        {
+            return ucs4String();
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+string growingToUtf8(const ucs4String& src)
+{
+    string result;
+    for (auto c : src)
+    {
+        if (c < 0x80)
+        {
+            result.push_back(static_cast<char>(c));
+        }
+        else if (c < 0x800)
+        {
+            result.push_back(static_cast<char>(0xc0 | (c >> 6)));
+            result.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+        }
+        else if (c < 0x10000)
+        {
+            result.push_back(static_cast<char>(0xe0 | (c >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+            result.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+        }
+        else
+        {
+            result.push_back(static_cast<char>(0xf0 | (c >> 18)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3f)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+            result.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+        }
+    }
+    return result;
+}
+
+//=========================================================================
+// Benchmarks, each over 1 KiB, 64 KiB and 16 MiB of UTF-8
+
+void sizes(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1 << 10)->Arg(64 << 10)->Arg(16 << 20);
+}
+
+void BM_Utf8ToUtf16SizedOnce(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUtf16(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Utf8ToUtf16SizedOnce)->Apply(sizes);
+
+void BM_Utf8ToUtf16Growing(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(growingToUtf16(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Utf8ToUtf16Growing)->Apply(sizes);
+
+void BM_Utf8ToUcs4SizedOnce(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUcs4(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Utf8ToUcs4SizedOnce)->Apply(sizes);
+
+void BM_Utf8ToUcs4Growing(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(growingToUcs4(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Utf8ToUcs4Growing)->Apply(sizes);
+
+void BM_Ucs4ToUtf8SizedOnce(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    auto wide = toUcs4(src);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUtf8(wide));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Ucs4ToUtf8SizedOnce)->Apply(sizes);
+
+void BM_Ucs4ToUtf8Growing(benchmark::State& state)
+{
+    auto src = makeCorpus(static_cast<size_t>(state.range(0)));
+    auto wide = toUcs4(src);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(growingToUtf8(wide));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_Ucs4ToUtf8Growing)->Apply(sizes);
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_tolower_bench.cxx -- toLower straight from UTF-8 and UTF-16,
+//                             against the round trip through UCS-4 it
+//                             used to take; and over ASCII text, at each
+//                             vector level the CPU offers
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <benchmark/benchmark.h>
+
+#include "string.hxx"
+#include "string_simd.hxx"
+
+#include <string>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace std;
+
+namespace {
+
+//=========================================================================
+// A mixed-case, mixed-script corpus: mostly ASCII with Latin-1, Greek,
+// Cyrillic, CJK and the occasional character from beyond the BMP
+
+string makeMixedCaseCorpus(size_t length)
+{
+    const char sample[] =
+        "The Quick Brown Fox Jumps Over THE LAZY DOG. "
+        "D\xc3\x89J\xc3\x80 Vu, Na\xc3\x8fve Caf\xc3\xa9. "
+        "\xce\x91\xce\xb8\xce\xae\xce\xbd\xce\xb1 \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0. "
+        "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x80\x82 "
+        "\xf0\x90\x90\x80\xf0\x9f\x98\x80 ";
+    // whole copies of the sample, so no character is cut in half
+    string r;
+    r.reserve(length + sizeof(sample));
+    while (r.size() < length)
+    {
+        r += sample;
+    }
+    return r;
+}
+
+//=========================================================================
+// English prose, capitals and all, with nothing outside ASCII
+
+string makeAsciiCorpus(size_t length)
+{
+    const char sample[] =
+        "It Was The Best Of Times, It Was The WORST Of Times; it was the age "
+        "of wisdom, it was the age of foolishness (Dickens, 1859).\n";
+    string r;
+    r.reserve(length + sizeof(sample));
+    while (r.size() < length)
+    {
+        r += sample;
+    }
+    return r;
+}
+
+void sizes(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1 << 10)->Arg(64 << 10)->Arg(16 << 20);
+}
+
+// each size at scalar and every vector level up to the detected one
+void sizesAndLevels(benchmark::internal::Benchmark* b)
+{
+    auto top = detectedSimdLevel();
+    for (auto size : { 1 << 10, 64 << 10, 16 << 20 })
+    {
+        b->Args({ size, kSimdScalar });
+        for (int level = top == kSimdNeon ? kSimdNeon : kSimdSse42; level <= top; ++level)
+        {
+            b->Args({ size, level });
+        }
+    }
+}
+
+void BM_ToLowerUtf8(benchmark::State& state)
+{
+    auto src = makeMixedCaseCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toLower(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_ToLowerUtf8)->Apply(sizes);
+
+void BM_ToLowerUtf8ViaUcs4(benchmark::State& state)
+{
+    auto src = makeMixedCaseCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUtf8(toLower(toUcs4(src))));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_ToLowerUtf8ViaUcs4)->Apply(sizes);
+
+void BM_ToLowerUtf16(benchmark::State& state)
+{
+    auto src = toUtf16(makeMixedCaseCorpus(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toLower(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size() * 2));
+}
+BENCHMARK(BM_ToLowerUtf16)->Apply(sizes);
+
+void BM_ToLowerUtf16ViaUcs4(benchmark::State& state)
+{
+    auto src = toUtf16(makeMixedCaseCorpus(static_cast<size_t>(state.range(0))));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toUtf16(toLower(toUcs4(src))));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size() * 2));
+}
+BENCHMARK(BM_ToLowerUtf16ViaUcs4)->Apply(sizes);
+
+void BM_ToLowerTurkicUtf8(benchmark::State& state)
+{
+    auto src = makeMixedCaseCorpus(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toLower(src, "tr"));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(src.size()));
+}
+BENCHMARK(BM_ToLowerTurkicUtf8)->Apply(sizes);
+
+//=========================================================================
+// ASCII text through each overload, at the level in the second argument
+
+template<typename S>
+void lowerAsciiAtLevel(benchmark::State& state, const S& src)
+{
+    setSimdLevel(static_cast<SimdLevel>(state.range(1)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(toLower(src));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(src.size() * sizeof(src[0])));
+    setSimdLevel(detectedSimdLevel());
+}
+
+void BM_ToLowerAsciiUtf8(benchmark::State& state)
+{
+    lowerAsciiAtLevel(state, makeAsciiCorpus(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_ToLowerAsciiUtf8)->Apply(sizesAndLevels);
+
+void BM_ToLowerAsciiUtf16(benchmark::State& state)
+{
+    lowerAsciiAtLevel(state, toUtf16(makeAsciiCorpus(static_cast<size_t>(state.range(0)))));
+}
+BENCHMARK(BM_ToLowerAsciiUtf16)->Apply(sizesAndLevels);
+
+void BM_ToLowerAsciiUcs4(benchmark::State& state)
+{
+    lowerAsciiAtLevel(state, toUcs4(makeAsciiCorpus(static_cast<size_t>(state.range(0)))));
+}
+BENCHMARK(BM_ToLowerAsciiUcs4)->Apply(sizesAndLevels);
+
+}
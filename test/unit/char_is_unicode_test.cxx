@@ -348,3 +348,26 @@ TEST(IsUnicodeTest, testIsUnicode)
     cout << " ... done!" << endl;
 }
 
+
+TEST(IsUnicodeTest, testPropertyMaskWidths)
+{
+    // every width of character reads the same table entry for the same value
+    for (char32_t i = 0; i < 0x100; ++i)
+    {
+        EXPECT_EQ(charToEncodingTypeMask(i), charToEncodingTypeMask(static_cast<char>(i)));
+    }
+    for (char32_t i = 0; i < 0x10000; ++i)
+    {
+        EXPECT_EQ(charToEncodingTypeMask(i), charToEncodingTypeMask(static_cast<char16_t>(i)));
+    }
+
+    // and nothing past the end of Unicode has any property
+    for (char32_t i : { 0x110000u, 0x1FFFFFu, 0x7FFFFFFFu, 0xFFFFFFFFu })
+    {
+        EXPECT_EQ(0u, charToEncodingTypeMask(i));
+        EXPECT_FALSE(isUnicodeAssigned(i));
+        EXPECT_FALSE(isUnicodePrivate(i));
+        EXPECT_FALSE(isControlChar(i));
+        EXPECT_FALSE(isWhitespaceChar(i));
+    }
+}
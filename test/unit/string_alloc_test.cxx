@@ -0,0 +1,337 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_alloc_test.cxx -- tests for the allocator-templated converters,
+//                          toLower, split and join, and for the append
+//                          forms: the same results as ever, allocated only
+//                          through the allocator given.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "string_splitjoin.hxx"
+
+#include <cstdlib>
+#include <new>
+
+using namespace ansak;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+//=========================================================================
+// An allocator that counts what it hands out, so that a test can tell the
+// results came from it
+
+template<typename T>
+class CountingAllocator
+{
+public:
+    typedef T value_type;
+
+    CountingAllocator() : m_count(&uncounted()) {}
+    explicit CountingAllocator(size_t* count) : m_count(count) {}
+    CountingAllocator(const CountingAllocator& other) : m_count(other.m_count) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : m_count(other.count()) {}
+    CountingAllocator& operator=(const CountingAllocator& other) { m_count = other.m_count; return *this; }
+
+    T* allocate(size_t n)
+    {
+        ++*m_count;
+        auto p = malloc(n * sizeof(T));
+        if (p == nullptr)
+        {
+            throw bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { free(p); }
+
+    size_t* count() const { return m_count; }
+
+private:
+    static size_t& uncounted() { static size_t n = 0; return n; }
+
+
+    size_t*         m_count;
+};
+
+template<typename T, typename U>
+bool operator==(const CountingAllocator<T>& a, const CountingAllocator<U>& b)
+{ return a.count() == b.count(); }
+template<typename T, typename U>
+bool operator!=(const CountingAllocator<T>& a, const CountingAllocator<U>& b)
+{ return !(a == b); }
+
+template<typename C>
+using CountingString = basic_string<C, char_traits<C>, CountingAllocator<C>>;
+
+template<typename C, typename A>
+bool sameUnits(const basic_string<C, char_traits<C>, A>& a, const basic_string<C>& b)
+{
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin());
+}
+
+const char* const utf8Sources[] = {
+    "", "Key", "I\xc4\xb0 \xc3\x84\xd0\x96\xe4\xab\x88 \xf0\x9f\x98\x80 LONGER THAN ANY SMALL-STRING BUFFER",
+    "\xed\xa8\xb2\xed\xb8\xb2", "bad \x80 byte", "cut short \xf0\x9f\x98"
+};
+
+const ConvertPolicy allPolicies[] = { kConvertStrict, kConvertReplace, kConvertSkip };
+
+}
+
+TEST(AllocTest, testConvertersAgree)
+{
+    size_t count = 0;
+    CountingAllocator<char> a8(&count);
+    CountingAllocator<char16_t> a16(&count);
+    CountingAllocator<char32_t> a32(&count);
+
+    for (auto s : utf8Sources)
+    {
+        auto n = strlen(s);
+        for (auto policy : allPolicies)
+        {
+            EXPECT_TRUE(sameUnits(toUtf16(s, n, a16, policy), toUtf16(s, n, policy)));
+            EXPECT_TRUE(sameUnits(toUcs2(s, n, a16, policy), toUcs2(s, n, policy)));
+            EXPECT_TRUE(sameUnits(toUcs4(s, n, a32, policy), toUcs4(s, n, policy)));
+
+            auto u16 = toUtf16(s, n, kConvertReplace);
+            auto u32 = toUcs4(s, n, kConvertReplace);
+            u16.push_back(0xd800);      // a lone first half at the end
+            u32.push_back(0x110000);    // beyond Unicode
+            EXPECT_TRUE(sameUnits(toUtf8(u16.data(), u16.size(), a8, policy), toUtf8(u16.data(), u16.size(), policy)));
+            EXPECT_TRUE(sameUnits(toUtf8(u32.data(), u32.size(), a8, policy), toUtf8(u32.data(), u32.size(), policy)));
+            EXPECT_TRUE(sameUnits(toUcs4(u16.data(), u16.size(), a32, policy), toUcs4(u16.data(), u16.size(), policy)));
+            EXPECT_TRUE(sameUnits(toUtf16(u32.data(), u32.size(), a16, policy), toUtf16(u32.data(), u32.size(), policy)));
+            EXPECT_TRUE(sameUnits(toUcs2(u32.data(), u32.size(), a16, policy), toUcs2(u32.data(), u32.size(), policy)));
+        }
+    }
+
+    auto r = toUtf16(utf8Sources[2], strlen(utf8Sources[2]), a16);
+    EXPECT_EQ(&count, r.get_allocator().count());
+    EXPECT_NE(0u, count);
+
+    EXPECT_TRUE(toUtf16(static_cast<const char*>(nullptr), 5, a16).empty());
+    EXPECT_TRUE(toUtf8(static_cast<const char16_t*>(nullptr), 5, a8).empty());
+}
+
+TEST(AllocTest, testToLowerAgrees)
+{
+    size_t count = 0;
+    CountingAllocator<char> a8(&count);
+    CountingAllocator<char16_t> a16(&count);
+    CountingAllocator<char32_t> a32(&count);
+
+    for (auto s : utf8Sources)
+    {
+        auto n = strlen(s);
+        auto u16 = toUtf16(s, n, kConvertReplace);
+        auto u32 = toUcs4(s, n, kConvertReplace);
+        for (auto lang : { static_cast<const char*>(nullptr), "tr" })
+        {
+            EXPECT_TRUE(sameUnits(toLower(s, n, a8, lang), toLower(s, n, lang)));
+            EXPECT_TRUE(sameUnits(toLower(u16.data(), u16.size(), a16, lang), toLower(u16.data(), u16.size(), lang)));
+            EXPECT_TRUE(sameUnits(toLower(u32.data(), u32.size(), a32, lang), toLower(u32.data(), u32.size(), lang)));
+        }
+    }
+    EXPECT_NE(0u, count);
+}
+
+TEST(AllocTest, testSplitAndJoin)
+{
+    size_t count = 0;
+    CountingAllocator<char> a8(&count);
+    CountingString<char> line("one/two//three and a part longer than a small-string buffer/", a8);
+
+    auto parts = split(line, '/');
+    ASSERT_EQ(5u, parts.size());
+    EXPECT_EQ(&count, parts.get_allocator().count());
+    EXPECT_EQ(&count, parts[0].get_allocator().count());
+    EXPECT_TRUE(sameUnits(parts[3], string("three and a part longer than a small-string buffer")));
+    EXPECT_TRUE(parts[4].empty());
+
+    auto before = count;
+    auto joined = join(parts, '/');
+    EXPECT_EQ(line, joined);
+    EXPECT_EQ(before + 1, count);       // reserved once
+
+    size_t otherCount = 0;
+    auto elsewhere = join(parts, ':', CountingAllocator<char>(&otherCount));
+    EXPECT_TRUE(sameUnits(elsewhere, string("one:two::three and a part longer than a small-string buffer:")));
+    EXPECT_EQ(1u, otherCount);
+}
+
+TEST(AppendTest, testAppendAgreesWithTo)
+{
+    for (auto s : utf8Sources)
+    {
+        auto n = strlen(s);
+        auto u16 = toUtf16(s, n, kConvertReplace);
+        auto u32 = toUcs4(s, n, kConvertReplace);
+        u16.append(u"\xd800z");     // a lone first half
+        u32.push_back(0xd800);      // a surrogate
+        for (auto policy : allPolicies)
+        {
+            utf8String d8("head ");
+            auto ok = appendUtf8(d8, u16.data(), u16.size(), policy);
+            EXPECT_EQ("head " + toUtf8(u16.data(), u16.size(), policy), d8);
+            EXPECT_EQ(policy != kConvertStrict, ok);
+            d8 = "head ";
+            appendUtf8(d8, u32.data(), u32.size(), policy);
+            EXPECT_EQ("head " + toUtf8(u32.data(), u32.size(), policy), d8);
+
+            utf16String d16(u"head ");
+            ok = appendUtf16(d16, s, n, policy);
+            EXPECT_EQ(u"head " + toUtf16(s, n, policy), d16);
+            EXPECT_TRUE(ok || d16 == u"head ");
+            d16 = u"head ";
+            appendUcs2(d16, s, n, policy);
+            EXPECT_EQ(u"head " + toUcs2(s, n, policy), d16);
+            d16 = u"head ";
+            appendUtf16(d16, u32.data(), u32.size(), policy);
+            EXPECT_EQ(u"head " + toUtf16(u32.data(), u32.size(), policy), d16);
+            d16 = u"head ";
+            appendUcs2(d16, u32.data(), u32.size(), policy);
+            EXPECT_EQ(u"head " + toUcs2(u32.data(), u32.size(), policy), d16);
+
+            ucs4String d32(U"head ");
+            appendUcs4(d32, s, n, policy);
+            EXPECT_EQ(U"head " + toUcs4(s, n, policy), d32);
+            d32 = U"head ";
+            appendUcs4(d32, u16.data(), u16.size(), policy);
+            EXPECT_EQ(U"head " + toUcs4(u16.data(), u16.size(), policy), d32);
+        }
+
+        for (auto lang : { static_cast<const char*>(nullptr), "tr" })
+        {
+            utf8String d8("HEAD ");
+            auto ok = appendLower(d8, s, n, lang);
+            auto lower = toLower(s, n, lang);
+            EXPECT_EQ("HEAD " + lower, d8);
+            EXPECT_TRUE(ok || lower.empty());
+            utf16String d16(u"HEAD ");
+            appendLower(d16, u16.data(), u16.size() - 1, lang);
+            EXPECT_EQ(u"HEAD " + toLower(u16.data(), u16.size() - 1, lang), d16);
+            ucs4String d32(U"HEAD ");
+            appendLower(d32, u32.data(), u32.size(), lang);
+            EXPECT_EQ(U"HEAD " + toLower(u32.data(), u32.size(), lang), d32);
+        }
+    }
+}
+
+TEST(AppendTest, testAppendFormsOfSource)
+{
+    utf16String d16;
+    EXPECT_TRUE(appendUtf16(d16, "null-"));
+    EXPECT_TRUE(appendUtf16(d16, string("terminated")));
+    EXPECT_TRUE(appendUtf16(d16, U" and \U0001F600"));
+    EXPECT_TRUE(appendUtf16(d16, static_cast<const char*>(nullptr)));
+    EXPECT_TRUE(appendUtf16(d16, static_cast<const char*>(nullptr), 5));
+    EXPECT_FALSE(appendUtf16(d16, "\x80"));
+    EXPECT_EQ(u"null-terminated and \U0001F600", d16);
+
+    utf8String d8;
+    EXPECT_TRUE(appendLower(d8, "DOC: "));
+    EXPECT_TRUE(appendLower(d8, utf8String("TITLE")));
+    EXPECT_TRUE(appendUtf8(d8, u16string(u" Ä")));
+    EXPECT_EQ("doc: title \xc3\x84", d8);
+
+    ucs4String d32;
+    EXPECT_TRUE(appendUcs4(d32, u16string(u"x\U0001F600")));
+    EXPECT_TRUE(appendUcs4(d32, "y"));
+    EXPECT_EQ(U"x\U0001F600y", d32);
+}
+
+TEST(AppendTest, testAppendOnlyGrowsDst)
+{
+    size_t count = 0;
+    CountingString<char> doc{CountingAllocator<char>(&count)};
+    doc.reserve(8192);
+    auto reserved = count;
+
+    const char16_t* fragments[] = { u"<p>", u"Ärger über ", u"\U0001F600", u"</p>\n" };
+    for (int i = 0; i < 100; ++i)
+    {
+        for (auto f : fragments)
+        {
+            EXPECT_TRUE(appendUtf8(doc, f));
+            EXPECT_TRUE(appendLower(doc, "AND "));
+        }
+    }
+    EXPECT_EQ(reserved, count);
+    EXPECT_EQ(100u * (3 + 13 + 4 + 5 + 4 * 4), doc.size());
+}
+
+#if defined(ANSAK_EXPECT_PMR) && !defined(ANSAK_HAS_PMR)
+#error "<memory_resource> is there but string.hxx did not offer the std::pmr forms"
+#endif
+
+#if defined(ANSAK_HAS_PMR)
+
+TEST(AllocTest, testPmrArena)
+{
+    // everything below comes from buffer or not at all
+    char buffer[4096];
+    pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), pmr::null_memory_resource());
+
+    string_view s(utf8Sources[2]);
+    auto u16 = toUtf16(s, &arena);
+    auto u32 = toUcs4(s, &arena);
+    auto lower = toLower(s, &arena, "tr");
+    EXPECT_TRUE(sameUnits(u16, toUtf16(s)));
+    EXPECT_TRUE(sameUnits(u32, toUcs4(s)));
+    EXPECT_TRUE(sameUnits(lower, toLower(s, "tr")));
+    EXPECT_EQ(&arena, u16.get_allocator().resource());
+    EXPECT_EQ(&arena, lower.get_allocator().resource());
+    EXPECT_TRUE(sameUnits(toUtf8(u16string_view(u16), &arena), string(s)));
+    EXPECT_TRUE(sameUnits(toUtf8(u32string_view(u32), &arena), string(s)));
+    EXPECT_TRUE(toUcs2(s, &arena).empty());     // U+1F600 isn't UCS-2
+
+    pmr::string line("one two three", &arena);
+    auto parts = split(line, ' ');
+    ASSERT_EQ(3u, parts.size());
+    EXPECT_EQ(&arena, parts[2].get_allocator().resource());
+    EXPECT_EQ(line, join(parts, ' '));
+}
+
+#endif
@@ -0,0 +1,244 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_batch_test.cxx -- tests for to<RangeType>Batch and toLowerBatch:
+//                          every result in the arena is what converting
+//                          (or lower-casing) its source alone gives.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "string_test_text.hxx"
+
+#include <random>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::test;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+const ConvertPolicy allPolicies[] = { kConvertStrict, kConvertReplace, kConvertSkip };
+
+//=========================================================================
+// Many short strings, now and then one that is long or empty or (as a
+// pointer) null; ill-formed ones too, unless allGood
+
+vector<utf8String> makeSources(mt19937& gen, size_t count, bool allGood)
+{
+    uniform_int_distribution<int> veryRarely(0, 500);
+    uniform_int_distribution<size_t> shortLength(0, 12);
+
+    // all good draws from the well-formed pieces and the CESU-8 pair alone
+    auto fromCount = allGood ? kCesuPieces : pieceCount;
+    vector<utf8String> r;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto length = veryRarely(gen) == 0 ? 20000 : shortLength(gen);
+        r.push_back(makeTestString(gen, length, pieces, fromCount, kCesuPieces, 100));
+    }
+    return r;
+}
+
+template<typename C>
+vector<StringSpan<C>> spansOf(const vector<basic_string<C>>& srcs)
+{
+    vector<StringSpan<C>> r;
+    for (auto& s : srcs)
+    {
+        StringSpan<C> span = { s.empty() && r.size() % 2 ? nullptr : s.data(), s.size() };
+        r.push_back(span);
+    }
+    return r;
+}
+
+//=========================================================================
+// Check each result in the arena against the single-source function
+
+template<typename S, typename D, typename F>
+void expectEachResult
+(
+    const vector<basic_string<S>>&  srcs,
+    const basic_string<D>&          arena,
+    const vector<size_t>&           offsets,
+    size_t                          emptied,
+    F                               one
+)
+{
+    ASSERT_EQ(srcs.size() + 1, offsets.size());
+    EXPECT_EQ(0u, offsets[0]);
+    EXPECT_EQ(arena.size(), offsets.back());
+    size_t expectedEmptied = 0;
+    for (size_t i = 0; i < srcs.size(); ++i)
+    {
+        auto expected = one(srcs[i]);
+        expectedEmptied += !srcs[i].empty() && expected.empty() ? 1 : 0;
+        EXPECT_EQ(expected, arena.substr(offsets[i], offsets[i + 1] - offsets[i])) << "source " << i;
+    }
+    EXPECT_EQ(expectedEmptied, emptied);
+}
+
+}
+
+TEST(BatchTest, testNoSources)
+{
+    utf16String arena(u"left over");
+    vector<size_t> offsets(3, 7);
+    EXPECT_EQ(0u, toUtf16Batch(static_cast<const StringSpan<char>*>(nullptr), 0, arena, offsets));
+    EXPECT_TRUE(arena.empty());
+    EXPECT_EQ(vector<size_t>(1, 0), offsets);
+
+    utf8String lower;
+    EXPECT_EQ(0u, toLowerBatch(static_cast<const StringSpan<char>*>(nullptr), 0, lower, offsets));
+    EXPECT_TRUE(lower.empty());
+    EXPECT_EQ(vector<size_t>(1, 0), offsets);
+}
+
+TEST(BatchTest, testSourcesJoiningUp)
+{
+    // each half of a character is no good alone, however well they join
+    const StringSpan<char> halves[] = { { "ab\xc3", 3 }, { "\x84" "cd", 3 }, { "e\xed\xa8\xb2", 4 },
+                                        { "\xed\xb8\xb2", 3 } };
+    utf16String arena;
+    vector<size_t> offsets;
+    EXPECT_EQ(2u, toUtf16Batch(halves, 4, arena, offsets));
+    EXPECT_EQ(u"abe", arena);
+    EXPECT_EQ(vector<size_t>({ 0, 2, 2, 3, 3 }), offsets);
+
+    const StringSpan<char16_t> wideHalves[] = { { u"AB\xd83d", 3 }, { u"\xde00" u"CD", 3 } };
+    utf8String narrow;
+    EXPECT_EQ(1u, toUtf8Batch(wideHalves, 2, narrow, offsets));
+    EXPECT_EQ("AB", narrow);
+    utf16String lower;
+    EXPECT_EQ(1u, toLowerBatch(wideHalves, 2, lower, offsets));
+    EXPECT_EQ(u"ab", lower);
+    EXPECT_EQ(vector<size_t>({ 0, 2, 2 }), offsets);
+}
+
+TEST(BatchTest, testConvertersAgreeWithOneAtATime)
+{
+    mt19937 gen(20261017);
+    for (int round = 0; round < 4; ++round)
+    {
+        auto srcs = makeSources(gen, 2000, round % 2 == 0);
+        vector<utf16String> srcs16;
+        vector<ucs4String> srcs32;
+        for (auto& s : srcs)
+        {
+            srcs16.push_back(toUtf16(s, kConvertReplace));
+            srcs32.push_back(toUcs4(s, kConvertReplace));
+            if (round % 2 == 1 && srcs16.size() % 97 == 0 && !srcs16.back().empty())
+            {
+                // a lone half, now and then
+                srcs16.back()[0] = 0xdc00;
+                srcs32.back()[0] = 0xdc00;
+            }
+        }
+        auto spans = spansOf(srcs);
+        auto spans16 = spansOf(srcs16);
+        auto spans32 = spansOf(srcs32);
+
+        for (auto policy : allPolicies)
+        {
+            utf8String arena8;
+            utf16String arena16;
+            ucs4String arena32;
+            vector<size_t> offsets;
+
+            auto emptied = toUtf16Batch(spans.data(), spans.size(), arena16, offsets, policy);
+            expectEachResult(srcs, arena16, offsets, emptied,
+                             [=](const utf8String& s) { return toUtf16(s.data(), s.size(), policy); });
+            emptied = toUcs4Batch(spans.data(), spans.size(), arena32, offsets, policy);
+            expectEachResult(srcs, arena32, offsets, emptied,
+                             [=](const utf8String& s) { return toUcs4(s.data(), s.size(), policy); });
+            emptied = toUtf8Batch(spans16.data(), spans16.size(), arena8, offsets, policy);
+            expectEachResult(srcs16, arena8, offsets, emptied,
+                             [=](const utf16String& s) { return toUtf8(s.data(), s.size(), policy); });
+            emptied = toUcs4Batch(spans16.data(), spans16.size(), arena32, offsets, policy);
+            expectEachResult(srcs16, arena32, offsets, emptied,
+                             [=](const utf16String& s) { return toUcs4(s.data(), s.size(), policy); });
+            emptied = toUtf8Batch(spans32.data(), spans32.size(), arena8, offsets, policy);
+            expectEachResult(srcs32, arena8, offsets, emptied,
+                             [=](const ucs4String& s) { return toUtf8(s.data(), s.size(), policy); });
+            emptied = toUtf16Batch(spans32.data(), spans32.size(), arena16, offsets, policy);
+            expectEachResult(srcs32, arena16, offsets, emptied,
+                             [=](const ucs4String& s) { return toUtf16(s.data(), s.size(), policy); });
+        }
+    }
+}
+
+TEST(BatchTest, testToLowerAgreesWithOneAtATime)
+{
+    mt19937 gen(20261018);
+    const char* const langs[] = { nullptr, "tr" };
+    for (int round = 0; round < 4; ++round)
+    {
+        auto srcs = makeSources(gen, 2000, round % 2 == 0);
+        vector<utf16String> srcs16;
+        vector<ucs4String> srcs32;
+        for (auto& s : srcs)
+        {
+            srcs16.push_back(toUtf16(s, kConvertReplace));
+            srcs32.push_back(toUcs4(s, kConvertReplace));
+        }
+        auto spans = spansOf(srcs);
+        auto spans16 = spansOf(srcs16);
+        auto spans32 = spansOf(srcs32);
+
+        for (auto lang : langs)
+        {
+            utf8String arena8;
+            utf16String arena16;
+            ucs4String arena32;
+            vector<size_t> offsets;
+
+            auto emptied = toLowerBatch(spans.data(), spans.size(), arena8, offsets, lang);
+            expectEachResult(srcs, arena8, offsets, emptied,
+                             [=](const utf8String& s) { return toLower(s.data(), s.size(), lang); });
+            emptied = toLowerBatch(spans16.data(), spans16.size(), arena16, offsets, lang);
+            expectEachResult(srcs16, arena16, offsets, emptied,
+                             [=](const utf16String& s) { return toLower(s.data(), s.size(), lang); });
+            emptied = toLowerBatch(spans32.data(), spans32.size(), arena32, offsets, lang);
+            expectEachResult(srcs32, arena32, offsets, emptied,
+                             [=](const ucs4String& s) { return toLower(s.data(), s.size(), lang); });
+        }
+    }
+}
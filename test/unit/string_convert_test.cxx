@@ -0,0 +1,556 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_convert_test.cxx -- tests for conversion into caller buffers and
+//                            requiredLength
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+
+#include <vector>
+
+using namespace ansak;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+const char utf8Text[] = "I \xc3\xa4 \xe4\xab\x88 \xf0\x9f\x98\x80 \xed\xa8\xb2\xed\xb8\xb2 and some ASCII to end.";
+
+//=========================================================================
+// Converts src into buffers of every size up to the one needed, checking
+// that each partial result is a whole-character prefix of the full one and
+// that nothing is written past what is reported.
+
+template<typename S, typename D>
+void checkEveryCapacity
+(
+    const basic_string<S>&  src,
+    const basic_string<D>&  expected,
+    ConvertResult           (*convert)(const S*, size_t, D*, size_t)
+)
+{
+    const D sentinel = static_cast<D>(0x5a);
+    size_t lastConsumed = 0;
+    for (size_t capacity = 0; capacity <= expected.size(); ++capacity)
+    {
+        vector<D> dst(capacity + 4, sentinel);
+        auto r = convert(src.data(), src.size(), dst.data(), capacity);
+        EXPECT_LE(r.produced, capacity);
+        EXPECT_GE(r.consumed, lastConsumed);
+        lastConsumed = r.consumed;
+        EXPECT_EQ(capacity == expected.size() ? kConvertOk : kConvertTargetFull, r.status)
+                << "capacity " << capacity;
+        EXPECT_EQ(expected.substr(0, r.produced), basic_string<D>(dst.data(), r.produced));
+        for (auto i = r.produced; i < dst.size(); ++i)
+        {
+            EXPECT_EQ(sentinel, dst[i]) << "capacity " << capacity << ", at " << i;
+        }
+        // what was consumed converts to exactly what was produced
+        vector<D> again(r.produced + 1);
+        auto r2 = convert(src.data(), r.consumed, again.data(), again.size());
+        EXPECT_EQ(kConvertOk, r2.status);
+        EXPECT_EQ(r.produced, r2.produced);
+    }
+}
+
+//=========================================================================
+// Streams src through a StreamConverter in chunks of chunkLength units,
+// into a buffer of capacity units emptied each time it fills.
+//
+// Returns everything produced; status gets the first failure, or finish's
+// verdict if there was none.
+
+template<typename S, typename D>
+basic_string<D> streamThrough
+(
+    const basic_string<S>&  src,
+    RangeType               target,
+    size_t                  chunkLength,
+    size_t                  capacity,
+    ConvertStatus&          status
+)
+{
+    StreamConverter<S, D> converter(target);
+    vector<D> dst(capacity);
+    basic_string<D> result;
+    for (size_t i = 0; i < src.size(); i += chunkLength)
+    {
+        auto p = src.data() + i;
+        auto n = min(chunkLength, src.size() - i);
+        for (;;)
+        {
+            auto r = converter.convert(p, n, dst.data(), dst.size());
+            result.append(dst.data(), r.produced);
+            p += r.consumed;
+            n -= r.consumed;
+            if (r.status == kConvertTargetFull)
+            {
+                continue;
+            }
+            if (r.status != kConvertOk)
+            {
+                status = r.status;
+                return result;
+            }
+            EXPECT_EQ(0u, n);
+            break;
+        }
+    }
+    status = converter.finish();
+    return result;
+}
+
+template<typename S, typename D>
+void checkEveryChunking
+(
+    const basic_string<S>&  src,
+    const basic_string<D>&  expected,
+    RangeType               target
+)
+{
+    const size_t capacities[] = { 6, 7, 64 };
+    for (size_t chunkLength = 1; chunkLength <= src.size(); ++chunkLength)
+    {
+        for (auto capacity : capacities)
+        {
+            ConvertStatus status = kConvertInvalid;
+            EXPECT_EQ(expected, (streamThrough<S, D>(src, target, chunkLength, capacity, status)))
+                    << "chunks of " << chunkLength << ", capacity " << capacity;
+            EXPECT_EQ(kConvertOk, status);
+        }
+    }
+}
+
+}
+
+TEST(StringConvertTest, testFromUtf8)
+{
+    string src(utf8Text);
+    auto utf16 = toUtf16(src);
+    auto ucs4 = toUcs4(src);
+
+    EXPECT_EQ(utf16.size(), requiredLength(src.data(), src.size(), kUtf16));
+    EXPECT_EQ(ucs4.size(), requiredLength(src.data(), src.size(), kUcs4));
+    EXPECT_EQ(0u, requiredLength(src.data(), src.size(), kUcs2));
+    EXPECT_EQ(0u, requiredLength(src.data(), src.size(), kUtf8));
+
+    checkEveryCapacity<char, char16_t>(src, utf16, toUtf16);
+    checkEveryCapacity<char, char32_t>(src, ucs4, toUcs4);
+
+    // UCS-2 gets as far as the first non-BMP character
+    vector<char16_t> dst(100);
+    auto r = toUcs2(src.data(), src.size(), dst.data(), dst.size());
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+    EXPECT_EQ(9u, r.consumed);
+    EXPECT_EQ(6u, r.produced);
+    EXPECT_EQ(6u, requiredLength(src.data(), 9, kUcs2));
+}
+
+TEST(StringConvertTest, testFromUtf16)
+{
+    auto src = toUtf16(utf8Text);
+    auto utf8 = toUtf8(src);
+    auto ucs4 = toUcs4(src);
+
+    EXPECT_EQ(utf8.size(), requiredLength(src.data(), src.size(), kUtf8));
+    EXPECT_EQ(ucs4.size(), requiredLength(src.data(), src.size(), kUcs4));
+    EXPECT_EQ(0u, requiredLength(src.data(), src.size(), kUtf16));
+
+    checkEveryCapacity<char16_t, char>(src, utf8, toUtf8);
+    checkEveryCapacity<char16_t, char32_t>(src, ucs4, toUcs4);
+}
+
+TEST(StringConvertTest, testFromUcs4)
+{
+    auto src = toUcs4(utf8Text);
+    auto utf8 = toUtf8(src);
+    auto utf16 = toUtf16(src);
+    auto bmp = src.substr(0, 6);
+
+    EXPECT_EQ(utf8.size(), requiredLength(src.data(), src.size(), kUtf8));
+    EXPECT_EQ(utf16.size(), requiredLength(src.data(), src.size(), kUtf16));
+    EXPECT_EQ(0u, requiredLength(src.data(), src.size(), kUcs2));
+    EXPECT_EQ(6u, requiredLength(bmp.data(), bmp.size(), kUcs2));
+
+    checkEveryCapacity<char32_t, char>(src, utf8, toUtf8);
+    checkEveryCapacity<char32_t, char16_t>(src, utf16, toUtf16);
+    checkEveryCapacity<char32_t, char16_t>(bmp, toUcs2(bmp), toUcs2);
+}
+
+TEST(StringConvertTest, testInvalidAndOutOfRange)
+{
+    char16_t out16[20];
+    char32_t out32[20];
+    char out8[40];
+
+    const char badUtf8[] = "ab\xc3\xa4\xe4\x41z";
+    auto r = toUtf16(badUtf8, 7, out16, 20);
+    EXPECT_EQ(kConvertInvalid, r.status);
+    EXPECT_EQ(4u, r.consumed);
+    EXPECT_EQ(3u, r.produced);
+    EXPECT_EQ(0u, requiredLength(badUtf8, 7, kUtf16));
+
+    const char sixBytes[] = "a\xfd\xa1\xa2\xa3\xa4\xa5";
+    r = toUtf16(sixBytes, 7, out16, 20);
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+    EXPECT_EQ(1u, r.consumed);
+    r = toUcs4(sixBytes, 7, out32, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.produced);
+    EXPECT_EQ(0x618a3925u, static_cast<uint32_t>(out32[1]));
+
+    const char16_t loneHalves[] = u"ab\xdc00" u"cd\xd800x";
+    r = toUtf8(loneHalves, 6, out8, 40);
+    EXPECT_EQ(kConvertInvalid, r.status);
+    EXPECT_EQ(2u, r.consumed);
+    r = toUcs4(loneHalves + 3, 4, out32, 20);
+    EXPECT_EQ(kConvertInvalid, r.status);
+    EXPECT_EQ(2u, r.consumed);
+    EXPECT_EQ(2u, r.produced);
+
+    const char32_t wide[] = U"a\xd800" U"b\x110000" U"c\x80000000";
+    r = toUtf8(wide, 2, out8, 40);
+    EXPECT_EQ(kConvertInvalid, r.status);
+    EXPECT_EQ(1u, r.consumed);
+    r = toUtf16(wide + 2, 2, out16, 20);
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+    EXPECT_EQ(1u, r.consumed);
+    r = toUtf8(wide + 2, 4, out8, 40);
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+    EXPECT_EQ(3u, r.consumed);
+    EXPECT_EQ(0u, requiredLength(wide + 2, 4, kUtf8));
+    EXPECT_EQ(6u, requiredLength(wide + 2, 3, kUtf8));
+}
+
+TEST(StringConvertTest, testIncompleteAndNulls)
+{
+    char16_t out16[20];
+    char32_t out32[20];
+    char out8[40];
+
+    const char utf8[] = "a\0\xf0\x9f\x98\x80\xf0\x9f";
+    auto r = toUtf16(utf8, 8, out16, 20);
+    EXPECT_EQ(kConvertIncomplete, r.status);
+    EXPECT_EQ(6u, r.consumed);
+    EXPECT_EQ(4u, r.produced);
+    EXPECT_EQ(utf16String(u"a\0\U0001f600", 4), utf16String(out16, r.produced));
+    EXPECT_EQ(4u, requiredLength(utf8, 8, kUtf16));
+
+    const char16_t utf16[] = u"\0b\xd83d";
+    r = toUtf8(utf16, 3, out8, 40);
+    EXPECT_EQ(kConvertIncomplete, r.status);
+    EXPECT_EQ(2u, r.consumed);
+    EXPECT_EQ(string("\0b", 2), string(out8, r.produced));
+    r = toUcs4(utf16, 2, out32, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.produced);
+
+    // nothing at all
+    r = toUcs4(static_cast<const char*>(nullptr), 10, out32, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(0u, r.consumed + r.produced);
+    r = toUtf8(utf16, 0, nullptr, 0);
+    EXPECT_EQ(kConvertOk, r.status);
+}
+
+TEST(StringConvertTest, testRoomForTheLongestCharacter)
+{
+    // the documented least room converts the longest character; a unit less
+    // stops with nothing written
+    char out8[6];
+    char16_t out16[2];
+    char32_t out32[1];
+
+    auto r = toUtf8(U"\x7fffffff", 1, out8, 6);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(6u, r.produced);
+    r = toUtf8(U"\x7fffffff", 1, out8, 5);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(0u, r.consumed + r.produced);
+
+    r = toUtf8(u"\xd83d\xde00", 2, out8, 4);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(4u, r.produced);
+    r = toUtf8(u"\xd83d\xde00", 2, out8, 3);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(0u, r.consumed + r.produced);
+
+    r = toUtf16("\xf0\x9f\x98\x80", 4, out16, 2);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.produced);
+    r = toUtf16("\xf0\x9f\x98\x80", 4, out16, 1);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(0u, r.consumed + r.produced);
+
+    r = toUcs4("\xfd\xa1\xa2\xa3\xa4\xa5", 6, out32, 1);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(1u, r.produced);
+}
+
+TEST(StringConvertTest, testStringConvertersAgree)
+{
+    // the string-returning forms size once and convert through the buffer forms
+    const char utf8[] = "Caf\xc3\xa9 \xe6\x97\xa5\xf0\x9f\x98\x80\xed\xa8\xb2\xed\xb8\xb2 z";
+    const char16_t utf16[] = u"Café 日\U0001f600\U0009ca32 z";
+    const char32_t ucs4[] = U"Café 日\U0001f600\U0009ca32 z";
+
+    EXPECT_EQ(ucs4String(ucs4), toUcs4(utf8));
+    EXPECT_EQ(utf16String(utf16), toUtf16(utf8));
+    EXPECT_EQ(ucs4String(ucs4), toUcs4(utf16));
+    EXPECT_EQ(utf16String(utf16), toUtf16(ucs4));
+    EXPECT_EQ(toUtf8(ucs4), toUtf8(utf16));
+    EXPECT_EQ(ucs4String(ucs4), toUcs4(toUtf8(ucs4)));
+
+    // an incomplete character at the end is trimmed away
+    EXPECT_EQ(ucs4String(U"ab"), toUcs4("ab\xf0\x9f\x98"));
+    EXPECT_EQ(string("ab"), toUtf8(utf16String(u"ab\xd83d")));
+
+    // a lone second half is refused like a lone first half
+    EXPECT_TRUE(toUtf8(utf16String(u"ab\xdc00z")).empty());
+    EXPECT_TRUE(toUtf8(utf16String(u"ab\xd800z")).empty());
+    EXPECT_TRUE(toUcs2("\xf0\x9f\x98\x80").empty());
+}
+
+TEST(StringConvertTest, testStreamEveryChunking)
+{
+    string utf8(utf8Text);
+    auto utf16 = toUtf16(utf8);
+    auto ucs4 = toUcs4(utf8);
+    auto bmp = toUtf16(utf8.substr(0, 9));
+
+    checkEveryChunking<char, char16_t>(utf8, utf16, kUtf16);
+    checkEveryChunking<char, char16_t>(utf8.substr(0, 9), bmp, kUcs2);
+    checkEveryChunking<char, char32_t>(utf8, ucs4, kUcs4);
+    checkEveryChunking<char16_t, char>(utf16, toUtf8(utf16), kUtf8);
+    checkEveryChunking<char16_t, char32_t>(utf16, ucs4, kUcs4);
+    checkEveryChunking<char32_t, char>(ucs4, toUtf8(ucs4), kUtf8);
+    checkEveryChunking<char32_t, char16_t>(ucs4, utf16, kUtf16);
+}
+
+TEST(StringConvertTest, testStreamCarriesAndFails)
+{
+    char16_t out16[20];
+
+    // a character cut short is held back, then finished by the next chunk
+    StreamConverter<char, char16_t> toWide(kUtf16);
+    auto r = toWide.convert("a\xf0\x9f", 3, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(3u, r.consumed);
+    EXPECT_EQ(1u, r.produced);
+    EXPECT_EQ(kConvertIncomplete, toWide.finish());
+    r = toWide.convert("\x98", 1, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(0u, r.produced);
+    r = toWide.convert("\x80z", 2, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.consumed);
+    EXPECT_EQ(utf16String(u"\U0001f600z"), utf16String(out16, r.produced));
+    EXPECT_EQ(kConvertOk, toWide.finish());
+
+    // ... unless the next chunk doesn't finish it; nothing of it is consumed
+    r = toWide.convert("\xc3", 1, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    r = toWide.convert("ab", 2, out16, 20);
+    EXPECT_EQ(kConvertInvalid, r.status);
+    EXPECT_EQ(0u, r.consumed);
+    toWide.reset();
+    EXPECT_EQ(kConvertOk, toWide.finish());
+
+    // no room for the finished character: nothing consumed, try again
+    toWide.convert("\xf0\x9f\x98", 3, out16, 20);
+    r = toWide.convert("\x80", 1, out16, 1);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(0u, r.consumed);
+    r = toWide.convert("\x80", 1, out16, 2);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.produced);
+
+    // a split pair beyond UCS-2 is out of range once it is whole
+    StreamConverter<char, char16_t> toUcs2Stream(kUcs2);
+    r = toUcs2Stream.convert("\xed\xa8\xb2\xed", 4, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    r = toUcs2Stream.convert("\xb8\xb2", 2, out16, 20);
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+
+    // UTF-16 pairs split between chunks
+    StreamConverter<char16_t, char> toNarrow(kUtf8);
+    char out8[20];
+    r = toNarrow.convert(u"a\xd83d", 2, out8, 20);
+    EXPECT_EQ(2u, r.consumed);
+    EXPECT_EQ(1u, r.produced);
+    r = toNarrow.convert(u"\xde00", 1, out8, 20);
+    EXPECT_EQ(string("\xf0\x9f\x98\x80"), string(out8, r.produced));
+    r = toNarrow.convert(u"\xd83d", 1, out8, 20);
+    r = toNarrow.convert(u"b", 1, out8, 20);
+    EXPECT_EQ(kConvertInvalid, r.status);
+
+    // a target the output type can't hold
+    StreamConverter<char, char32_t> wrong(kUtf16);
+    char32_t out32[4];
+    r = wrong.convert("abc", 3, out32, 4);
+    EXPECT_EQ(kConvertOutOfRange, r.status);
+    EXPECT_EQ(0u, r.consumed);
+}
+
+TEST(StringConvertTest, testReplaceMaximalSubparts)
+{
+    // one U+FFFD for each maximal subpart of a bad sequence
+    EXPECT_EQ(utf16String(u"\xfffd\xfffd\xfffd"), toUtf16("\xe0\x80\x80", kConvertReplace));
+    EXPECT_EQ(utf16String(u"\xfffd" u"A"), toUtf16("\xe4\xab\x41", kConvertReplace));
+    EXPECT_EQ(utf16String(u"\xfffd\xfffd\xfffd\xfffd"), toUtf16("\xf4\x90\x80\x80", kConvertReplace));
+    EXPECT_EQ(utf16String(u"\xfffd\xfffd\xfffd" u"A"), toUtf16("\xed\xa0\x80\x41", kConvertReplace));
+    EXPECT_EQ(utf16String(u"\xfffd\xfffd"), toUtf16("\xc0\xaf", kConvertReplace));
+    EXPECT_EQ(utf16String(u"a\xfffd\xfffd\xfffd" u"b\xfffd" u"c\xfffd\xfffd" u"d"),
+              toUtf16("a\xf1\x80\x80\xe1\x80\xc2" "b\x80" "c\x80\xbf" "d", kConvertReplace));
+
+    // ... including an incomplete one at the end
+    EXPECT_EQ(utf16String(u"ab\xfffd"), toUtf16("ab\xf0\x9f\x98", kConvertReplace));
+    EXPECT_EQ(utf16String(u"ab\xfffd\xfffd"), toUtf16("ab\xf0\x8f", kConvertReplace));
+    EXPECT_EQ(ucs4String(U"\xfffd"), toUcs4("\xe2", kConvertReplace));
+
+    // skipping drops the same subparts
+    EXPECT_EQ(utf16String(u"abcd"),
+              toUtf16("a\xf1\x80\x80\xe1\x80\xc2" "b\x80" "c\x80\xbf" "d", kConvertSkip));
+    EXPECT_EQ(utf16String(u"ab"), toUtf16("ab\xf0\x9f\x98", kConvertSkip));
+    EXPECT_TRUE(toUcs4("\x80\x80", kConvertSkip).empty());
+
+    // characters the target can't hold are replaced whole
+    EXPECT_EQ(ucs2String(u"a\xfffd" u"b"), toUcs2("a\xf0\x9f\x98\x80" "b", kConvertReplace));
+    EXPECT_EQ(utf16String(u"\xfffd\xfffd\xfffd\xfffd\xfffd"),
+              toUtf16("\xf8\x88\x80\x80\x80", kConvertReplace));
+
+    // strict is still the default
+    EXPECT_TRUE(toUtf16("\xe4\xab\x41").empty());
+}
+
+TEST(StringConvertTest, testReplaceWideSources)
+{
+    EXPECT_EQ(string("ab\xef\xbf\xbdz"), toUtf8(utf16String(u"ab\xdc00z"), kConvertReplace));
+    EXPECT_EQ(string("ab\xef\xbf\xbd"), toUtf8(utf16String(u"ab\xd800"), kConvertReplace));
+    EXPECT_EQ(ucs4String(U"\xfffd\xfffd"), toUcs4(utf16String(u"\xd800\xd800"), kConvertReplace));
+    EXPECT_EQ(string("ab"), toUtf8(utf16String(u"a\xdc00" u"b\xd800"), kConvertSkip));
+
+    const char32_t wide[] = U"a\xd800" U"b\x110000" U"c";
+    // UTF-8 still holds what lies beyond U+10FFFF
+    EXPECT_EQ(string("a\xef\xbf\xbd" "b\xf4\x90\x80\x80" "c"), toUtf8(wide, kConvertReplace));
+    EXPECT_EQ(utf16String(u"a\xfffd" u"b\xfffd" u"c"), toUtf16(wide, kConvertReplace));
+    EXPECT_EQ(ucs2String(u"abc"), toUcs2(wide, kConvertSkip));
+}
+
+TEST(StringConvertTest, testPolicyInBuffersAndStreams)
+{
+    char16_t out16[20];
+    const char badUtf8[] = "ab\xc3\xa4\xe4\x41z";
+
+    auto r = toUtf16(badUtf8, 7, out16, 20, kConvertReplace);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(7u, r.consumed);
+    EXPECT_EQ(utf16String(u"ab\xe4\xfffd" u"Az"), utf16String(out16, r.produced));
+    EXPECT_EQ(6u, requiredLength(badUtf8, 7, kUtf16, kConvertReplace));
+    EXPECT_EQ(5u, requiredLength(badUtf8, 7, kUtf16, kConvertSkip));
+    r = toUtf16(badUtf8, 7, out16, 20, kConvertSkip);
+    EXPECT_EQ(utf16String(u"ab\xe4" u"Az"), utf16String(out16, r.produced));
+
+    // no room for the replacement
+    r = toUtf16(badUtf8, 7, out16, 3, kConvertReplace);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(4u, r.consumed);
+    EXPECT_EQ(3u, r.produced);
+
+    // an incomplete character at the end is left for the caller
+    r = toUtf16("ab\xf0\x9f", 4, out16, 20, kConvertReplace);
+    EXPECT_EQ(kConvertIncomplete, r.status);
+    EXPECT_EQ(2u, r.consumed);
+
+    // a stream carries it, then replaces it if the next chunk doesn't finish it
+    StreamConverter<char, char16_t> replacing(kUtf16, kConvertReplace);
+    r = replacing.convert("\xc3", 1, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    r = replacing.convert("ab", 2, out16, 20);
+    EXPECT_EQ(kConvertOk, r.status);
+    EXPECT_EQ(2u, r.consumed);
+    EXPECT_EQ(utf16String(u"\xfffd" u"ab"), utf16String(out16, r.produced));
+    EXPECT_EQ(kConvertOk, replacing.finish());
+}
+
+TEST(StringConvertTest, testPolicyInStreamsWithLittleRoom)
+{
+    // a carried sequence needing several U+FFFD still gets out a character
+    // at a time, with room for no more than one
+    const char src[] = "\xfc\x9d\x8e\xae\xa8\xb1\x37 x\xe4\xab\xf0\x9f\x98\x80";
+    const size_t srcLength = sizeof(src) - 1;
+    for (auto policy : { kConvertReplace, kConvertSkip })
+    {
+        auto whole = toUtf16(src, srcLength, policy);
+        for (size_t cut = 1; cut < srcLength; ++cut)
+        {
+            StreamConverter<char, char16_t> sc(kUtf16, policy);
+            utf16String out;
+            char16_t buf[2];
+            const size_t chunks[][2] = { { 0, cut }, { cut, srcLength } };
+            for (auto& chunk : chunks)
+            {
+                auto p = src + chunk[0];
+                auto n = chunk[1] - chunk[0];
+                for (int calls = 0; n != 0; ++calls)
+                {
+                    ASSERT_LT(calls, 50);
+                    auto r = sc.convert(p, n, buf, 2);
+                    out.append(buf, r.produced);
+                    p += r.consumed;
+                    n -= r.consumed;
+                    ASSERT_TRUE(r.status == kConvertOk || r.status == kConvertTargetFull);
+                    ASSERT_TRUE(r.consumed != 0 || r.produced != 0 || r.status == kConvertOk);
+                }
+            }
+            EXPECT_EQ(kConvertOk, sc.finish());
+            EXPECT_EQ(whole, out) << "cut at " << cut;
+        }
+    }
+
+    StreamConverter<char, char16_t> sc(kUtf16, kConvertReplace);
+    char16_t buf[2];
+    auto r = sc.convert("\xfc\x9d\x8e\xae\xa8", 5, buf, 2);
+    EXPECT_EQ(kConvertOk, r.status);
+    r = sc.convert("\xb1\x37", 2, buf, 2);
+    EXPECT_EQ(kConvertTargetFull, r.status);
+    EXPECT_EQ(2u, r.produced);
+}
@@ -44,10 +44,55 @@
 
 #include "internal/string_decode_utf8.hxx"
 
+#include <random>
+
 using namespace std;
 using namespace testing;
 using namespace ansak::internal;
 
+namespace {
+
+//=========================================================================
+// Do decodeUtf8 and decodeUtf8Dfa agree on the null-terminated s, and on
+// every length-delimited prefix of its first n bytes?
+
+AssertionResult decodersAgree(const char* s, size_t n)
+{
+    auto p = s;
+    auto q = s;
+    auto c = decodeUtf8(p);
+    auto d = decodeUtf8Dfa(q);
+    if (c != d || p != q)
+    {
+        return AssertionFailure() << "null-terminated: " << c << " vs " << d <<
+                ", offset " << (p ? p - s : -1) << " vs " << (q ? q - s : -1);
+    }
+    for (size_t length = 1; length <= n; ++length)
+    {
+        p = s;
+        q = s;
+        c = decodeUtf8(p, s + length);
+        d = decodeUtf8Dfa(q, s + length);
+        if (c != d || p != q)
+        {
+            return AssertionFailure() << "length " << length << ": " << c << " vs " << d <<
+                    ", offset " << (p ? p - s : -1) << " vs " << (q ? q - s : -1);
+        }
+    }
+    return AssertionSuccess();
+}
+
+// the bytes either side of every boundary the decoders care about
+const unsigned char edgeBytes[] = {
+    0x00, 0x41, 0x7f, 0x80, 0x83, 0x84, 0x87, 0x88, 0x8f, 0x90, 0x9f, 0xa0,
+    0xaf, 0xb0, 0xbf, 0xc0, 0xc1, 0xc2, 0xdf, 0xe0, 0xe1, 0xec, 0xed, 0xee,
+    0xef, 0xf0, 0xf1, 0xf4, 0xf5, 0xf7, 0xf8, 0xf9, 0xfb, 0xfc, 0xfd, 0xfe,
+    0xff
+};
+const size_t edgeByteCount = sizeof(edgeBytes);
+
+}
+
 TEST(DecodeUtf8Test, test7bit)
 {
     const char test7Bit[] = "No";
@@ -581,3 +626,60 @@ TEST(DecodeUtf8Test, testTooLargeStarter)
 }
 
 
+
+TEST(DecodeUtf8Test, testDfaAgreesOnEdgeBytes)
+{
+    // every 4-byte string of edge bytes, then a CESU-8 second half's worth
+    // more to let pairs and 5- and 6-byte forms finish (or not)
+    const unsigned char tails[][3] = {
+        { 0xed, 0xb0, 0x80 }, { 0xed, 0xbf, 0xbf }, { 0xed, 0xaf, 0xbf },
+        { 0xe1, 0x80, 0x80 }, { 0x80, 0x80, 0x80 }, { 0x80, 0x00, 0x80 }
+    };
+    char s[8] = { 0 };
+    for (size_t i = 0; i < edgeByteCount * edgeByteCount * edgeByteCount * edgeByteCount; ++i)
+    {
+        auto n = i;
+        for (int k = 0; k < 4; ++k, n /= edgeByteCount)
+        {
+            s[k] = static_cast<char>(edgeBytes[n % edgeByteCount]);
+        }
+        auto& tail = tails[i % (sizeof(tails) / sizeof(tails[0]))];
+        s[4] = static_cast<char>(tail[0]);
+        s[5] = static_cast<char>(tail[1]);
+        s[6] = static_cast<char>(tail[2]);
+        ASSERT_TRUE(decodersAgree(s, 7)) << "case " << i;
+    }
+}
+
+TEST(DecodeUtf8Test, testDfaAgreesOnRandomBytes)
+{
+    mt19937 gen(20261016);
+    uniform_int_distribution<int> anyByte(0, 255);
+    uniform_int_distribution<size_t> anyEdge(0, edgeByteCount - 1);
+    uniform_int_distribution<int> coin(0, 1);
+    uniform_int_distribution<size_t> anyLength(1, 12);
+
+    char s[13];
+    for (int i = 0; i < 200000; ++i)
+    {
+        auto n = anyLength(gen);
+        for (size_t k = 0; k < n; ++k)
+        {
+            s[k] = static_cast<char>(coin(gen) ? edgeBytes[anyEdge(gen)] : anyByte(gen));
+        }
+        s[n] = 0;
+        ASSERT_TRUE(decodersAgree(s, n)) << "case " << i;
+    }
+
+    // well-formed text of every length, decoded character by character
+    const char text[] = "a\xc3\xa4\xe6\x97\xa5\xf0\x9f\x98\x80\xed\xa8\xb2\xed\xb8\xb2"
+                        "\xf9\x84\x85\x86\x87\xfd\xa1\xa2\xa3\xa4\xa5z";
+    for (auto p = text; *p; ++p)
+    {
+        ASSERT_TRUE(decodersAgree(p, sizeof(text) - 1 - static_cast<size_t>(p - text)));
+        auto q = p;
+        EXPECT_NE(0u, decodeUtf8Dfa(q));
+        // continue from the character's last byte, as decodeUtf8 leaves it
+        p = q;
+    }
+}
@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_length_test.cxx -- tests for the length-delimited (pointer, size)
+//                           and string_view forms of the string.hxx API
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "internal/string_decode_utf8.hxx"
+
+#include <memory>
+#include <string.h>
+#include <type_traits>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+//=========================================================================
+// Copies a string into a heap block of exactly its length, no terminator,
+// so that a scan past the end has nothing friendly to land on
+
+template<typename C>
+unique_ptr<C[]> unterminated(const basic_string<C>& s)
+{
+    unique_ptr<C[]> r(new C[s.size() + 1]);
+    copy(s.begin(), s.end(), r.get());
+    r[s.size()] = static_cast<C>(0x41);  // 'A' -- never part of any test
+    return r;
+}
+
+}
+
+TEST(StringLengthTest, testDecodeUtf8WithEnd)
+{
+    const char text[] = "a\xc3\xa4\xe4\xab\x88\xf0\x9f\x98\x80";
+    auto end = text + sizeof(text) - 1;
+
+    auto p = &text[0];
+    EXPECT_EQ(U'a', decodeUtf8(p, end));
+    EXPECT_EQ(&text[0], p);
+    p = &text[1];
+    EXPECT_EQ(U'ä', decodeUtf8(p, end));
+    EXPECT_EQ(&text[2], p);
+    p = &text[6];
+    EXPECT_EQ(U'\U0001f600', decodeUtf8(p, end));
+    EXPECT_EQ(&text[9], p);
+
+    // cut short by end
+    p = &text[6];
+    EXPECT_EQ(0u, decodeUtf8(p, end - 1));
+    EXPECT_EQ(end - 1, p);
+    p = &text[3];
+    EXPECT_EQ(0u, decodeUtf8(p, &text[5]));
+    EXPECT_EQ(&text[5], p);
+
+    // cut short by a null is an error, a null on its own is a character
+    const char withNull[] = "\xe4\xab\0zzzzzzzz";
+    p = withNull;
+    EXPECT_EQ(0u, decodeUtf8(p, withNull + 3));
+    EXPECT_EQ(nullptr, p);
+    p = withNull;
+    EXPECT_EQ(0u, decodeUtf8(p, withNull + 8));
+    EXPECT_EQ(nullptr, p);
+    p = withNull + 2;
+    EXPECT_EQ(0u, decodeUtf8(p, withNull + 3));
+    EXPECT_EQ(withNull + 2, p);
+
+    // broken is broken, whatever the length
+    const char broken[] = "\xe4\x41\x41";
+    p = broken;
+    EXPECT_EQ(0u, decodeUtf8(p, broken + 1));
+    EXPECT_EQ(broken + 1, p);
+    p = broken;
+    EXPECT_EQ(0u, decodeUtf8(p, broken + 2));
+    EXPECT_EQ(nullptr, p);
+}
+
+TEST(StringLengthTest, testValidatorsMatchNullTerminated)
+{
+    const char* utf8s[] = { "", "abc", "\xc3\xa4\xe4\xab\x88", "\xf0\x9f\x98\x80xyz",
+                            "\xed\xa8\xb2\xed\xb8\xb2", "\xf9\x84\x85\x86\x87", "\xe4\xab",
+                            "\xc0\x80", "ab\x80", "\xed\xa0\x80z" };
+    for (auto s : utf8s)
+    {
+        string str(s);
+        auto buffer = unterminated(str);
+        for (int r = kAscii; r < kFirstInvalidRange; ++r)
+        {
+            auto range = static_cast<RangeType>(r);
+            EXPECT_EQ(isUtf8(s, range), isUtf8(buffer.get(), str.size(), range)) << str << ", " << r;
+        }
+    }
+
+    const char16_t* utf16s[] = { u"", u"abc", u"ä䫈", u"\xd83d\xde00xyz",
+                                 u"\xd83d", u"\xde00", u"a\xd83dz" };
+    for (auto s : utf16s)
+    {
+        utf16String str(s);
+        auto buffer = unterminated(str);
+        for (int r = kAscii; r < kFirstInvalidRange; ++r)
+        {
+            auto range = static_cast<RangeType>(r);
+            EXPECT_EQ(isUtf16(s, range), isUtf16(buffer.get(), str.size(), range));
+            EXPECT_EQ(isUcs2(s, range), isUcs2(buffer.get(), str.size(), range));
+        }
+    }
+
+    const char32_t* ucs4s[] = { U"", U"abc", U"ä\U0001f600", U"\xd800", U"\x7fffffff" };
+    for (auto s : ucs4s)
+    {
+        ucs4String str(s);
+        auto buffer = unterminated(str);
+        for (int r = kAscii; r < kFirstInvalidRange; ++r)
+        {
+            auto range = static_cast<RangeType>(r);
+            EXPECT_EQ(isUcs4(s, range), isUcs4(buffer.get(), str.size(), range));
+        }
+    }
+}
+
+TEST(StringLengthTest, testValidatorsWithNulls)
+{
+    const char utf8[] = "ab\0\xc3\xa4";
+    EXPECT_TRUE(isUtf8(utf8, 5, kUtf8));
+    EXPECT_TRUE(isUtf8(utf8, 3, kAscii));
+    EXPECT_FALSE(isUtf8(utf8, 5, kAscii));
+    EXPECT_FALSE(isUtf8(utf8, 5, kUtf8, validIfNot(kIsControl)));
+    EXPECT_FALSE(isUtf8("\xc3\0", 2, kUtf8));
+
+    const char16_t utf16[] = u"ab\0\xd83d\xde00";
+    EXPECT_TRUE(isUtf16(utf16, 5, kUtf16));
+    EXPECT_FALSE(isUtf16(utf16, 5, kUcs2));
+    EXPECT_FALSE(isUtf16(u"\xd83d\0", 2, kUtf16));
+    EXPECT_TRUE(isUcs2(utf16, 3, kUcs2));
+
+    const char32_t ucs4[] = U"a\0b";
+    EXPECT_TRUE(isUcs4(ucs4, 3, kAscii));
+    EXPECT_FALSE(isUcs4(ucs4, 3, kAscii, validIfNot(kIsControl)));
+
+    // nothing is valid enough to be nothing
+    EXPECT_TRUE(isUtf8(nullptr, 0, kUtf8));
+    EXPECT_TRUE(isUtf16(nullptr, 0, kUtf16));
+    EXPECT_FALSE(isUcs4(ucs4, 3, kFirstInvalidRange));
+}
+
+TEST(StringLengthTest, testValidatorsOnSlices)
+{
+    // a UTF-8 slice may end part-way through a character but not start there
+    string text("caf\xc3\xa9 \xe2\x82\xac 9 \xf0\x9f\x98\x80!");
+    for (size_t start = 0; start < text.size(); ++start)
+    {
+        bool startsWell = (static_cast<unsigned char>(text[start]) & 0xc0) != 0x80;
+        for (size_t length = 1; start + length <= text.size(); ++length)
+        {
+            EXPECT_EQ(startsWell, isUtf8(text.data() + start, length, kUtf8)) <<
+                    "start " << start << ", length " << length;
+        }
+    }
+
+    // and the slice is really where it stops
+    string big(1000, 'a');
+    big[600] = '\xff';
+    EXPECT_TRUE(isUtf8(big.data(), 600, kUtf8));
+    EXPECT_FALSE(isUtf8(big.data(), 601, kUtf8));
+    EXPECT_TRUE(isUtf8(big.data() + 601, 399, kAscii));
+}
+
+TEST(StringLengthTest, testConvertersMatchNullTerminated)
+{
+    string utf8("I am \xc3\xa4 \xe4\xab\x88 \xf0\x9f\x98\x80 \xed\xa8\xb2\xed\xb8\xb2.");
+    auto b8 = unterminated(utf8);
+    EXPECT_EQ(toUtf16(utf8), toUtf16(b8.get(), utf8.size()));
+    EXPECT_EQ(toUcs4(utf8), toUcs4(b8.get(), utf8.size()));
+    EXPECT_EQ(toUcs2(utf8), toUcs2(b8.get(), utf8.size()));
+    EXPECT_TRUE(toUcs2(b8.get(), utf8.size()).empty());
+    EXPECT_EQ(toUcs2(utf8.substr(0, 13)), toUcs2(b8.get(), 13));
+    EXPECT_FALSE(toUcs2(b8.get(), 13).empty());
+
+    auto utf16 = toUtf16(utf8);
+    auto b16 = unterminated(utf16);
+    EXPECT_EQ(toUtf8(utf16), toUtf8(b16.get(), utf16.size()));
+    EXPECT_EQ(toUcs4(utf8), toUcs4(b16.get(), utf16.size()));
+
+    auto ucs4 = toUcs4(utf8);
+    auto b32 = unterminated(ucs4);
+    EXPECT_EQ(toUtf8(ucs4), toUtf8(b32.get(), ucs4.size()));
+    EXPECT_EQ(utf16, toUtf16(b32.get(), ucs4.size()));
+    EXPECT_TRUE(toUcs2(b32.get(), ucs4.size()).empty());
+
+    // partial sequences at the end are dropped, as ever
+    EXPECT_EQ(u"I am ", toUtf16(utf8.data(), 6));
+    EXPECT_EQ(U"I am ä ", toUcs4(utf8.data(), 9));
+    EXPECT_EQ(string(" "), toUtf8(utf16.data() + 11, 2));
+}
+
+TEST(StringLengthTest, testConvertersWithNulls)
+{
+    const char utf8[] = "a\0\xc3\xa4\0";
+    EXPECT_EQ(utf16String(u"a\0ä\0", 4), toUtf16(utf8, 5));
+    EXPECT_EQ(ucs4String(U"a\0ä\0", 4), toUcs4(utf8, 5));
+    EXPECT_EQ(ucs2String(u"a\0ä\0", 4), toUcs2(utf8, 5));
+    EXPECT_TRUE(toUcs4("\xc3\0", 2).empty());
+
+    const char16_t utf16[] = u"\0\xd83d\xde00\0";
+    EXPECT_EQ(string("\0\xf0\x9f\x98\x80\0", 6), toUtf8(utf16, 4));
+    EXPECT_EQ(ucs4String(U"\0\U0001f600\0", 3), toUcs4(utf16, 4));
+    EXPECT_TRUE(toUtf8(u"\xd83d\0", 2).empty());
+
+    const char32_t ucs4[] = U"\0\U0001f600\0";
+    EXPECT_EQ(string("\0\xf0\x9f\x98\x80\0", 6), toUtf8(ucs4, 3));
+    EXPECT_EQ(utf16String(u"\0\xd83d\xde00\0", 4), toUtf16(ucs4, 3));
+    EXPECT_EQ(ucs2String(u"\0\0", 2), toUcs2(ucs4, 1) + toUcs2(ucs4 + 2, 1));
+}
+
+TEST(StringLengthTest, testUnicodeLength)
+{
+    string utf8("a\0\xc3\xa4\xe4\xab\x88\xf0\x9f\x98\x80", 11);
+    EXPECT_EQ(5u, unicodeLength(utf8.data(), utf8.size(), kUnicode));
+    EXPECT_EQ(0u, unicodeLength(utf8.data(), utf8.size() - 1, kUnicode));
+    EXPECT_EQ(0u, unicodeLength(utf8.data(), utf8.size(), kUcs2));
+    EXPECT_EQ(4u, unicodeLength(utf8.data(), 7, kUcs2));
+    EXPECT_EQ(2u, unicodeLength(utf8.data(), 2, kAscii));
+    EXPECT_EQ(0u, unicodeLength(utf8.data(), 3, kAscii));
+    EXPECT_EQ(0u, unicodeLength(utf8.data(), 4, kAscii));
+    EXPECT_EQ(0u, unicodeLength("a\xe4\x41", 3, kUnicode));
+    // cut short by the end of the length, as by anything else
+    EXPECT_EQ(0u, unicodeLength("P\xf1", 2, kUnicode));
+    EXPECT_EQ(0u, unicodeLength("P\xe4\xab", 3, kUcs4));
+
+    auto utf16 = toUtf16(utf8.data(), utf8.size());
+    EXPECT_EQ(6u, utf16.size());
+    EXPECT_EQ(5u, unicodeLength(utf16.data(), utf16.size(), kUnicode));
+    EXPECT_EQ(0u, unicodeLength(utf16.data(), utf16.size() - 1, kUnicode));
+    EXPECT_EQ(1u, unicodeLength(utf16.data(), 1, kUnicode));
+    EXPECT_EQ(0u, unicodeLength(utf16.data(), utf16.size(), kUcs2));
+    EXPECT_EQ(0u, unicodeLength(u"\xde00", 1, kUnicode));
+
+    auto ucs4 = toUcs4(utf8.data(), utf8.size());
+    EXPECT_EQ(5u, unicodeLength(ucs4.data(), ucs4.size(), kUnicode));
+    EXPECT_EQ(0u, unicodeLength(ucs4.data(), ucs4.size(), kUcs2));
+    EXPECT_EQ(1u, unicodeLength(U"\x7fffffff", 1, kUcs4));
+    EXPECT_EQ(0u, unicodeLength(U"\x7fffffff", 1, kUnicode));
+
+    // long enough to see the ASCII shortcut
+    string longer(300, 'z');
+    longer[150] = '\0';
+    longer += "\xc3\xa4";
+    EXPECT_EQ(301u, unicodeLength(longer.data(), longer.size(), kUnicode));
+    EXPECT_EQ(200u, unicodeLength(longer.data(), 200, kAscii));
+    EXPECT_EQ(0u, unicodeLength(longer.data(), longer.size() - 1, kUnicode));
+
+    // counts as long as the lengths they're given
+    static_assert(is_same<size_t, decltype(unicodeLength(utf8.data(), utf8.size(), kUnicode))>::value,
+                  "unicodeLength(const char*, size_t, RangeType) gives a size_t");
+    static_assert(is_same<size_t, decltype(unicodeLength(utf16.data(), utf16.size(), kUnicode))>::value,
+                  "unicodeLength(const char16_t*, size_t, RangeType) gives a size_t");
+    static_assert(is_same<size_t, decltype(unicodeLength(ucs4.data(), ucs4.size(), kUnicode))>::value,
+                  "unicodeLength(const char32_t*, size_t, RangeType) gives a size_t");
+    static_assert(is_same<size_t, decltype(unicodeLengthUnchecked(utf8.data(), utf8.size()))>::value,
+                  "unicodeLengthUnchecked gives a size_t");
+}
+
+TEST(StringLengthTest, testUnicodeLengthUnchecked)
+{
+    string utf8("a\0\xc3\xa4\xe4\xab\x88\xf0\x9f\x98\x80", 11);
+    EXPECT_EQ(5u, unicodeLengthUnchecked(utf8.data(), utf8.size()));
+    // a CESU-8 pair is one character
+    EXPECT_EQ(2u, unicodeLengthUnchecked("\xed\xa0\x80\xed\xb0\x80z", 7));
+
+    auto utf16 = toUtf16(utf8.data(), utf8.size());
+    EXPECT_EQ(5u, unicodeLengthUnchecked(utf16.data(), utf16.size()));
+    auto ucs4 = toUcs4(utf8.data(), utf8.size());
+    EXPECT_EQ(5u, unicodeLengthUnchecked(ucs4.data(), ucs4.size()));
+
+    // agreeing with the checked form wherever that succeeds
+    string longer;
+    for (int i = 0; i < 100; ++i)
+    {
+        longer += "z\xc3\xa4\xe4\xab\x88\xf0\x9f\x98\x80";
+        auto length = unicodeLength(longer.data(), longer.size(), kUnicode);
+        EXPECT_EQ(length, unicodeLengthUnchecked(longer.data(), longer.size()));
+        auto wide = toUtf16(longer);
+        EXPECT_EQ(length, unicodeLengthUnchecked(wide.data(), wide.size()));
+    }
+
+    EXPECT_EQ(0u, unicodeLengthUnchecked(static_cast<const char*>(nullptr), 3));
+    EXPECT_EQ(0u, unicodeLengthUnchecked(static_cast<const char16_t*>(nullptr), 3));
+    EXPECT_EQ(0u, unicodeLengthUnchecked(static_cast<const char32_t*>(nullptr), 3));
+}
+
+TEST(StringLengthTest, testToLower)
+{
+    const char utf8[] = "ABC\0\xc3\x84I";
+    EXPECT_EQ(string("abc\0\xc3\xa4i", 7), toLower(utf8, 7));
+    EXPECT_EQ(string("abc\0\xc3\xa4\xc4\xb1", 8), toLower(utf8, 7, "tr"));
+    EXPECT_EQ(string("abc"), toLower(utf8));
+
+    const char16_t utf16[] = u"AB\0\xd801\xdc00";
+    EXPECT_EQ(utf16String(u"ab\0\xd801\xdc28", 5), toLower(utf16, 5));
+    EXPECT_EQ(utf16String(u"ab"), toLower(utf16));
+
+    const char32_t ucs4[] = U"I\0\U00010400";
+    EXPECT_EQ(ucs4String(U"ı\0\U00010428", 3), toLower(ucs4, 3, "tr"));
+    EXPECT_EQ(ucs4String(U"i"), toLower(ucs4));
+
+    EXPECT_TRUE(toLower("\xc3\x84\xff", 3).empty());
+}
+
+TEST(StringLengthTest, testToLowerChangesLength)
+{
+    // lower-casing can shrink (U+0130 to i), grow (U+023A to U+2C65, or a
+    // Turkic I to dotless i) or keep the length, around long 7-bit runs
+    string upper(37, 'A');
+    string lower(37, 'a');
+    string src = upper + "\xc4\xb0" + upper + "\xc8\xba" + upper + "I" + upper;
+    EXPECT_EQ(lower + "i" + lower + "\xe2\xb1\xa5" + lower + "i" + lower, toLower(src));
+    EXPECT_EQ(lower + "i" + lower + "\xe2\xb1\xa5" + lower + "\xc4\xb1" + lower, toLower(src, "tr"));
+
+    // growing all the way through
+    string grows;
+    string grown;
+    for (int i = 0; i < 50; ++i)
+    {
+        grows += "\xc8\xbaI";
+        grown += "\xe2\xb1\xa5\xc4\xb1";
+    }
+    EXPECT_EQ(grown, toLower(grows, "az"));
+
+    auto upper16 = toUtf16(src);
+    EXPECT_EQ(toUtf16(toLower(src, "tr")), toLower(upper16, "tr"));
+    EXPECT_EQ(toUtf16(toLower(src)), toLower(upper16));
+
+    // a character cut short at the end is dropped, one cut short elsewhere
+    // spoils the whole string, as converting through UCS-4 would
+    EXPECT_EQ(lower, toLower(upper + "\xe2\xb1"));
+    EXPECT_TRUE(toLower(upper + "\xe2\xb1" + upper).empty());
+    EXPECT_EQ(utf16String(u"ab"), toLower(utf16String(u"AB\xd801")));
+    EXPECT_TRUE(toLower(utf16String(u"AB\xdc01")).empty());
+}
+
+#if defined(ANSAK_HAS_STRING_VIEW)
+
+TEST(StringLengthTest, testStringViews)
+{
+    using namespace std::literals;
+
+    EXPECT_TRUE(isUtf8("ab\0c"sv));
+    EXPECT_FALSE(isUtf8("ab\0c"sv, validIfNot(kIsControl)));
+    EXPECT_TRUE(isUtf16(u"ab\0c"sv, kUcs2));
+    EXPECT_TRUE(isUcs2(u"ab\0c"sv));
+    EXPECT_TRUE(isUcs4(U"ab\0c"sv, kAscii));
+
+    EXPECT_EQ(u"a\0b"s, toUtf16("a\0b"sv));
+    EXPECT_EQ(U"a\0b"s, toUcs4("a\0b"sv));
+    EXPECT_EQ("a\0b"s, toUtf8(u"a\0b"sv));
+    EXPECT_EQ("a\0b"s, toUtf8(U"a\0b"sv));
+    EXPECT_EQ(u"a\0b"s, toUcs2(U"a\0b"sv));
+
+    EXPECT_EQ(3u, unicodeLength("a\0b"sv));
+    EXPECT_EQ(3u, unicodeLength(u"a\0b"sv));
+    EXPECT_EQ(3u, unicodeLength(U"a\0b"sv));
+    EXPECT_EQ(3u, unicodeLengthUnchecked("a\0\xc3\xa4"sv));
+    EXPECT_EQ(3u, unicodeLengthUnchecked(u"a\0\xd83d\xde00"sv));
+    EXPECT_EQ(3u, unicodeLengthUnchecked(U"a\0b"sv));
+
+    EXPECT_EQ("a\0b"s, toLower("A\0B"sv));
+    EXPECT_EQ("abc"s, toLower("ABC"));
+}
+
+#endif
@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_parallel_test.cxx -- tests for isUtf8Parallel and isUtf16Parallel:
+//                             however many pieces and threads a source is
+//                             checked with, the answer is that of isUtf8 or
+//                             isUtf16 over the whole of it.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "string_internal.hxx"
+#include "string_test_text.hxx"
+
+#include <random>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace ansak::test;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+const unsigned int threadCounts[] = { 1, 3 };
+const size_t pieceLengths[] = { 1, 2, 3, 5, 7, 16, 61 };
+
+}
+
+TEST(ParallelTest, testEmptyAndNull)
+{
+    EXPECT_TRUE(isUtf8Parallel(nullptr, 0));
+    EXPECT_TRUE(isUtf8Parallel("abc", 0));
+    EXPECT_TRUE(isUtf16Parallel(nullptr, 0));
+    EXPECT_TRUE(isUtf8Parallel(utf8String("abc")));
+    EXPECT_TRUE(isUtf16Parallel(utf16String(u"abc")));
+
+    EXPECT_FALSE(isUtf8Parallel("abc", 3, kFirstInvalidRange));
+    EXPECT_FALSE(isUtf16Parallel(u"abc", 3, kFirstInvalidRange));
+    EXPECT_FALSE(isUtf8InPieces("abcdef", 6, kFirstInvalidRange, EncodingCheckPredicate(), 2, 1));
+}
+
+TEST(ParallelTest, testPairsAcrossCuts)
+{
+    // wherever a piece would end, a pair stays whole
+    const char cesu[] = "ab\xed\xa8\xb2\xed\xb8\xb2" "cd";
+    const char16_t pair[] = u"ab\xd83d\xde00" u"cd";
+    for (size_t length = 1; length < 10; ++length)
+    {
+        EXPECT_TRUE(isUtf8InPieces(cesu, sizeof(cesu) - 1, kUnicode, EncodingCheckPredicate(), 2, length));
+        EXPECT_FALSE(isUtf8InPieces(cesu, sizeof(cesu) - 1, kUcs2, EncodingCheckPredicate(), 2, length));
+        EXPECT_TRUE(isUtf16InPieces(pair, 6, kUtf16, EncodingCheckPredicate(), 2, length));
+        EXPECT_FALSE(isUtf16InPieces(pair, 6, kUcs2, EncodingCheckPredicate(), 2, length));
+    }
+
+    // ... and a first half without its second fails wherever it is cut
+    const char lone[] = "ab\xed\xa8\xb2\xed\xa8\xb2\xed\xb8\xb2" "cd";
+    const char16_t lone16[] = u"ab\xd83d\xd83d\xde00" u"cd";
+    for (size_t length = 1; length < 12; ++length)
+    {
+        EXPECT_FALSE(isUtf8InPieces(lone, sizeof(lone) - 1, kUnicode, EncodingCheckPredicate(), 2, length));
+        EXPECT_FALSE(isUtf16InPieces(lone16, 7, kUtf16, EncodingCheckPredicate(), 2, length));
+    }
+
+    // a sequence cut short is let go only at the end of the source
+    EXPECT_TRUE(isUtf8InPieces("abcd\xf0\x9f", 6, kUtf8, EncodingCheckPredicate(), 2, 2));
+    EXPECT_FALSE(isUtf8InPieces("ab\xf0\x9f" "cd", 6, kUtf8, EncodingCheckPredicate(), 2, 2));
+    EXPECT_TRUE(isUtf16InPieces(u"abcd\xd83d", 5, kUtf16, EncodingCheckPredicate(), 2, 2));
+    EXPECT_FALSE(isUtf16InPieces(u"ab\xd83d" u"cd", 5, kUtf16, EncodingCheckPredicate(), 2, 2));
+}
+
+TEST(ParallelTest, testAgreesWithSerial)
+{
+    const EncodingCheckPredicate preds[] = { EncodingCheckPredicate(), validIfNot(kIsPrivate) };
+    mt19937 gen(20261017);
+    uniform_int_distribution<int> anyLength(0, 300);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        // mostly well-formed, so that a failure is somewhere in the middle
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)), pieces, pieceCount,
+                                kUcs4Pieces, i % 2 ? 60 : 600, true);
+        auto w = makeTestString(gen, static_cast<size_t>(anyLength(gen)), pieces16, pieceCount16,
+                                kUnicodePieces16, i % 2 ? 60 : 600, true);
+        for (auto range : allRanges)
+        {
+            for (auto& pred : preds)
+            {
+                auto serial8 = isUtf8(s.data(), s.size(), range, pred);
+                auto serial16 = isUtf16(w.data(), w.size(), range, pred);
+                for (auto threads : threadCounts)
+                {
+                    for (auto length : pieceLengths)
+                    {
+                        EXPECT_EQ(serial8, isUtf8InPieces(s.data(), s.size(), range, pred, threads, length))
+                                << "input " << i << ", range " << range << ", threads " << threads
+                                << ", piece length " << length;
+                        EXPECT_EQ(serial16, isUtf16InPieces(w.data(), w.size(), range, pred, threads, length))
+                                << "input " << i << ", range " << range << ", threads " << threads
+                                << ", piece length " << length;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(ParallelTest, testLargeSources)
+{
+    // long enough to be cut into several pieces of the usual length
+    utf8String s;
+    utf16String w;
+    for (size_t i = 0; s.size() < 3 * kParallelPieceLength; ++i)
+    {
+        s += i % 7 ? "plain text " : "\xd0\x96\xe4\xab\x88\xf0\x9f\x98\x80 ";
+        w += i % 7 ? u"plain text " : u"\x0416\x4ac8\xd83d\xde00 ";
+    }
+    EXPECT_TRUE(isUtf8Parallel(s));
+    EXPECT_TRUE(isUtf8Parallel(s, kUtf8, EncodingCheckPredicate(), 4));
+    EXPECT_TRUE(isUtf16Parallel(w));
+    EXPECT_FALSE(isUtf16Parallel(w, kUcs2));
+
+    s[s.size() - 100] = '\xff';
+    w[w.size() - 100] = 0xdc00;
+    EXPECT_FALSE(isUtf8Parallel(s));
+    EXPECT_FALSE(isUtf16Parallel(w));
+    s[s.size() - 100] = 'x';
+    s[100] = '\x80';
+    EXPECT_FALSE(isUtf8Parallel(s, kUtf8, EncodingCheckPredicate(), 2));
+}
@@ -0,0 +1,852 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.16 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_simd_test.cxx -- unit tests for the vector kernels: every level the
+//                         CPU supports must agree with the scalar code on
+//                         every input.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "string_simd.hxx"
+#include "internal/string_decode_utf8.hxx"
+#include "string_test_text.hxx"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace ansak::test;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+//=========================================================================
+// Levels worth testing on this machine, scalar first
+
+vector<SimdLevel> availableLevels()
+{
+    vector<SimdLevel> levels;
+    levels.push_back(kSimdScalar);
+    auto top = detectedSimdLevel();
+    if (top == kSimdNeon)
+    {
+        levels.push_back(kSimdNeon);
+    }
+    else
+    {
+        for (int l = kSimdSse42; l <= top; ++l)
+        {
+            levels.push_back(static_cast<SimdLevel>(l));
+        }
+    }
+    return levels;
+}
+
+//=========================================================================
+// Restores the detected level when a test ends, however it ends
+
+class SimdLevelGuard
+{
+public:
+    SimdLevelGuard() {}
+    ~SimdLevelGuard() { setSimdLevel(detectedSimdLevel()); }
+};
+
+//=========================================================================
+// toUcs4 the long way, one decodeUtf8 at a time
+
+ucs4String slowToUcs4(const string& s)
+{
+    ucs4String r;
+    for (auto p = s.c_str(); *p; ++p)
+    {
+        auto c = decodeUtf8(p);
+        if (p == nullptr)
+        {
+            return ucs4String();
+        }
+        else if (c == 0)
+        {
+            break;
+        }
+        r.push_back(c);
+    }
+    return r;
+}
+
+}
+
+TEST(SimdTest, testLevelSelection)
+{
+    SimdLevelGuard guard;
+
+    EXPECT_EQ(detectedSimdLevel(), activeSimdLevel());
+    setSimdLevel(kSimdScalar);
+    EXPECT_EQ(kSimdScalar, activeSimdLevel());
+    // asking for more than the CPU has gives what it has
+    setSimdLevel(detectedSimdLevel() == kSimdNeon ? kSimdAvx512 : kSimdNeon);
+    EXPECT_EQ(detectedSimdLevel(), activeSimdLevel());
+}
+
+TEST(SimdTest, testBackUpToCharacterStart)
+{
+    const char text[] = "ab\xc3\xa4\xe4\xab\x88\xf0\x9f\x98\x80z";
+    EXPECT_EQ(0u, backUpToCharacterStart(text, 0));
+    EXPECT_EQ(2u, backUpToCharacterStart(text, 2));
+    EXPECT_EQ(2u, backUpToCharacterStart(text, 3));
+    EXPECT_EQ(2u, backUpToCharacterStart(text, 4));
+    EXPECT_EQ(4u, backUpToCharacterStart(text, 5));
+    EXPECT_EQ(4u, backUpToCharacterStart(text, 7));
+    EXPECT_EQ(7u, backUpToCharacterStart(text, 10));
+    EXPECT_EQ(7u, backUpToCharacterStart(text, 11));
+    EXPECT_EQ(7u, backUpToCharacterStart(text, 8));
+    EXPECT_EQ(12u, backUpToCharacterStart(text, 12));
+}
+
+TEST(SimdTest, testValidUtf8PrefixStopsOnErrors)
+{
+    SimdLevelGuard guard;
+
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t at = 0; at < 200; ++at)
+        {
+            string s(256, 'x');
+            s.replace(at, 3, "\xed\xa0\x80");
+            auto n = validUtf8Prefix(s.data(), s.size(), 0xff);
+            EXPECT_LE(n, at) << "level " << level << ", error at " << at;
+
+            s.replace(at, 3, "\xe4\xab\x88");
+            n = validUtf8Prefix(s.data(), s.size(), 0xff);
+            EXPECT_TRUE(level == kSimdScalar || n > at) << "level " << level << ", at " << at;
+            n = validUtf8Prefix(s.data(), s.size(), 0xef);
+            EXPECT_TRUE(level == kSimdScalar || n > at) << "level " << level << ", at " << at;
+            n = validUtf8Prefix(s.data(), s.size(), 0x7f);
+            EXPECT_LE(n, at) << "level " << level << ", at " << at;
+        }
+    }
+}
+
+TEST(SimdTest, testIsUtf8AgreesWithScalar)
+{
+    SimdLevelGuard guard;
+
+    mt19937 gen(20261016);
+    uniform_int_distribution<int> anyLength(0, 700);
+    auto levels = availableLevels();
+    size_t goodPieceCounts[] = { kAsciiPieces, kUnicodePieces, kUcs4Pieces };
+
+    for (int i = 0; i < 600; ++i)
+    {
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)),
+                                goodPieceCounts[i % 3]);
+        uniform_int_distribution<size_t> cut(1, s.empty() ? 1 : s.size());
+        unsigned int lengths[] = { static_cast<unsigned int>(s.size()),
+                                   static_cast<unsigned int>(cut(gen)) };
+
+        for (auto range : allRanges)
+        {
+            setSimdLevel(kSimdScalar);
+            bool expected = isUtf8(s.c_str(), range);
+            for (auto level : levels)
+            {
+                setSimdLevel(level);
+                EXPECT_EQ(expected, isUtf8(s.c_str(), range)) << "level " << level <<
+                        ", range " << range << ", input " << i;
+            }
+        }
+        for (auto length : lengths)
+        {
+            if (s.empty())
+            {
+                break;
+            }
+            setSimdLevel(kSimdScalar);
+            bool expected = isUtf8(s.c_str(), length);
+            for (auto level : levels)
+            {
+                setSimdLevel(level);
+                EXPECT_EQ(expected, isUtf8(s.c_str(), length)) << "level " << level <<
+                        ", length " << length << ", input " << i;
+            }
+        }
+    }
+}
+
+TEST(SimdTest, testIsUtf8LengthTerminatedWithNull)
+{
+    SimdLevelGuard guard;
+
+    string s(300, 'q');
+    s[150] = '\0';
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        EXPECT_FALSE(isUtf8(s.c_str(), static_cast<unsigned int>(s.size())));
+        EXPECT_TRUE(isUtf8(s.c_str(), 150u));
+        EXPECT_TRUE(isUtf8(s.c_str(), kAscii));
+    }
+}
+
+TEST(SimdTest, testAsciiPrefixAndWiden)
+{
+    SimdLevelGuard guard;
+
+    string s(300, 'a');
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        s[i] = static_cast<char>(0x20 + i % 0x5f);
+    }
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t at = 0; at < 200; ++at)
+        {
+            string t(s);
+            t[at] = '\xc3';
+            EXPECT_EQ(at, asciiPrefix(t.data(), t.size())) << "level " << level << ", at " << at;
+            EXPECT_EQ(at / 2, asciiPrefix(t.data(), at / 2)) << "level " << level << ", at " << at;
+
+            vector<char16_t> wide16(at + 1, u'!');
+            vector<char32_t> wide32(at + 1, U'!');
+            widenAscii(s.data(), at, wide16.data());
+            widenAscii(s.data(), at, wide32.data());
+            for (size_t i = 0; i < at; ++i)
+            {
+                ASSERT_EQ(static_cast<char16_t>(s[i]), wide16[i]) << "level " << level;
+                ASSERT_EQ(static_cast<char32_t>(s[i]), wide32[i]) << "level " << level;
+            }
+            // and not one character further
+            EXPECT_EQ(u'!', wide16[at]);
+            EXPECT_EQ(U'!', wide32[at]);
+        }
+    }
+}
+
+TEST(SimdTest, testConvertersAgreeWithScalar)
+{
+    SimdLevelGuard guard;
+
+    mt19937 gen(20261017);
+    uniform_int_distribution<int> anyLength(0, 700);
+    auto levels = availableLevels();
+    size_t goodPieceCounts[] = { kAsciiPieces, kTwoBytePieces, kUnicodePieces };
+
+    for (int i = 0; i < 300; ++i)
+    {
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)),
+                                goodPieceCounts[i % 3]);
+        uniform_int_distribution<size_t> cut(1, s.empty() ? 1 : s.size());
+        auto length = static_cast<unsigned int>(cut(gen));
+
+        setSimdLevel(kSimdScalar);
+        auto ucs4 = toUcs4(s);
+        auto utf16 = toUtf16(s);
+        auto ucs2 = toUcs2(s);
+        auto count = unicodeLength(s);
+        auto countTo = unicodeLength(s.c_str(), length);
+        EXPECT_EQ(slowToUcs4(s), ucs4) << "input " << i;
+
+        for (auto level : levels)
+        {
+            setSimdLevel(level);
+            EXPECT_EQ(ucs4, toUcs4(s)) << "level " << level << ", input " << i;
+            EXPECT_EQ(utf16, toUtf16(s)) << "level " << level << ", input " << i;
+            EXPECT_EQ(ucs2, toUcs2(s)) << "level " << level << ", input " << i;
+            EXPECT_EQ(count, unicodeLength(s)) << "level " << level << ", input " << i;
+            EXPECT_EQ(countTo, unicodeLength(s.c_str(), length)) << "level " << level <<
+                    ", length " << length << ", input " << i;
+        }
+    }
+}
+
+TEST(SimdTest, testUtf8ToUtf16Prefix)
+{
+    SimdLevelGuard guard;
+
+    // the pieces before kBmpPieces are whole BMP characters
+    mt19937 gen(20261017);
+    uniform_int_distribution<size_t> bmpPick(1, kBmpPieces - 1);
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t length = 0; length < 300; ++length)
+        {
+            string s;
+            while (s.size() < length)
+            {
+                s += pieces[bmpPick(gen)];
+            }
+            for (size_t bad = kBmpPieces; bad <= pieceCount; ++bad)
+            {
+                // the same text, then with something no kernel takes spliced in
+                string t(s);
+                uniform_int_distribution<size_t> at(0, s.size());
+                if (bad < pieceCount)
+                {
+                    t.insert(backUpToCharacterStart(s.data(), at(gen)), pieces[bad]);
+                }
+
+                vector<char16_t> out(t.size() + 8, u'!');
+                size_t produced = 0;
+                auto consumed = utf8ToUtf16Prefix(t.data(), t.size(), out.data(), produced);
+                ASSERT_LE(consumed, t.size());
+                // whole, well-formed characters, converted as the scalar code converts them
+                vector<char16_t> expected(consumed + 1);
+                auto r = toUtf16(t.data(), consumed, expected.data(), expected.size());
+                EXPECT_EQ(kConvertOk, r.status) << "level " << level << ", length " << length;
+                EXPECT_EQ(consumed, r.consumed) << "level " << level << ", length " << length;
+                EXPECT_EQ(utf16String(expected.data(), r.produced), utf16String(out.data(), produced))
+                        << "level " << level << ", length " << length << ", piece " << bad;
+                for (auto i = t.size(); i < out.size(); ++i)
+                {
+                    ASSERT_EQ(u'!', out[i]) << "level " << level << ", length " << length;
+                }
+                if (bad == pieceCount && level != kSimdScalar)
+                {
+                    // good text all the way: only the last step's worth is left over
+                    EXPECT_GE(consumed + 64, t.size()) << "level " << level << ", length " << length;
+                }
+
+                // and the same again, to UCS-4
+                vector<char32_t> out32(t.size() + 8, U'!');
+                consumed = utf8ToUcs4Prefix(t.data(), t.size(), out32.data(), produced);
+                ASSERT_LE(consumed, t.size());
+                vector<char32_t> expected32(consumed + 1);
+                r = toUcs4(t.data(), consumed, expected32.data(), expected32.size());
+                EXPECT_EQ(kConvertOk, r.status) << "level " << level << ", length " << length;
+                EXPECT_EQ(consumed, r.consumed) << "level " << level << ", length " << length;
+                EXPECT_EQ(ucs4String(expected32.data(), r.produced), ucs4String(out32.data(), produced))
+                        << "level " << level << ", length " << length << ", piece " << bad;
+                for (auto i = t.size(); i < out32.size(); ++i)
+                {
+                    ASSERT_EQ(U'!', out32[i]) << "level " << level << ", length " << length;
+                }
+                // which takes 4-byte characters in its stride too
+                if ((bad == pieceCount || bad < kUnicodePieces) && level != kSimdScalar)
+                {
+                    EXPECT_GE(consumed + 64, t.size()) << "level " << level << ", length " << length;
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdTest, testUtf16ToUtf8Prefix)
+{
+    SimdLevelGuard guard;
+
+    const char16_t* const halves[] = { u"\xd83d\xde00", u"\xd800", u"\xdfff", u"" };
+    mt19937 gen(20261017);
+    uniform_int_distribution<size_t> bmpPick(1, kBmpPieces - 1);
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t length = 0; length < 200; ++length)
+        {
+            string s;
+            while (s.size() < 2 * length)
+            {
+                s += pieces[bmpPick(gen)];
+            }
+            auto bmp = toUtf16(s);
+            for (auto half : halves)
+            {
+                utf16String t(bmp);
+                uniform_int_distribution<size_t> at(0, t.size());
+                t.insert(at(gen), half);
+
+                // room for all of it, for exactly all of it, and for less
+                uniform_int_distribution<size_t> someRoom(0, 3 * t.size());
+                size_t rooms[] = { 3 * t.size() + 16, requiredLength(t.data(), t.size(), kUtf8),
+                                   someRoom(gen) };
+                for (auto room : rooms)
+                {
+                    vector<char> out(room + 16, '!');
+                    size_t produced = 0;
+                    auto consumed = utf16ToUtf8Prefix(t.data(), t.size(), out.data(), room, produced);
+                    ASSERT_LE(consumed, t.size());
+                    ASSERT_LE(produced, room);
+
+                    vector<char> expected(3 * consumed + 1);
+                    auto r = toUtf8(t.data(), consumed, expected.data(), expected.size());
+                    EXPECT_EQ(kConvertOk, r.status) << "level " << level << ", length " << length;
+                    EXPECT_EQ(string(expected.data(), r.produced), string(out.data(), produced))
+                            << "level " << level << ", length " << length << ", room " << room;
+                    for (auto i = room; i < out.size(); ++i)
+                    {
+                        ASSERT_EQ('!', out[i]) << "level " << level << ", length " << length;
+                    }
+                    if ((!*half || half[1]) && room > 3 * t.size() && level != kSimdScalar)
+                    {
+                        EXPECT_GE(consumed + 32, t.size()) << "level " << level << ", length " << length;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdTest, testUcs4ToUtf8Prefix)
+{
+    SimdLevelGuard guard;
+
+    // beyond the BMP, up to six bytes, then what UTF-8 won't take
+    const char32_t* const others[] = { U"\U0001f600", U"\x7fffffff", U"\x4000000", U"",
+                                       U"\xd800", U"\xdfff", U"\x80000000" };
+    const char32_t* const* const firstRefused = others + 4;
+    mt19937 gen(20261017);
+    uniform_int_distribution<size_t> bmpPick(1, kBmpPieces - 1);
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t length = 0; length < 200; ++length)
+        {
+            string s;
+            while (s.size() < 2 * length)
+            {
+                s += pieces[bmpPick(gen)];
+            }
+            auto bmp = toUcs4(s);
+            for (auto other = others; other != others + 7; ++other)
+            {
+                ucs4String t(bmp);
+                uniform_int_distribution<size_t> at(0, t.size());
+                t.insert(at(gen), *other);
+
+                // room for all of it, for exactly all of it, and for less
+                uniform_int_distribution<size_t> someRoom(0, 3 * t.size());
+                size_t rooms[] = { 6 * t.size() + 16, requiredLength(t.data(), t.size(), kUtf8),
+                                   someRoom(gen) };
+                for (auto room : rooms)
+                {
+                    vector<char> out(room + 16, '!');
+                    size_t produced = 0;
+                    auto consumed = ucs4ToUtf8Prefix(t.data(), t.size(), out.data(), room, produced);
+                    ASSERT_LE(consumed, t.size());
+                    ASSERT_LE(produced, room);
+
+                    vector<char> expected(6 * consumed + 1);
+                    auto r = toUtf8(t.data(), consumed, expected.data(), expected.size());
+                    EXPECT_EQ(kConvertOk, r.status) << "level " << level << ", length " << length;
+                    EXPECT_EQ(string(expected.data(), r.produced), string(out.data(), produced))
+                            << "level " << level << ", length " << length << ", room " << room;
+                    for (auto i = room; i < out.size(); ++i)
+                    {
+                        ASSERT_EQ('!', out[i]) << "level " << level << ", length " << length;
+                    }
+                    if (other < firstRefused && room > 6 * t.size() && level != kSimdScalar)
+                    {
+                        EXPECT_GE(consumed + 32, t.size()) << "level " << level << ", length " << length;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdTest, testUtf16AndUcs4Prefixes)
+{
+    SimdLevelGuard guard;
+
+    // the pieces before the CESU-8 pair make well-formed text, pairs and all
+    const char16_t* const halves[] = { u"", u"\xd800", u"\xdbff", u"\xdc00", u"\xdfff" };
+    const char32_t* const others[] = { U"", U"\xd800", U"\xdfff", U"\x110000", U"\x7fffffff" };
+    mt19937 gen(20261017);
+    uniform_int_distribution<size_t> goodPick(1, kUnicodePieces - 1);
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t length = 0; length < 200; ++length)
+        {
+            string s;
+            while (s.size() < 2 * length)
+            {
+                s += pieces[goodPick(gen)];
+            }
+            auto wide16 = toUtf16(s);
+            auto wide32 = toUcs4(s);
+            ucs4String bmp32(wide32);
+            bmp32.erase(remove_if(bmp32.begin(), bmp32.end(), [](char32_t c) { return c > 0xffff; }),
+                        bmp32.end());
+
+            for (size_t k = 0; k < 5; ++k)
+            {
+                // UTF-16 to UCS-4 takes everything up to the first lone half
+                utf16String t(wide16);
+                uniform_int_distribution<size_t> at16(0, t.size());
+                t.insert(at16(gen), halves[k]);
+                vector<char32_t> out32(t.size() + 8, U'!');
+                size_t produced = 0;
+                auto consumed = utf16ToUcs4Prefix(t.data(), t.size(), out32.data(), produced);
+                vector<char32_t> expected32(t.size() + 1);
+                auto r = toUcs4(t.data(), t.size(), expected32.data(), expected32.size());
+                EXPECT_EQ(r.consumed, consumed) << "level " << level << ", length " << length << ", half " << k;
+                ASSERT_EQ(r.produced, produced) << "level " << level << ", length " << length << ", half " << k;
+                EXPECT_EQ(ucs4String(expected32.data(), produced), ucs4String(out32.data(), produced))
+                        << "level " << level << ", length " << length << ", half " << k;
+                for (auto i = t.size(); i < out32.size(); ++i)
+                {
+                    ASSERT_EQ(U'!', out32[i]) << "level " << level << ", length " << length;
+                }
+
+                // UCS-4 to UTF-16, with room for all of it, for exactly all of it, and for less
+                ucs4String c(wide32);
+                uniform_int_distribution<size_t> at32(0, c.size());
+                c.insert(at32(gen), others[k]);
+                vector<char16_t> whole(2 * c.size() + 1);
+                auto all = toUtf16(c.data(), c.size(), whole.data(), whole.size());
+                uniform_int_distribution<size_t> someRoom(0, 2 * c.size());
+                size_t rooms[] = { 2 * c.size() + 16, all.produced, someRoom(gen) };
+                for (auto room : rooms)
+                {
+                    vector<char16_t> out16(room + 16, u'!');
+                    consumed = ucs4ToUtf16Prefix(c.data(), c.size(), out16.data(), room, produced);
+                    ASSERT_LE(consumed, all.consumed);
+                    ASSERT_LE(produced, room);
+                    vector<char16_t> expected16(2 * consumed + 1);
+                    r = toUtf16(c.data(), consumed, expected16.data(), expected16.size());
+                    EXPECT_EQ(kConvertOk, r.status) << "level " << level << ", length " << length;
+                    EXPECT_EQ(utf16String(expected16.data(), r.produced), utf16String(out16.data(), produced))
+                            << "level " << level << ", length " << length << ", room " << room;
+                    for (auto i = room; i < out16.size(); ++i)
+                    {
+                        ASSERT_EQ(u'!', out16[i]) << "level " << level << ", length " << length;
+                    }
+                    if (room >= all.produced)
+                    {
+                        EXPECT_EQ(all.consumed, consumed) << "level " << level << ", length " << length;
+                    }
+                }
+
+                // and to UCS-2, which also stops beyond the BMP
+                ucs4String b(bmp32);
+                uniform_int_distribution<size_t> atBmp(0, b.size());
+                b.insert(atBmp(gen), k == 0 ? U"\x10000" : others[k]);
+                vector<char16_t> out2(b.size() + 8, u'!');
+                auto narrowed = ucs4ToUcs2Prefix(b.data(), b.size(), out2.data());
+                vector<char16_t> expected2(b.size() + 1);
+                r = toUcs2(b.data(), b.size(), expected2.data(), expected2.size());
+                EXPECT_EQ(r.consumed, narrowed) << "level " << level << ", length " << length << ", other " << k;
+                EXPECT_EQ(utf16String(expected2.data(), r.produced), utf16String(out2.data(), narrowed))
+                        << "level " << level << ", length " << length << ", other " << k;
+                for (auto i = b.size(); i < out2.size(); ++i)
+                {
+                    ASSERT_EQ(u'!', out2[i]) << "level " << level << ", length " << length;
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdTest, testCountingAndChecking)
+{
+    SimdLevelGuard guard;
+
+    const char16_t* const halves[] = { u"", u"\xd800", u"\xdbff", u"\xdc00", u"\xdfff" };
+    const char32_t lasts[] = { 0x7f, 0xffff, 0x10ffff, 0x7fffffff, 0xffffffff };
+    mt19937 gen(20261017);
+    uniform_int_distribution<int> anyLength(0, 700);
+    auto levels = availableLevels();
+
+    for (int i = 0; i < 300; ++i)
+    {
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)), kUnicodePieces);
+        auto wide16 = toUtf16(s);
+        uniform_int_distribution<size_t> at16(0, wide16.size());
+        wide16.insert(at16(gen), halves[i % 5]);
+        auto wide32 = toUcs4(s);
+        uniform_int_distribution<size_t> at32(0, wide32.size());
+        wide32.insert(at32(gen), 1, i % 2 ? static_cast<char32_t>(0xd800 + i) : static_cast<char32_t>(0x10000 << (i % 16)));
+        if (i % 3 == 0)
+        {
+            // a null, where the null-terminated forms must stop
+            wide16.insert(at16(gen), 1, u'\0');
+            wide32.insert(at32(gen), 1, U'\0');
+        }
+
+        // what each count and check must come to, a unit at a time
+        size_t leads8 = 0;
+        for (auto c : s)
+        {
+            leads8 += (static_cast<unsigned char>(c) & 0xc0) != 0x80;
+        }
+        size_t leads16 = 0;
+        for (auto c : wide16)
+        {
+            leads16 += (c & 0xfc00) != 0xdc00;
+        }
+        auto valid16 = validUtf16From(wide16.data(), 0, wide16.size(), 0);
+        auto validToNull16 = validUtf16From(wide16.data(), 0, wide16.size(), 1);
+
+        setSimdLevel(kSimdScalar);
+        auto length8 = unicodeLength(s.data(), s.size(), kUnicode);
+        auto length16 = unicodeLength(wide16.data(), wide16.size(), kUnicode);
+        auto length32 = unicodeLength(wide32.data(), wide32.size(), kUtf16);
+
+        for (auto level : levels)
+        {
+            setSimdLevel(level);
+            EXPECT_EQ(leads8, leadCount(s.data(), s.size())) << "level " << level << ", input " << i;
+            EXPECT_EQ(leads16, leadCount(wide16.data(), wide16.size())) << "level " << level << ", input " << i;
+            EXPECT_EQ(valid16, validUtf16Prefix(wide16.data(), wide16.size(), 0)) << "level " << level << ", input " << i;
+            EXPECT_EQ(validToNull16, validUtf16Prefix(wide16.data(), wide16.size(), 1))
+                    << "level " << level << ", input " << i;
+            for (auto last : lasts)
+            {
+                for (char32_t lowest = 0; lowest < 2; ++lowest)
+                {
+                    EXPECT_EQ(inRangeUcs4From(wide32.data(), 0, wide32.size(), lowest, last),
+                              inRangeUcs4Prefix(wide32.data(), wide32.size(), lowest, last))
+                            << "level " << level << ", last " << last << ", lowest " << lowest << ", input " << i;
+                }
+            }
+            EXPECT_EQ(length8, unicodeLength(s.data(), s.size(), kUnicode)) << "level " << level << ", input " << i;
+            EXPECT_EQ(length16, unicodeLength(wide16.data(), wide16.size(), kUnicode))
+                    << "level " << level << ", input " << i;
+            EXPECT_EQ(length32, unicodeLength(wide32.data(), wide32.size(), kUtf16))
+                    << "level " << level << ", input " << i;
+        }
+    }
+}
+
+TEST(SimdTest, testLossyConvertersAgreeWithScalar)
+{
+    SimdLevelGuard guard;
+
+    mt19937 gen(20261017);
+    uniform_int_distribution<int> anyLength(0, 700);
+    auto levels = availableLevels();
+    size_t goodPieceCounts[] = { kAsciiPieces, kTwoBytePieces, kBmpPieces, kUnicodePieces };
+
+    for (int i = 0; i < 300; ++i)
+    {
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)),
+                                goodPieceCounts[i % 4]);
+
+        setSimdLevel(kSimdScalar);
+        auto utf16 = toUtf16(s, kConvertReplace);
+        auto ucs2 = toUcs2(s, kConvertSkip);
+        auto ucs4 = toUcs4(s, kConvertReplace);
+
+        // and back, with a lone half somewhere
+        utf16String loneHalf(utf16);
+        loneHalf.insert(loneHalf.size() / 3, 1, static_cast<char16_t>(0xd800 + i));
+        auto narrow = toUtf8(utf16);
+        auto narrowReplaced = toUtf8(loneHalf, kConvertReplace);
+        EXPECT_TRUE(toUtf8(loneHalf).empty());
+        ucs4String outOfRange(ucs4);
+        outOfRange.insert(outOfRange.size() / 2, 1, static_cast<char32_t>(0x80000000u + i));
+        auto wideNarrow = toUtf8(ucs4);
+        auto wideReplaced = toUtf8(outOfRange, kConvertReplace);
+        EXPECT_TRUE(toUtf8(outOfRange).empty());
+        auto widened = toUcs4(utf16);
+        auto widenedReplaced = toUcs4(loneHalf, kConvertReplace);
+        auto split = toUtf16(ucs4);
+        auto splitReplaced = toUtf16(outOfRange, kConvertReplace);
+        auto bmpOnly = toUcs2(ucs4, kConvertSkip);
+        EXPECT_TRUE(toUtf16(outOfRange).empty());
+
+        for (auto level : levels)
+        {
+            setSimdLevel(level);
+            EXPECT_EQ(utf16, toUtf16(s, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(ucs2, toUcs2(s, kConvertSkip)) << "level " << level << ", input " << i;
+            EXPECT_EQ(ucs4, toUcs4(s, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(narrow, toUtf8(utf16)) << "level " << level << ", input " << i;
+            EXPECT_EQ(narrowReplaced, toUtf8(loneHalf, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(wideNarrow, toUtf8(ucs4)) << "level " << level << ", input " << i;
+            EXPECT_EQ(wideReplaced, toUtf8(outOfRange, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(widened, toUcs4(utf16)) << "level " << level << ", input " << i;
+            EXPECT_EQ(widenedReplaced, toUcs4(loneHalf, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(split, toUtf16(ucs4)) << "level " << level << ", input " << i;
+            EXPECT_EQ(splitReplaced, toUtf16(outOfRange, kConvertReplace)) << "level " << level << ", input " << i;
+            EXPECT_EQ(bmpOnly, toUcs2(ucs4, kConvertSkip)) << "level " << level << ", input " << i;
+        }
+    }
+}
+
+TEST(SimdTest, testExactLengths)
+{
+    SimdLevelGuard guard;
+
+    mt19937 gen(20261018);
+    // long enough to cross where the kernels empty their lane counters
+    uniform_int_distribution<size_t> anyLength(1, 20000);
+    // every piece up to and including the CESU-8 pair is valid
+    uniform_int_distribution<size_t> validPick(0, kCesuPieces - 1);
+    auto levels = availableLevels();
+
+    for (int i = 0; i < 60; ++i)
+    {
+        string s;
+        for (auto length = anyLength(gen); s.size() < length; )
+        {
+            s += pieces[validPick(gen)];
+        }
+        auto ucs4 = toUcs4(s);
+        auto utf16 = toUtf16(s);
+        auto fromUtf16 = toUtf8(utf16);
+        auto fromUcs4 = toUtf8(ucs4);
+        ASSERT_FALSE(s.empty() || ucs4.empty() || utf16.empty());
+
+        for (auto level : levels)
+        {
+            setSimdLevel(level);
+            EXPECT_EQ(utf16.size(), utf16Length(s.data(), s.size())) << "level " << level << ", input " << i;
+            EXPECT_EQ(ucs4.size(), ucs4Length(s.data(), s.size())) << "level " << level << ", input " << i;
+            EXPECT_EQ(fromUtf16.size(), utf8Length(utf16.data(), utf16.size())) << "level " << level;
+            EXPECT_EQ(ucs4.size(), ucs4Length(utf16.data(), utf16.size())) << "level " << level;
+            EXPECT_EQ(fromUcs4.size(), utf8Length(ucs4.data(), ucs4.size())) << "level " << level;
+            EXPECT_EQ(utf16.size(), utf16Length(ucs4.data(), ucs4.size())) << "level " << level;
+        }
+    }
+
+    // every UTF-8 length, from both wider forms
+    const char32_t wide[] = { 0x41, 0x7ff, 0xffff, 0x10ffff, 0x1fffff, 0x3ffffff, 0x7fffffff };
+    for (auto level : levels)
+    {
+        setSimdLevel(level);
+        ucs4String all;
+        ucs4String unicode;
+        for (int copies = 0; copies < 9; ++copies)
+        {
+            all.append(wide, wide + 7);
+            // the last three are past U+10FFFF, with no UTF-16 form
+            unicode.append(wide, wide + 4);
+        }
+        EXPECT_EQ(toUtf8(all).size(), utf8Length(all.data(), all.size())) << "level " << level;
+        EXPECT_EQ(toUtf16(unicode).size(), utf16Length(unicode.data(), unicode.size())) << "level " << level;
+    }
+}
+
+TEST(SimdTest, testLowerAsciiPrefix)
+{
+    SimdLevelGuard guard;
+
+    // every 7-bit value, so both ends of 'A'..'Z' fall inside every block
+    string s(300, 'a');
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        s[i] = static_cast<char>(i % 0x80);
+    }
+    auto lowered = [](char32_t c) { return c >= 'A' && c <= 'Z' ? c + 0x20 : c; };
+    // stoppers whose low bits look like letters or like 7-bit values
+    const char stop8[] = { '\x80', '\xc1', '\xda', '\xff' };
+    const char16_t stop16[] = { 0x80, 0xc1, 0x141, 0xff5a };
+    const char32_t stop32[] = { 0x80, 0x141, 0x10041, 0x8000005a };
+
+    for (auto level : availableLevels())
+    {
+        setSimdLevel(level);
+        for (size_t at = 0; at < 200; ++at)
+        {
+            string t8(s);
+            utf16String t16(s.begin(), s.end());
+            ucs4String t32(s.begin(), s.end());
+            t8[at] = stop8[at % 4];
+            t16[at] = stop16[at % 4];
+            t32[at] = stop32[at % 4];
+
+            string out8(t8.size(), '!');
+            utf16String out16(t16.size(), u'!');
+            ucs4String out32(t32.size(), U'!');
+            ASSERT_EQ(at, lowerAsciiPrefix(t8.data(), t8.size(), &out8[0])) << "level " << level;
+            ASSERT_EQ(at, lowerAsciiPrefix(t16.data(), t16.size(), &out16[0])) << "level " << level;
+            ASSERT_EQ(at, lowerAsciiPrefix(t32.data(), t32.size(), &out32[0])) << "level " << level;
+            for (size_t i = 0; i < at; ++i)
+            {
+                ASSERT_EQ(lowered(s[i]), static_cast<char32_t>(out8[i])) << "level " << level;
+                ASSERT_EQ(lowered(s[i]), static_cast<char32_t>(out16[i])) << "level " << level;
+                ASSERT_EQ(lowered(s[i]), out32[i]) << "level " << level;
+            }
+
+            // stopping short of the non-ASCII unit, and writing nothing past n
+            string short8(at + 1, '!');
+            EXPECT_EQ(at / 2, lowerAsciiPrefix(t8.data(), at / 2, &short8[0])) << "level " << level;
+            EXPECT_EQ(string(at + 1 - at / 2, '!'), short8.substr(at / 2)) << "level " << level;
+        }
+    }
+}
+
+TEST(SimdTest, testToLowerAgreesWithScalar)
+{
+    SimdLevelGuard guard;
+
+    mt19937 gen(20261019);
+    uniform_int_distribution<int> anyLength(0, 700);
+    auto levels = availableLevels();
+
+    for (int i = 0; i < 200; ++i)
+    {
+        // the valid pieces, with capitals and an 'I' for the Turkic path
+        auto s = makeTestString(gen, static_cast<size_t>(anyLength(gen)), kUnicodePieces);
+        for (size_t j = 0; j < s.size(); j += 7)
+        {
+            if (s[j] >= 'a' && s[j] <= 'z')
+            {
+                s[j] = static_cast<char>(s[j] - 0x20);
+            }
+        }
+        auto utf16 = toUtf16(s);
+        auto ucs4 = toUcs4(s);
+
+        setSimdLevel(kSimdScalar);
+        auto lower8 = toLower(s);
+        auto lower16 = toLower(utf16);
+        auto lower32 = toLower(ucs4);
+        auto turkic8 = toLower(s, "tr");
+        EXPECT_EQ(lower8, toUtf8(lower32)) << "input " << i;
+        EXPECT_EQ(lower16, toUtf16(lower32)) << "input " << i;
+
+        for (auto level : levels)
+        {
+            setSimdLevel(level);
+            EXPECT_EQ(lower8, toLower(s)) << "level " << level << ", input " << i;
+            EXPECT_EQ(lower16, toLower(utf16)) << "level " << level << ", input " << i;
+            EXPECT_EQ(lower32, toLower(ucs4)) << "level " << level << ", input " << i;
+            EXPECT_EQ(turkic8, toLower(s, "tr")) << "level " << level << ", input " << i;
+        }
+    }
+}
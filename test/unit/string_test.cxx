@@ -1028,6 +1028,19 @@ TEST(StringTest, testToUtf8From16Bit)
     char16_t utf16Bad[] = { 'H', 'e', 'l', 'l', 'o', '!', ' ', 0xd800, ' ', 0 };
     string utf16BadUtf8(toUtf8(utf16Bad));
     EXPECT_TRUE(utf16BadUtf8.empty());
+    // ... and a second half without a first (bad too), wherever it is
+    char16_t utf16LoneSecond[] = { 0xdc00, 0 };
+    EXPECT_TRUE(toUtf8(utf16LoneSecond).empty());
+    char16_t utf16BadSecond[] = { 'H', 'e', 'l', 'l', 'o', '!', ' ', 0xdc00, ' ', 0 };
+    EXPECT_TRUE(toUtf8(utf16BadSecond).empty());
+    EXPECT_TRUE(toUtf8(utf16String(utf16BadSecond)).empty());
+    EXPECT_TRUE(toUtf8(utf16BadSecond, 9).empty());
+    string appended("x");
+    EXPECT_FALSE(appendUtf8(appended, utf16BadSecond, 9));
+    EXPECT_EQ(string("x"), appended);
+    // ... unless the policy says otherwise
+    EXPECT_EQ(string("Hello! \xef\xbf\xbd "), toUtf8(utf16BadSecond, 9, kConvertReplace));
+    EXPECT_EQ(string("Hello!  "), toUtf8(utf16BadSecond, 9, kConvertSkip));
 }
 
 TEST(StringTest, testToUtf8From32Bit)
@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_test_text.hxx -- the grab-bag of pieces, good and bad, that the
+//                         validator, SIMD, parallel and batch tests build
+//                         their random text from, and the generator that
+//                         strings them together.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "string.hxx"
+
+#include <random>
+#include <string>
+
+namespace ansak
+{
+
+namespace test
+{
+
+//=========================================================================
+// Pieces of UTF-8, grouped by kind: each k...Pieces below counts the pieces
+// from the start of the table up to the end of one group, so that a test can
+// draw from "the first kBmpPieces" and know what it gets. Everything before
+// kUnicodePieces is well-formed; the long sentence is first, so that drawing
+// from 1 leaves it out.
+
+const char* const pieces[] = {
+    "Now is the time for all good men to come to the aid of the party. ",
+    "a", "Z", "I", "Key", " ", "0123456789",                    // ASCII
+    "\xc3\xa4", "\xc3\x84", "\xd0\x96", "\xdf\xbf", "\xc4\xb0", // 2-byte
+    "\xe4\xab\x88", "\xe2\x82\xac", "\xef\xbf\xbd", "\xe0\xa0\x80",
+    "\xee\x80\x80",                                             // 3-byte, one private
+    "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf", "\xf2\x81\x82\x83", // 4-byte
+    "\xed\xa8\xb2\xed\xb8\xb2",                                 // CESU-8 pair
+    "\xf4\x90\x80\x80",                                         // past U+10FFFF
+    "\xf9\x84\x85\x86\x87", "\xfd\xa1\xa2\xa3\xa4\xa5",         // 5-, 6-byte
+    "\xed\xa0\x80", "\xed\xb0\x80",                             // lone surrogates
+    "\xed\xa8\xb2" "a",                                         // first half, then not
+    "\xc0\x80", "\xe0\x80\x80", "\xf0\x80\x80\x80",             // overlong
+    "\x80", "\xbf", "\xfe", "\xff",                             // never first
+    "\xc3", "\xe4\xab", "\xf0\x9f\x98"                          // cut short
+};
+const size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+
+const size_t kAsciiPieces = 7;
+const size_t kTwoBytePieces = 12;       // ASCII and 2-byte
+const size_t kBmpPieces = 17;           // ... and 3-byte
+const size_t kUnicodePieces = 20;       // ... and 4-byte
+const size_t kCesuPieces = 21;          // ... and the CESU-8 pair
+const size_t kUcs4Pieces = 24;          // ... and past U+10FFFF, 5- and 6-byte
+
+//=========================================================================
+// The same idea in UTF-16, the lone halves last
+
+const char16_t* const pieces16[] = {
+    u"Pieces ", u"a", u"\x00e4", u"\x4ac8", u"\xe000",
+    u"\xd83d\xde00", u"\xdbff\xdfff",                           // pairs
+    u"\xd800", u"\xdc00", u"\xd800" u"a"                        // lone halves
+};
+const size_t pieceCount16 = sizeof(pieces16) / sizeof(pieces16[0]);
+
+const size_t kUnicodePieces16 = 7;
+
+const RangeType allRanges[] = { kAscii, kUtf8, kUcs2, kUtf16, kUcs4, kUnicode };
+
+//=========================================================================
+// At least targetLength units of pieces drawn from the first goodPieces of
+// from, with one drawn from all fromCount about once in every rareness + 1
+// pieces -- and, if withNuls, a NUL about as often
+
+template <typename C>
+std::basic_string<C> makeTestString
+(
+    std::mt19937&       gen,            // I - the random source
+    size_t              targetLength,   // I - how long at least
+    const C* const*     from,           // I - the pieces to draw from
+    size_t              fromCount,      // I - how many of them
+    size_t              goodPieces,     // I - how many of them to draw from usually
+    int                 rareness,       // I - how seldom to draw from all of them
+    bool                withNuls = false // I - whether to put NULs in too
+)
+{
+    std::uniform_int_distribution<size_t> goodPick(0, goodPieces - 1);
+    std::uniform_int_distribution<size_t> anyPick(0, fromCount - 1);
+    std::uniform_int_distribution<int> rarely(0, rareness);
+
+    std::basic_string<C> r;
+    while (r.size() < targetLength)
+    {
+        r += from[rarely(gen) == 0 ? anyPick(gen) : goodPick(gen)];
+        if (withNuls && rarely(gen) == 0)
+        {
+            r += C(0);
+        }
+    }
+    return r;
+}
+
+//=========================================================================
+// The same from pieces, by default mostly those up to the 6-byte forms
+
+inline std::string makeTestString
+(
+    std::mt19937&       gen,            // I - the random source
+    size_t              targetLength,   // I - how long at least
+    size_t              goodPieces = kUcs4Pieces, // I - how many pieces to draw from usually
+    int                 rareness = 60   // I - how seldom to draw from all of them
+)
+{
+    return makeTestString(gen, targetLength, pieces, pieceCount, goodPieces, rareness);
+}
+
+}
+
+}
@@ -1609,11 +1609,14 @@ TEST(StringToLowerTest, testPageAToFUnshiftables)
                               u"\ua700\ua70c\ua712\ua718\ua71e\ua721\ua730\ua731"
                               u"\ua770\ua771\ua772\ua773\ua774\ua775\ua776\ua777\ua778"
                               u"\ua788\ua789\ua78a\ua78e\ua78f\ua794\ua795\ua7af"
-                              u"\ua7b8\ua7b9"
+                              u"\ua7b9"
                               u"\uabc0\uabd0\uabe0\uabf0"
                               u"\uff00\uff04\uff08\uff0c\uff10\uff18\uff1c\uff1f\uff20"
                               u"\uff3b\uff3c\uff3d\uff3e\uff3f\uff40\uff5b\uff5c\uff5d\uff5e\uff5f\uff60");
     EXPECT_EQ(dontTouchPAtoF, toLower(dontTouchPAtoF));
+
+    // U+A7B8 LATIN CAPITAL LETTER U WITH STROKE arrived in Unicode 11 with a lower case
+    EXPECT_EQ(ucs2String(u"\ua7b9"), toLower(ucs2String(u"\ua7b8")));
 }
 
 TEST(StringToLowerTest, testPlane1Unshiftables)
@@ -1630,3 +1633,22 @@ TEST(StringToLowerTest, testCoverageGaps)
     ucs2String dontTouch1fNonUnicodes(u"\u1f1e\u1f1f\u1f4e\u1f4f\u1f58\u1f5a\u1f5c\u1f5e");
     EXPECT_EQ(dontTouch1fNonUnicodes, toLower(dontTouch1fNonUnicodes));
 }
+
+TEST(StringToLowerTest, testUnicodeDataMappings)
+{
+    // the simple lower-case mappings come straight from UnicodeData.txt: the
+    // multiplication sign sits among the Latin-1 capitals but isn't one, and
+    // U+1E96..U+1E9D are all small letters already
+    ucs4String noLowerCase(U"\U000000D7\U00001E96\U00001E98\U00001E9A\U00001E9C");
+    EXPECT_EQ(noLowerCase, toLower(noLowerCase));
+
+    // Georgian Mtavruli and Medefaidrin arrived in Unicode 11
+    ucs4String upperCase(U"\U00001C90\U00001CBA\U00001CBD\U00001CBF\U00016E40\U00016E5F");
+    ucs4String lowerCase(U"\U000010D0\U000010FA\U000010FD\U000010FF\U00016E60\U00016E7F");
+    EXPECT_EQ(lowerCase, toLower(upperCase));
+
+    // Vithkuqi arrived in Unicode 14, with gaps where there is nothing to lower-case
+    ucs4String vithkuqiUpper(U"\U00010570\U0001057A\U0001057B\U0001057C\U0001058B\U00010593\U00010595");
+    ucs4String vithkuqiLower(U"\U00010597\U000105A1\U0001057B\U000105A3\U0001058B\U00010593\U000105BC");
+    EXPECT_EQ(vithkuqiLower, toLower(vithkuqiUpper));
+}
@@ -1274,23 +1274,25 @@ TEST(StringToLowerTest, testThirtyTwoBitToLowers)
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
+    // Old Hungarian (U+10C80..U+10CF2) only arrives in Unicode 8; here it is
+    // unassigned and has no lower case
     {   // 2.01 - x
         ucs4String upperCase(U"\U00010422\U00010423\U00010424\U00010425\U00010426\U00010427\U00010C80\U00010C81\U00010C82");
-        ucs4String lowerCase(U"\U0001044A\U0001044B\U0001044C\U0001044D\U0001044E\U0001044F\U00010CC0\U00010CC1\U00010CC2");
+        ucs4String lowerCase(U"\U0001044A\U0001044B\U0001044C\U0001044D\U0001044E\U0001044F\U00010C80\U00010C81\U00010C82");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
     {   // 2.02 - x
         ucs4String upperCase(U"\U00010C83\U00010C84\U00010C85\U00010C86\U00010C87\U00010C88\U00010C89\U00010C8A\U00010C8B");
-        ucs4String lowerCase(U"\U00010CC3\U00010CC4\U00010CC5\U00010CC6\U00010CC7\U00010CC8\U00010CC9\U00010CCA\U00010CCB");
+        ucs4String lowerCase(U"\U00010C83\U00010C84\U00010C85\U00010C86\U00010C87\U00010C88\U00010C89\U00010C8A\U00010C8B");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
     {   // 2.03 - x
         ucs4String upperCase(U"\U00010C8C\U00010C8D\U00010C8E\U00010C8F\U00010C90\U00010C91\U00010C92\U00010C93\U00010C94");
-        ucs4String lowerCase(U"\U00010CCC\U00010CCD\U00010CCE\U00010CCF\U00010CD0\U00010CD1\U00010CD2\U00010CD3\U00010CD4");
+        ucs4String lowerCase(U"\U00010C8C\U00010C8D\U00010C8E\U00010C8F\U00010C90\U00010C91\U00010C92\U00010C93\U00010C94");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
@@ -1299,28 +1301,28 @@ TEST(StringToLowerTest, testThirtyTwoBitToLowers)
     ////////////////////////////////////////////////////////////
     {   // 2.04 - x
         ucs4String upperCase(U"\U00010C95\U00010C96\U00010C97\U00010C98\U00010C99\U00010C9A\U00010C9B\U00010C9C\U00010C9D");
-        ucs4String lowerCase(U"\U00010CD5\U00010CD6\U00010CD7\U00010CD8\U00010CD9\U00010CDA\U00010CDB\U00010CDC\U00010CDD");
+        ucs4String lowerCase(U"\U00010C95\U00010C96\U00010C97\U00010C98\U00010C99\U00010C9A\U00010C9B\U00010C9C\U00010C9D");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
     {   // 2.05 - x
         ucs4String upperCase(U"\U00010C9E\U00010C9F\U00010CA0\U00010CA1\U00010CA2\U00010CA3\U00010CA4\U00010CA5\U00010CA6");
-        ucs4String lowerCase(U"\U00010CDE\U00010CDF\U00010CE0\U00010CE1\U00010CE2\U00010CE3\U00010CE4\U00010CE5\U00010CE6");
+        ucs4String lowerCase(U"\U00010C9E\U00010C9F\U00010CA0\U00010CA1\U00010CA2\U00010CA3\U00010CA4\U00010CA5\U00010CA6");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
     {   // 2.06 - x
         ucs4String upperCase(U"\U00010CA7\U00010CA8\U00010CA9\U00010CAA\U00010CAB\U00010CAC\U00010CAD\U00010CAE\U00010CAF");
-        ucs4String lowerCase(U"\U00010CE7\U00010CE8\U00010CE9\U00010CEA\U00010CEB\U00010CEC\U00010CED\U00010CEE\U00010CEF");
+        ucs4String lowerCase(U"\U00010CA7\U00010CA8\U00010CA9\U00010CAA\U00010CAB\U00010CAC\U00010CAD\U00010CAE\U00010CAF");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
     }
     {   // 2.07 - x
         ucs4String upperCase(U"\U00010CB0\U00010CB1\U00010CB2\U000118A0\U000118A1\U000118A2\U000118A3\U000118A4\U000118A5");
-        ucs4String lowerCase(U"\U00010CF0\U00010CF1\U00010CF2\U000118C0\U000118C1\U000118C2\U000118C3\U000118C4\U000118C5");
+        ucs4String lowerCase(U"\U00010CB0\U00010CB1\U00010CB2\U000118C0\U000118C1\U000118C2\U000118C3\U000118C4\U000118C5");
         result |= lowerCase == toLower(upperCase) ? flag : 0;
         flag <<= 1;
         EXPECT_EQ(lowerCase, toLower(lowerCase));
@@ -1460,3 +1462,12 @@ TEST(StringToLowerTest, testCoverageGaps)
     ucs2String dontTouch1fNonUnicodes(u"\u1f1e\u1f1f\u1f4e\u1f4f\u1f58\u1f5a\u1f5c\u1f5e");
     EXPECT_EQ(dontTouch1fNonUnicodes, toLower(dontTouch1fNonUnicodes));
 }
+
+TEST(StringToLowerTest, testUnicodeDataMappings)
+{
+    // the simple lower-case mappings come straight from UnicodeData.txt: the
+    // multiplication sign sits among the Latin-1 capitals but isn't one, and
+    // U+1E96..U+1E9D are all small letters already
+    ucs4String noLowerCase(U"\U000000D7\U00001E96\U00001E98\U00001E9A\U00001E9C");
+    EXPECT_EQ(noLowerCase, toLower(noLowerCase));
+}
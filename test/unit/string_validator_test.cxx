@@ -0,0 +1,355 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2026, Arthur N. Klassen
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// 2026.10.17 - First version
+//
+//    May you do good and not evil.
+//    May you find forgiveness for yourself and forgive others.
+//    May you share freely, never taking more than you give.
+//
+///////////////////////////////////////////////////////////////////////////
+//
+// string_validator_test.cxx -- tests for Utf8Validator and validateXXX:
+//                              however a stream is cut into chunks, the
+//                              verdict is that of isUtf8 over the whole of
+//                              it, and a failure is found where it starts.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include "string.hxx"
+#include "string_simd.hxx"
+#include "string_test_text.hxx"
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ansak;
+using namespace ansak::internal;
+using namespace ansak::test;
+using namespace std;
+using namespace testing;
+
+namespace {
+
+//=========================================================================
+// What a validator fed all of s must conclude: isUtf8 over the whole, with
+// one more character (one every range and predicate used here takes) to
+// turn a sequence left cut short into a failure
+
+bool expectedVerdict(const string& s, RangeType range, const EncodingCheckPredicate& pred)
+{
+    auto extended = s + "x";
+    return isUtf8(extended.data(), extended.size(), range, pred);
+}
+
+//=========================================================================
+// Feed s in chunks of chunkLength bytes; the verdict from finish
+
+bool chunkedVerdict
+(
+    const string&       s,
+    size_t              chunkLength,
+    RangeType           range,
+    const EncodingCheckPredicate& pred
+)
+{
+    Utf8Validator v(range, pred);
+    for (size_t i = 0; i < s.size(); i += chunkLength)
+    {
+        v.feed(s.data() + i, min(chunkLength, s.size() - i));
+    }
+    return v.finish();
+}
+
+}
+
+TEST(Utf8ValidatorTest, testEmptyAndNull)
+{
+    Utf8Validator v;
+    EXPECT_TRUE(v.finish());
+    EXPECT_TRUE(v.feed(nullptr, 10));
+    EXPECT_TRUE(v.feed("abc", 0));
+    EXPECT_TRUE(v.finish());
+
+    Utf8Validator bad(kFirstInvalidRange);
+    EXPECT_FALSE(bad.feed("abc", 3));
+    EXPECT_FALSE(bad.finish());
+}
+
+TEST(Utf8ValidatorTest, testCutShortAtFinish)
+{
+    // isUtf8 lets a cut-short tail go, a finished stream does not
+    const char cut[] = "ok \xf0\x9f\x98";
+    EXPECT_TRUE(isUtf8(cut, sizeof(cut) - 1, kUtf8));
+
+    Utf8Validator v;
+    EXPECT_TRUE(v.feed(cut, sizeof(cut) - 1));
+    EXPECT_FALSE(v.finish());
+    EXPECT_TRUE(v.feed("\x80", 1));
+    EXPECT_TRUE(v.finish());
+
+    // a CESU-8 first half still wants its second
+    Utf8Validator w;
+    EXPECT_TRUE(w.feed("\xed\xa8\xb2", 3));
+    EXPECT_FALSE(w.finish());
+    EXPECT_TRUE(w.feed("\xed\xb8", 2));
+    EXPECT_FALSE(w.finish());
+    EXPECT_TRUE(w.feed("\xb2", 1));
+    EXPECT_TRUE(w.finish());
+}
+
+TEST(Utf8ValidatorTest, testFailureSticksUntilReset)
+{
+    Utf8Validator v;
+    EXPECT_TRUE(v.feed("abc\xe4", 4));
+    EXPECT_FALSE(v.feed("\xab" "d", 2));
+    EXPECT_FALSE(v.feed("fine", 4));
+    EXPECT_FALSE(v.finish());
+
+    v.reset();
+    EXPECT_TRUE(v.feed("fine", 4));
+    EXPECT_TRUE(v.finish());
+}
+
+TEST(Utf8ValidatorTest, testRangeAndPredicateAcrossChunks)
+{
+    // a 4-byte lead is outside UCS-2 before the rest of it arrives
+    Utf8Validator ucs2(kUcs2);
+    EXPECT_TRUE(ucs2.feed("ab", 2));
+    EXPECT_FALSE(ucs2.feed("\xf0\x9f", 2));
+
+    // a CESU-8 pair only once its second half is in, wherever it was cut
+    const char pair[] = "\xed\xa8\xb2\xed\xb8\xb2";
+    for (size_t i = 1; i < 6; ++i)
+    {
+        Utf8Validator v(kUcs2);
+        v.feed(pair, i);
+        v.feed(pair + i, 6 - i);
+        EXPECT_FALSE(v.finish());
+
+        Utf8Validator w(kUnicode);
+        w.feed(pair, i);
+        w.feed(pair + i, 6 - i);
+        EXPECT_TRUE(w.finish());
+    }
+
+    // a private-use character is judged by the predicate once it is whole
+    Utf8Validator noPrivate(kUnicode, validIfNot(kIsPrivate));
+    EXPECT_TRUE(noPrivate.feed("a\xee", 2));
+    EXPECT_TRUE(noPrivate.feed("\x80", 1));
+    EXPECT_FALSE(noPrivate.feed("\x80", 1));
+}
+
+TEST(Utf8ValidatorTest, testEveryTwoWaySplit)
+{
+    vector<string> samples;
+    for (size_t i = 0; i < pieceCount; ++i)
+    {
+        for (size_t j = 0; j < pieceCount; ++j)
+        {
+            samples.push_back(string("<") + pieces[i] + pieces[j] + ">");
+        }
+    }
+
+    const EncodingCheckPredicate preds[] = { EncodingCheckPredicate(), validIfNot(kIsPrivate) };
+    for (auto& s : samples)
+    {
+        for (auto range : allRanges)
+        {
+            for (auto& pred : preds)
+            {
+                auto expected = expectedVerdict(s, range, pred);
+                for (size_t i = 0; i <= s.size(); ++i)
+                {
+                    Utf8Validator v(range, pred);
+                    v.feed(s.data(), i);
+                    v.feed(s.data() + i, s.size() - i);
+                    EXPECT_EQ(expected, v.finish()) << "range " << range << " split at " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(Utf8ValidatorTest, testChunkedAtEveryLevel)
+{
+    vector<SimdLevel> levels;
+    levels.push_back(kSimdScalar);
+    levels.push_back(detectedSimdLevel());
+
+    mt19937 gen(20261017);
+    vector<string> samples;
+    for (int i = 0; i < 40; ++i)
+    {
+        samples.push_back(makeTestString(gen, 3000));
+    }
+
+    const size_t chunkLengths[] = { 1, 2, 3, 5, 7, 16, 63, 64, 1000 };
+    for (auto level : levels)
+    {
+        setSimdLevel(level);
+        for (auto& s : samples)
+        {
+            for (auto range : allRanges)
+            {
+                auto expected = expectedVerdict(s, range, EncodingCheckPredicate());
+                for (auto chunkLength : chunkLengths)
+                {
+                    EXPECT_EQ(expected, chunkedVerdict(s, chunkLength, range, EncodingCheckPredicate()))
+                        << "level " << level << " range " << range << " chunks of " << chunkLength;
+                }
+            }
+            auto pred = validIfNot(kIsPrivate);
+            EXPECT_EQ(expectedVerdict(s, kUnicode, pred), chunkedVerdict(s, 7, kUnicode, pred));
+        }
+    }
+    setSimdLevel(detectedSimdLevel());
+}
+
+TEST(Utf8ValidatorTest, testValidateUtf8Errors)
+{
+    struct { const char* text; size_t offset; ValidationError error; } cases[] = {
+        { "abc",                                3,  kValidationOk },
+        { "ab\x80",                             2,  kValidationMalformed },
+        { "ab\xfe",                             2,  kValidationMalformed },
+        { "a\xc3z",                             1,  kValidationMalformed },
+        { "a\xe4\xab" "b",                       1,  kValidationMalformed },
+        { "ab\xc0\x80",                         2,  kValidationOverlong },
+        { "ab\xc1\xbf",                         2,  kValidationOverlong },
+        { "\xe0\x80\x80",                        0,  kValidationOverlong },
+        { "a\xf0\x8f\xbf\xbf",                   1,  kValidationOverlong },
+        { "ab\xed\xb0\x80",                     2,  kValidationSurrogate },
+        { "ab\xed\xa0\x80" "c",                  2,  kValidationSurrogate },
+        { "ab\xed\xa0\x80",                     2,  kValidationTruncated },
+        { "\xc3\xa4\xf0\x9f\x98",               2,  kValidationTruncated },
+        { "\xed\xa8\xb2\xed\xb8\xb2",            6,  kValidationOk },
+    };
+    for (auto& t : cases)
+    {
+        auto r = validateUtf8(t.text, strlen(t.text));
+        EXPECT_EQ(t.error == kValidationOk, r.valid) << t.text;
+        EXPECT_EQ(t.offset, r.offset) << t.text;
+        EXPECT_EQ(t.error, r.error) << t.text;
+    }
+
+    auto r = validateUtf8(string("ab\xf0\x9f\x98\x80"), kUcs2);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUtf8(string("ab\xe4\xab\x88"), kAscii);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUtf8(string("ab\xf4\x90\x80\x80"), kUnicode);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUtf8(string("abc\xee\x80\x80"), kUtf8, validIfNot(kIsPrivate));
+    EXPECT_EQ(kValidationPredicate, r.error);
+    EXPECT_EQ(3u, r.offset);
+    r = validateUtf8(string("abc"), kFirstInvalidRange);
+    EXPECT_FALSE(r.valid);
+}
+
+TEST(Utf8ValidatorTest, testValidateWideErrors)
+{
+    const char16_t loneSecond[] = u"ab\xdc00";
+    auto r = validateUtf16(loneSecond, 3);
+    EXPECT_EQ(kValidationSurrogate, r.error);
+    EXPECT_EQ(2u, r.offset);
+    const char16_t firstThenNot[] = u"ab\xd800z";
+    r = validateUtf16(firstThenNot, 4);
+    EXPECT_EQ(kValidationSurrogate, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUtf16(firstThenNot, 3);
+    EXPECT_EQ(kValidationTruncated, r.error);
+    EXPECT_EQ(2u, r.offset);
+    EXPECT_TRUE(isUtf16(firstThenNot, 3, kUtf16));
+    const char16_t pair[] = u"ab\U0001f600c";
+    r = validateUtf16(pair, 5, kUcs2);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUtf16(utf16String(pair), kUtf16);
+    EXPECT_TRUE(r.valid);
+    EXPECT_EQ(5u, r.offset);
+    r = validateUtf16(u"a\xe000", 2, kUtf16, validIfNot(kIsPrivate));
+    EXPECT_EQ(kValidationPredicate, r.error);
+    EXPECT_EQ(1u, r.offset);
+
+    r = validateUcs2(pair, 5);
+    EXPECT_EQ(kValidationSurrogate, r.error);
+    EXPECT_EQ(2u, r.offset);
+    r = validateUcs2(u"ab\xe4", 3, kAscii);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+
+    const char32_t wide[] = U"ab\x110000";
+    r = validateUcs4(wide, 3, kUnicode);
+    EXPECT_EQ(kValidationOutOfRange, r.error);
+    EXPECT_EQ(2u, r.offset);
+    EXPECT_TRUE(validateUcs4(wide, 3).valid);
+    r = validateUcs4(U"a\xd800", 2, kUtf16);
+    EXPECT_EQ(kValidationSurrogate, r.error);
+    EXPECT_EQ(1u, r.offset);
+}
+
+TEST(Utf8ValidatorTest, testErrorsFoundWhereverChunksEnd)
+{
+    mt19937 gen(17);
+    for (int i = 0; i < 200; ++i)
+    {
+        auto s = makeTestString(gen, 300);
+        for (auto range : allRanges)
+        {
+            auto whole = validateUtf8(s, range);
+            auto viaIs = isUtf8(s.data(), s.size(), range);
+            EXPECT_EQ(viaIs, whole.valid || whole.error == kValidationTruncated);
+            EXPECT_EQ(expectedVerdict(s, range, EncodingCheckPredicate()), whole.valid);
+            if (!whole.valid)
+            {
+                // everything before the error is fine
+                EXPECT_TRUE(validateUtf8(s.data(), whole.offset, range).valid);
+            }
+
+            const size_t chunkLengths[] = { 1, 3, 7, 64 };
+            for (auto chunkLength : chunkLengths)
+            {
+                Utf8Validator v(range);
+                for (size_t j = 0; j < s.size(); j += chunkLength)
+                {
+                    v.feed(s.data() + j, min(chunkLength, s.size() - j));
+                }
+                auto chunked = v.result();
+                EXPECT_EQ(whole.valid, chunked.valid);
+                EXPECT_EQ(whole.offset, chunked.offset) << "chunks of " << chunkLength;
+                EXPECT_EQ(whole.error, chunked.error) << "chunks of " << chunkLength;
+            }
+        }
+    }
+}